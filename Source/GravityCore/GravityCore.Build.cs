@@ -0,0 +1,18 @@
+using UnrealBuildTool;
+
+public class GravityCore : ModuleRules
+{
+	public GravityCore(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		// Engine independent on purpose: no UObjects, so the kernels can be benchmarked without a world
+		PublicDependencyModuleNames.AddRange(new string[] {
+			"Core"
+		});
+
+		PrivateDependencyModuleNames.AddRange(new string[] {
+			"Json"
+		});
+	}
+}
@@ -0,0 +1,121 @@
+#include "GravityKernelBenchmark.h"
+
+namespace
+{
+    /** Runs Body the given number of times and returns the median duration in ms. */
+    template <typename BodyType>
+    double TimeMedianMs(int32 Iterations, BodyType&& Body)
+    {
+        TArray<double, TInlineAllocator<64>> Times;
+
+        for (int32 Iteration = 0; Iteration < FMath::Max(Iterations, 1); ++Iteration)
+        {
+            const uint64 StartCycle = FPlatformTime::Cycles64();
+            Body();
+            Times.Add(FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycle));
+        }
+
+        Times.Sort();
+        return Times[Times.Num() / 2];
+    }
+
+    float MaxDifference(const FGravityVectorArray& Accel, const FGravityVectorArray& Reference)
+    {
+        float MaxError = 0.f;
+        for (int32 Index = 0; Index < Reference.Num(); ++Index)
+        {
+            MaxError = FMath::Max(MaxError, FVector3f::Dist(Accel.Get(Index), Reference.Get(Index)));
+        }
+        return MaxError;
+    }
+}
+
+TArray<FGravityKernelBenchmarkResult> GravityCore::RunKernelBenchmarks(const FGravityKernelBenchmarkSettings& Settings)
+{
+    TArray<FGravityKernelBenchmarkResult> Results;
+
+    const float HalfArena = Settings.ArenaSize * 0.5f;
+    const FBox3f Bounds(FVector3f(-HalfArena, -HalfArena, 0.f), FVector3f(HalfArena, HalfArena, Settings.ArenaHeight));
+
+    for (const int32 NumWells : Settings.WellCounts)
+    {
+        for (const int32 NumBodies : Settings.BodyCounts)
+        {
+            // same seed for every size, so smaller scenes are prefixes of larger ones
+            FRandomStream Random(Settings.Seed);
+
+            TArray<FGravityWell> Wells;
+            for (int32 Index = 0; Index < NumWells; ++Index)
+            {
+                FGravityWell& Well = Wells.AddDefaulted_GetRef();
+                Well.Location = FVector(Random.FRandRange(Bounds.Min.X, Bounds.Max.X), Random.FRandRange(Bounds.Min.Y, Bounds.Max.Y), Random.FRandRange(Bounds.Min.Z, Bounds.Max.Z));
+                Well.MaxRadius = Random.FRandRange(1000.f, 3000.f);
+                Well.Falloff = Settings.Falloff;
+
+                // one in four is a white hole
+                if (Random.RandHelper(4) == 0)
+                {
+                    Well.Strength = -Well.Strength;
+                }
+            }
+
+            FGravityVectorArray Positions;
+            Positions.Reset(NumBodies);
+            for (int32 Index = 0; Index < NumBodies; ++Index)
+            {
+                Positions.Add(FVector3f(Random.FRandRange(Bounds.Min.X, Bounds.Max.X), Random.FRandRange(Bounds.Min.Y, Bounds.Max.Y), Random.FRandRange(Bounds.Min.Z, Bounds.Max.Z)));
+            }
+
+            const auto AddResult = [&Results, NumWells, NumBodies](const TCHAR* Kernel, double MedianMs, int32 NumItems, float MaxError)
+            {
+                FGravityKernelBenchmarkResult& Result = Results.AddDefaulted_GetRef();
+                Result.Kernel = Kernel;
+                Result.NumWells = NumWells;
+                Result.NumBodies = NumBodies;
+                Result.MedianMs = MedianMs;
+                Result.NsPerItem = NumItems > 0 ? MedianMs * 1.0e6 / NumItems : 0.0;
+                Result.MaxError = MaxError;
+            };
+
+            // per body, per well, double precision. Matches what the well actors do
+            FGravityVectorArray Reference;
+            const double ReferenceMs = TimeMedianMs(Settings.Iterations, [&]()
+            {
+                Reference.Reset(NumBodies);
+                for (int32 Index = 0; Index < NumBodies; ++Index)
+                {
+                    const FVector Position(Positions.Get(Index));
+                    FVector Accel = FVector::ZeroVector;
+                    for (const FGravityWell& Well : Wells)
+                    {
+                        Accel += ComputeAcceleration(Well, Position);
+                    }
+                    Reference.Add(FVector3f(Accel));
+                }
+            });
+            AddResult(TEXT("Reference"), ReferenceMs, NumBodies, 0.f);
+
+            FGravityVectorArray Accel;
+
+            const double ScalarMs = TimeMedianMs(Settings.Iterations, [&]() { EvaluateFieldScalar(Wells, Positions, Accel); });
+            AddResult(TEXT("Scalar"), ScalarMs, NumBodies, MaxDifference(Accel, Reference));
+
+            const double SimdMs = TimeMedianMs(Settings.Iterations, [&]() { EvaluateFieldSimd(Wells, Positions, Accel); });
+            AddResult(TEXT("Simd"), SimdMs, NumBodies, MaxDifference(Accel, Reference));
+
+            FGravityFieldCache Cache;
+            bool bCacheBuilt = false;
+            const double BuildMs = TimeMedianMs(Settings.Iterations, [&]() { bCacheBuilt = Cache.Build(Wells, Bounds, Settings.CacheCellSize); });
+
+            if (bCacheBuilt)
+            {
+                AddResult(TEXT("CacheBuild"), BuildMs, Cache.GetNumPoints(), 0.f);
+
+                const double SampleMs = TimeMedianMs(Settings.Iterations, [&]() { Cache.SampleBatch(Positions, Accel); });
+                AddResult(TEXT("CacheSample"), SampleMs, NumBodies, MaxDifference(Accel, Reference));
+            }
+        }
+    }
+
+    return Results;
+}
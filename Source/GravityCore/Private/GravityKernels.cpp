@@ -0,0 +1,300 @@
+#include "GravityKernels.h"
+
+#include "Math/VectorRegister.h"
+
+namespace
+{
+    /** Single precision acceleration of one well, shared by the scalar kernel and the SIMD remainder loop. */
+    FORCEINLINE FVector3f AccelerationAt(const FGravityWell& Well, const FVector3f& WellLocation, const FVector3f& TargetLocation)
+    {
+        const FVector3f Delta = WellLocation - TargetLocation;
+        const float DistSq = Delta.SizeSquared();
+
+        if (DistSq > FMath::Square(Well.MaxRadius) || DistSq <= FMath::Square(KINDA_SMALL_NUMBER))
+        {
+            return FVector3f::ZeroVector;
+        }
+
+        const float Distance = FMath::Sqrt(DistSq);
+        const float Magnitude = FMath::Clamp(GravityCore::ComputeMagnitude(Well, Distance), -Well.MaxAccel, Well.MaxAccel);
+        return Delta * (Magnitude / Distance);
+    }
+
+    /** Adds the field of one well to four bodies at a time. The falloff is a template parameter so the lane loop has no branches. */
+    template <EGravityFalloff Falloff>
+    void AccumulateWellSimd(const FGravityWell& Well, const FGravityVectorArray& Positions, FGravityVectorArray& OutAccel)
+    {
+        const FVector3f WellLocation(Well.Location);
+        const float CoreSq = FMath::Max(FMath::Square(Well.MinRadius), 1.f);
+
+        const VectorRegister4Float WellX = VectorSetFloat1(WellLocation.X);
+        const VectorRegister4Float WellY = VectorSetFloat1(WellLocation.Y);
+        const VectorRegister4Float WellZ = VectorSetFloat1(WellLocation.Z);
+        const VectorRegister4Float MaxRadius = VectorSetFloat1(Well.MaxRadius);
+        const VectorRegister4Float MaxRadiusSq = VectorSetFloat1(FMath::Square(Well.MaxRadius));
+        const VectorRegister4Float MinDistSq = VectorSetFloat1(FMath::Square(KINDA_SMALL_NUMBER));
+        const VectorRegister4Float CoreRadiusSq = VectorSetFloat1(CoreSq);
+        const VectorRegister4Float Strength = VectorSetFloat1(Well.Strength);
+        const VectorRegister4Float CoreStrength = VectorSetFloat1(Well.Strength / CoreSq);
+        const VectorRegister4Float InvFadeSpan = VectorSetFloat1(1.f / FMath::Max(Well.MaxRadius - Well.MinRadius, 1.f));
+        const VectorRegister4Float MaxAccel = VectorSetFloat1(Well.MaxAccel);
+        const VectorRegister4Float NegMaxAccel = VectorSetFloat1(-Well.MaxAccel);
+        const VectorRegister4Float Zero = VectorZeroFloat();
+        const VectorRegister4Float One = VectorOneFloat();
+
+        const int32 NumBodies = Positions.Num();
+        const int32 NumVectorized = NumBodies & ~3;
+
+        for (int32 Index = 0; Index < NumVectorized; Index += 4)
+        {
+            const VectorRegister4Float DX = VectorSubtract(WellX, VectorLoad(&Positions.X[Index]));
+            const VectorRegister4Float DY = VectorSubtract(WellY, VectorLoad(&Positions.Y[Index]));
+            const VectorRegister4Float DZ = VectorSubtract(WellZ, VectorLoad(&Positions.Z[Index]));
+
+            const VectorRegister4Float DistSq = VectorMultiplyAdd(DX, DX, VectorMultiplyAdd(DY, DY, VectorMultiply(DZ, DZ)));
+            const VectorRegister4Float InRange = VectorBitwiseAnd(VectorCompareLE(DistSq, MaxRadiusSq), VectorCompareGT(DistSq, MinDistSq));
+            const VectorRegister4Float InvDist = VectorReciprocalSqrt(VectorMax(DistSq, MinDistSq));
+
+            VectorRegister4Float Magnitude;
+            if constexpr (Falloff == EGravityFalloff::Linear)
+            {
+                const VectorRegister4Float Distance = VectorMultiply(DistSq, InvDist);
+                const VectorRegister4Float Fade = VectorMin(VectorMax(VectorMultiply(VectorSubtract(MaxRadius, Distance), InvFadeSpan), Zero), One);
+                Magnitude = VectorMultiply(CoreStrength, Fade);
+            }
+            else if constexpr (Falloff == EGravityFalloff::Constant)
+            {
+                Magnitude = CoreStrength;
+            }
+            else
+            {
+                Magnitude = VectorDivide(Strength, VectorMax(DistSq, CoreRadiusSq));
+            }
+
+            Magnitude = VectorMin(VectorMax(Magnitude, NegMaxAccel), MaxAccel);
+
+            // direction times magnitude, zeroed outside the influence radius
+            const VectorRegister4Float Scale = VectorSelect(InRange, VectorMultiply(Magnitude, InvDist), Zero);
+
+            VectorStore(VectorMultiplyAdd(DX, Scale, VectorLoad(&OutAccel.X[Index])), &OutAccel.X[Index]);
+            VectorStore(VectorMultiplyAdd(DY, Scale, VectorLoad(&OutAccel.Y[Index])), &OutAccel.Y[Index]);
+            VectorStore(VectorMultiplyAdd(DZ, Scale, VectorLoad(&OutAccel.Z[Index])), &OutAccel.Z[Index]);
+        }
+
+        for (int32 Index = NumVectorized; Index < NumBodies; ++Index)
+        {
+            const FVector3f Accel = AccelerationAt(Well, WellLocation, Positions.Get(Index));
+            OutAccel.X[Index] += Accel.X;
+            OutAccel.Y[Index] += Accel.Y;
+            OutAccel.Z[Index] += Accel.Z;
+        }
+    }
+}
+
+void FGravityVectorArray::Reset(int32 NewSize)
+{
+    X.Reset(NewSize);
+    Y.Reset(NewSize);
+    Z.Reset(NewSize);
+}
+
+void FGravityVectorArray::SetNumZeroed(int32 NewNum)
+{
+    X.SetNumZeroed(NewNum);
+    Y.SetNumZeroed(NewNum);
+    Z.SetNumZeroed(NewNum);
+}
+
+void FGravityVectorArray::Add(const FVector3f& Vector)
+{
+    X.Add(Vector.X);
+    Y.Add(Vector.Y);
+    Z.Add(Vector.Z);
+}
+
+float GravityCore::ComputeMagnitude(const FGravityWell& Well, float Distance)
+{
+    const float CoreSq = FMath::Max(FMath::Square(Well.MinRadius), 1.f);
+
+    switch (Well.Falloff)
+    {
+    case EGravityFalloff::Linear:
+        return Well.Strength / CoreSq * FMath::Clamp((Well.MaxRadius - Distance) / FMath::Max(Well.MaxRadius - Well.MinRadius, 1.f), 0.f, 1.f);
+
+    case EGravityFalloff::Constant:
+        return Well.Strength / CoreSq;
+
+    case EGravityFalloff::InverseSquare:
+    default:
+    {
+        const float ClampedRadius = FMath::Max(Distance, Well.MinRadius);
+        return Well.Strength / FMath::Max(ClampedRadius * ClampedRadius, 1.f);
+    }
+    }
+}
+
+FVector GravityCore::ComputeAcceleration(const FGravityWell& Well, const FVector& TargetLocation)
+{
+    const FVector Delta = Well.Location - TargetLocation;
+    const double Distance = Delta.Size();
+
+    if (Distance > Well.MaxRadius || Distance <= KINDA_SMALL_NUMBER)
+    {
+        return FVector::ZeroVector;
+    }
+
+    const float Magnitude = FMath::Clamp(ComputeMagnitude(Well, float(Distance)), -Well.MaxAccel, Well.MaxAccel);
+    return Delta * (Magnitude / Distance);
+}
+
+void GravityCore::EvaluateFieldScalar(TConstArrayView<FGravityWell> Wells, const FGravityVectorArray& Positions, FGravityVectorArray& OutAccel)
+{
+    const int32 NumBodies = Positions.Num();
+    OutAccel.SetNumZeroed(NumBodies);
+
+    TArray<FVector3f, TInlineAllocator<64>> WellLocations;
+    for (const FGravityWell& Well : Wells)
+    {
+        WellLocations.Add(FVector3f(Well.Location));
+    }
+
+    for (int32 Index = 0; Index < NumBodies; ++Index)
+    {
+        const FVector3f Position = Positions.Get(Index);
+        FVector3f Accel = FVector3f::ZeroVector;
+
+        for (int32 WellIndex = 0; WellIndex < Wells.Num(); ++WellIndex)
+        {
+            Accel += AccelerationAt(Wells[WellIndex], WellLocations[WellIndex], Position);
+        }
+
+        OutAccel.X[Index] = Accel.X;
+        OutAccel.Y[Index] = Accel.Y;
+        OutAccel.Z[Index] = Accel.Z;
+    }
+}
+
+void GravityCore::EvaluateFieldSimd(TConstArrayView<FGravityWell> Wells, const FGravityVectorArray& Positions, FGravityVectorArray& OutAccel)
+{
+    OutAccel.SetNumZeroed(Positions.Num());
+
+    for (const FGravityWell& Well : Wells)
+    {
+        switch (Well.Falloff)
+        {
+        case EGravityFalloff::Linear:
+            AccumulateWellSimd<EGravityFalloff::Linear>(Well, Positions, OutAccel);
+            break;
+
+        case EGravityFalloff::Constant:
+            AccumulateWellSimd<EGravityFalloff::Constant>(Well, Positions, OutAccel);
+            break;
+
+        case EGravityFalloff::InverseSquare:
+        default:
+            AccumulateWellSimd<EGravityFalloff::InverseSquare>(Well, Positions, OutAccel);
+            break;
+        }
+    }
+}
+
+bool FGravityFieldCache::Build(TConstArrayView<FGravityWell> Wells, const FBox3f& InBounds, float InCellSize, int32 MaxPoints)
+{
+    Reset();
+
+    CellSize = FMath::Max(InCellSize, 1.f);
+    InvCellSize = 1.f / CellSize;
+    Origin = InBounds.Min;
+
+    const FVector3f Size = InBounds.GetSize();
+    const FIntVector NewDims(
+        FMath::Max(FMath::CeilToInt32(Size.X * InvCellSize) + 1, 2),
+        FMath::Max(FMath::CeilToInt32(Size.Y * InvCellSize) + 1, 2),
+        FMath::Max(FMath::CeilToInt32(Size.Z * InvCellSize) + 1, 2));
+
+    const int64 NumPoints = int64(NewDims.X) * NewDims.Y * NewDims.Z;
+    if (NumPoints > MaxPoints)
+    {
+        return false;
+    }
+
+    Dims = NewDims;
+
+    FGravityVectorArray PointLocations;
+    PointLocations.Reset(int32(NumPoints));
+
+    for (int32 Z = 0; Z < Dims.Z; ++Z)
+    {
+        for (int32 Y = 0; Y < Dims.Y; ++Y)
+        {
+            for (int32 X = 0; X < Dims.X; ++X)
+            {
+                PointLocations.Add(Origin + FVector3f(X, Y, Z) * CellSize);
+            }
+        }
+    }
+
+    FGravityVectorArray PointAccel;
+    GravityCore::EvaluateFieldSimd(Wells, PointLocations, PointAccel);
+
+    Points.SetNumUninitialized(int32(NumPoints));
+    for (int32 Index = 0; Index < Points.Num(); ++Index)
+    {
+        Points[Index] = PointAccel.Get(Index);
+    }
+
+    return true;
+}
+
+void FGravityFieldCache::Reset()
+{
+    Points.Reset();
+    Dims = FIntVector::ZeroValue;
+}
+
+FVector3f FGravityFieldCache::Sample(const FVector3f& Position) const
+{
+    if (Points.IsEmpty())
+    {
+        return FVector3f::ZeroVector;
+    }
+
+    const FVector3f Local = (Position - Origin) * InvCellSize;
+    const float FX = FMath::Clamp(Local.X, 0.f, float(Dims.X - 1));
+    const float FY = FMath::Clamp(Local.Y, 0.f, float(Dims.Y - 1));
+    const float FZ = FMath::Clamp(Local.Z, 0.f, float(Dims.Z - 1));
+
+    // lower corner of the cell, kept one point short of the far edge so the upper corner always exists
+    const int32 X0 = FMath::Min(FMath::FloorToInt32(FX), Dims.X - 2);
+    const int32 Y0 = FMath::Min(FMath::FloorToInt32(FY), Dims.Y - 2);
+    const int32 Z0 = FMath::Min(FMath::FloorToInt32(FZ), Dims.Z - 2);
+    const float TX = FX - X0;
+    const float TY = FY - Y0;
+    const float TZ = FZ - Z0;
+
+    const int32 StrideY = Dims.X;
+    const int32 StrideZ = Dims.X * Dims.Y;
+    const FVector3f* Corner = &Points[Z0 * StrideZ + Y0 * StrideY + X0];
+
+    const FVector3f Bottom = FMath::Lerp(
+        FMath::Lerp(Corner[0], Corner[1], TX),
+        FMath::Lerp(Corner[StrideY], Corner[StrideY + 1], TX), TY);
+    const FVector3f Top = FMath::Lerp(
+        FMath::Lerp(Corner[StrideZ], Corner[StrideZ + 1], TX),
+        FMath::Lerp(Corner[StrideZ + StrideY], Corner[StrideZ + StrideY + 1], TX), TY);
+
+    return FMath::Lerp(Bottom, Top, TZ);
+}
+
+void FGravityFieldCache::SampleBatch(const FGravityVectorArray& Positions, FGravityVectorArray& OutAccel) const
+{
+    OutAccel.SetNumZeroed(Positions.Num());
+
+    for (int32 Index = 0; Index < Positions.Num(); ++Index)
+    {
+        const FVector3f Accel = Sample(Positions.Get(Index));
+        OutAccel.X[Index] = Accel.X;
+        OutAccel.Y[Index] = Accel.Y;
+        OutAccel.Z[Index] = Accel.Z;
+    }
+}
@@ -0,0 +1,415 @@
+#include "GravityScenario.h"
+
+#include "Dom/JsonObject.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace
+{
+    /** 'GTRJ' */
+    constexpr uint32 KTrajectoryMagic = 0x4A525447;
+    constexpr uint32 KTrajectoryVersion = 1;
+
+    /** Upper bound for RandomBodies.Count, so a typo in a scenario file can't allocate gigabytes up front. */
+    constexpr int32 KMaxRandomBodies = 1000000;
+
+    /** Reads an optional [X, Y, Z] field. Returns false only if the field is present but malformed. */
+    bool ReadVector(const FJsonObject& Object, const TCHAR* Field, FVector3f& OutVector)
+    {
+        const TArray<TSharedPtr<FJsonValue>>* Values = nullptr;
+        if (!Object.TryGetArrayField(Field, Values))
+        {
+            return !Object.HasField(Field);
+        }
+
+        if (Values->Num() != 3)
+        {
+            return false;
+        }
+
+        for (int32 Axis = 0; Axis < 3; ++Axis)
+        {
+            double Value = 0.0;
+            if (!(*Values)[Axis].IsValid() || !(*Values)[Axis]->TryGetNumber(Value))
+            {
+                return false;
+            }
+            OutVector[Axis] = float(Value);
+        }
+
+        return true;
+    }
+
+    bool ReadWell(const FJsonObject& Object, FGravityWell& OutWell, FString& OutError)
+    {
+        FVector3f Location = FVector3f(OutWell.Location);
+        if (!ReadVector(Object, TEXT("Location"), Location))
+        {
+            OutError = TEXT("well Location must be an array of three numbers");
+            return false;
+        }
+        OutWell.Location = FVector(Location);
+
+        Object.TryGetNumberField(TEXT("Strength"), OutWell.Strength);
+        Object.TryGetNumberField(TEXT("MinRadius"), OutWell.MinRadius);
+        Object.TryGetNumberField(TEXT("MaxRadius"), OutWell.MaxRadius);
+        Object.TryGetNumberField(TEXT("MaxAccel"), OutWell.MaxAccel);
+
+        FString Falloff;
+        if (Object.TryGetStringField(TEXT("Falloff"), Falloff))
+        {
+            if (Falloff == TEXT("InverseSquare"))
+            {
+                OutWell.Falloff = EGravityFalloff::InverseSquare;
+            }
+            else if (Falloff == TEXT("Linear"))
+            {
+                OutWell.Falloff = EGravityFalloff::Linear;
+            }
+            else if (Falloff == TEXT("Constant"))
+            {
+                OutWell.Falloff = EGravityFalloff::Constant;
+            }
+            else
+            {
+                OutError = FString::Printf(TEXT("unknown falloff %s"), *Falloff);
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool ReadBody(const FJsonObject& Object, FGravityScenarioBody& OutBody, FString& OutError)
+    {
+        if (!ReadVector(Object, TEXT("Location"), OutBody.Location) || !ReadVector(Object, TEXT("Velocity"), OutBody.Velocity))
+        {
+            OutError = TEXT("body Location and Velocity must be arrays of three numbers");
+            return false;
+        }
+
+        Object.TryGetNumberField(TEXT("Mass"), OutBody.Mass);
+        Object.TryGetBoolField(TEXT("Character"), OutBody.bCharacter);
+        return true;
+    }
+
+    bool ReadRandomBodies(const FJsonObject& Object, TArray<FGravityScenarioBody>& OutBodies, FString& OutError)
+    {
+        int32 Count = 0;
+        int32 Seed = 0;
+        float MaxSpeed = 0.f;
+        float Mass = 1.f;
+        FVector3f Center = FVector3f::ZeroVector;
+        FVector3f Extent(1000.f);
+
+        Object.TryGetNumberField(TEXT("Count"), Count);
+        Object.TryGetNumberField(TEXT("Seed"), Seed);
+        Object.TryGetNumberField(TEXT("MaxSpeed"), MaxSpeed);
+        Object.TryGetNumberField(TEXT("Mass"), Mass);
+
+        if (!ReadVector(Object, TEXT("Center"), Center) || !ReadVector(Object, TEXT("Extent"), Extent))
+        {
+            OutError = TEXT("RandomBodies Center and Extent must be arrays of three numbers");
+            return false;
+        }
+
+        if (Count < 0 || Count > KMaxRandomBodies)
+        {
+            OutError = FString::Printf(TEXT("RandomBodies Count must be between 0 and %d"), KMaxRandomBodies);
+            return false;
+        }
+
+        FRandomStream Random(Seed);
+        OutBodies.Reserve(OutBodies.Num() + Count);
+
+        for (int32 Index = 0; Index < Count; ++Index)
+        {
+            FGravityScenarioBody& Body = OutBodies.AddDefaulted_GetRef();
+            Body.Location = Center + FVector3f(Random.FRandRange(-Extent.X, Extent.X), Random.FRandRange(-Extent.Y, Extent.Y), Random.FRandRange(-Extent.Z, Extent.Z));
+            Body.Velocity = FVector3f(Random.GetUnitVector()) * Random.FRandRange(0.f, MaxSpeed);
+            Body.Mass = Mass;
+        }
+
+        return true;
+    }
+
+    /** Sums the field of every well with the double precision kernel the well actors use. */
+    void EvaluateFieldReference(TConstArrayView<FGravityWell> Wells, const FGravityVectorArray& Positions, FGravityVectorArray& OutAccel)
+    {
+        OutAccel.SetNumZeroed(Positions.Num());
+
+        for (int32 Index = 0; Index < Positions.Num(); ++Index)
+        {
+            const FVector Position(Positions.Get(Index));
+            FVector Accel = FVector::ZeroVector;
+
+            for (const FGravityWell& Well : Wells)
+            {
+                Accel += GravityCore::ComputeAcceleration(Well, Position);
+            }
+
+            OutAccel.X[Index] = float(Accel.X);
+            OutAccel.Y[Index] = float(Accel.Y);
+            OutAccel.Z[Index] = float(Accel.Z);
+        }
+    }
+}
+
+bool FGravityTrajectory::SaveBinary(const TCHAR* Filename) const
+{
+    TArray<uint8> Bytes;
+    FMemoryWriter Writer(Bytes);
+
+    uint32 Magic = KTrajectoryMagic;
+    uint32 Version = KTrajectoryVersion;
+    int32 SavedNumBodies = NumBodies;
+    int32 NumFrames = GetNumFrames();
+    float SavedFrameInterval = FrameInterval;
+
+    Writer << Magic << Version << SavedNumBodies << NumFrames << SavedFrameInterval;
+    Writer.Serialize(const_cast<FVector3f*>(Positions.GetData()), int64(NumFrames) * NumBodies * sizeof(FVector3f));
+
+    return FFileHelper::SaveArrayToFile(Bytes, Filename);
+}
+
+bool FGravityTrajectory::LoadBinary(const TCHAR* Filename)
+{
+    TArray<uint8> Bytes;
+    if (!FFileHelper::LoadFileToArray(Bytes, Filename))
+    {
+        return false;
+    }
+
+    FMemoryReader Reader(Bytes);
+
+    uint32 Magic = 0;
+    uint32 Version = 0;
+    int32 NumFrames = 0;
+
+    Reader << Magic << Version << NumBodies << NumFrames << FrameInterval;
+
+    // the header is untrusted, so size it in 64 bits against what's actually left in the file before allocating
+    const int64 RemainingBytes = Reader.TotalSize() - Reader.Tell();
+    const int64 NumPositions = int64(FMath::Max(NumFrames, 0)) * int64(FMath::Max(NumBodies, 0));
+
+    if (Reader.IsError() || Magic != KTrajectoryMagic || Version != KTrajectoryVersion || NumBodies < 0 || NumFrames < 0
+        || NumPositions > RemainingBytes / int64(sizeof(FVector3f)) || NumPositions > MAX_int32
+        || NumPositions * int64(sizeof(FVector3f)) != RemainingBytes)
+    {
+        NumBodies = 0;
+        Positions.Reset();
+        return false;
+    }
+
+    Positions.SetNumUninitialized(int32(NumPositions));
+    Reader.Serialize(Positions.GetData(), NumPositions * int64(sizeof(FVector3f)));
+    return true;
+}
+
+bool FGravityTrajectory::SaveCsv(const TCHAR* Filename) const
+{
+    TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(Filename));
+    if (!Writer)
+    {
+        return false;
+    }
+
+    TAnsiStringBuilder<64 * 1024> Lines;
+    Lines << "Frame,Time,Body,X,Y,Z\n";
+
+    for (int32 Frame = 0; Frame < GetNumFrames(); ++Frame)
+    {
+        for (int32 Body = 0; Body < NumBodies; ++Body)
+        {
+            const FVector3f& Position = GetPosition(Frame, Body);
+            Lines.Appendf("%d,%.5f,%d,%.3f,%.3f,%.3f\n", Frame, Frame * FrameInterval, Body, Position.X, Position.Y, Position.Z);
+
+            // flush in chunks, long runs of thousands of bodies don't fit in memory as text
+            if (Lines.Len() > 60 * 1024)
+            {
+                Writer->Serialize(const_cast<ANSICHAR*>(Lines.GetData()), Lines.Len());
+                Lines.Reset();
+            }
+        }
+    }
+
+    Writer->Serialize(const_cast<ANSICHAR*>(Lines.GetData()), Lines.Len());
+    return Writer->Close();
+}
+
+bool GravityScenario::LoadFromJson(const FString& Json, FGravityScenario& OutScenario, FString& OutError)
+{
+    TSharedPtr<FJsonObject> Root;
+    if (!FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Json), Root) || !Root.IsValid())
+    {
+        OutError = TEXT("not a JSON object");
+        return false;
+    }
+
+    OutScenario = FGravityScenario();
+    Root->TryGetNumberField(TEXT("TimeStep"), OutScenario.TimeStep);
+    Root->TryGetNumberField(TEXT("Steps"), OutScenario.NumSteps);
+    Root->TryGetNumberField(TEXT("RecordInterval"), OutScenario.RecordInterval);
+
+    if (OutScenario.TimeStep <= 0.f || OutScenario.NumSteps < 0 || OutScenario.RecordInterval < 1)
+    {
+        OutError = TEXT("TimeStep must be positive, Steps non-negative and RecordInterval at least 1");
+        return false;
+    }
+
+    const TArray<TSharedPtr<FJsonValue>>* Wells = nullptr;
+    if (Root->TryGetArrayField(TEXT("Wells"), Wells))
+    {
+        for (int32 Index = 0; Index < Wells->Num(); ++Index)
+        {
+            const TSharedPtr<FJsonValue>& Value = (*Wells)[Index];
+            const TSharedPtr<FJsonObject>* Object = nullptr;
+            if (!Value.IsValid() || !Value->TryGetObject(Object) || !ReadWell(**Object, OutScenario.Wells.AddDefaulted_GetRef(), OutError))
+            {
+                OutError = FString::Printf(TEXT("well %d: %s"), Index, OutError.IsEmpty() ? TEXT("not an object") : *OutError);
+                return false;
+            }
+        }
+    }
+
+    const TArray<TSharedPtr<FJsonValue>>* Bodies = nullptr;
+    if (Root->TryGetArrayField(TEXT("Bodies"), Bodies))
+    {
+        for (int32 Index = 0; Index < Bodies->Num(); ++Index)
+        {
+            const TSharedPtr<FJsonValue>& Value = (*Bodies)[Index];
+            const TSharedPtr<FJsonObject>* Object = nullptr;
+            if (!Value.IsValid() || !Value->TryGetObject(Object) || !ReadBody(**Object, OutScenario.Bodies.AddDefaulted_GetRef(), OutError))
+            {
+                OutError = FString::Printf(TEXT("body %d: %s"), Index, OutError.IsEmpty() ? TEXT("not an object") : *OutError);
+                return false;
+            }
+        }
+    }
+
+    const TSharedPtr<FJsonObject>* RandomBodies = nullptr;
+    if (Root->TryGetObjectField(TEXT("RandomBodies"), RandomBodies) && !ReadRandomBodies(**RandomBodies, OutScenario.Bodies, OutError))
+    {
+        return false;
+    }
+
+    return true;
+}
+
+void GravityScenario::Simulate(const FGravityScenario& Scenario, EGravityScenarioKernel Kernel, FGravityTrajectory& OutTrajectory)
+{
+    const int32 NumBodies = Scenario.Bodies.Num();
+    const int32 RecordInterval = FMath::Max(Scenario.RecordInterval, 1);
+    const float TimeStep = Scenario.TimeStep;
+
+    FGravityVectorArray Positions;
+    FGravityVectorArray Velocities;
+    FGravityVectorArray Accel;
+    TArray<float> AccelScales;
+
+    Positions.Reset(NumBodies);
+    Velocities.Reset(NumBodies);
+    AccelScales.Reserve(NumBodies);
+
+    for (const FGravityScenarioBody& Body : Scenario.Bodies)
+    {
+        Positions.Add(Body.Location);
+        Velocities.Add(Body.Velocity);
+        AccelScales.Add(Body.bCharacter ? 1.f : Body.Mass);
+    }
+
+    OutTrajectory.NumBodies = NumBodies;
+    OutTrajectory.FrameInterval = TimeStep * RecordInterval;
+    OutTrajectory.Positions.Reset((Scenario.NumSteps / RecordInterval + 1) * NumBodies);
+
+    const auto RecordFrame = [&OutTrajectory, &Positions, NumBodies]()
+    {
+        for (int32 Index = 0; Index < NumBodies; ++Index)
+        {
+            OutTrajectory.Positions.Add(Positions.Get(Index));
+        }
+    };
+
+    RecordFrame();
+
+    for (int32 Step = 1; Step <= Scenario.NumSteps; ++Step)
+    {
+        if (Kernel == EGravityScenarioKernel::Simd)
+        {
+            GravityCore::EvaluateFieldSimd(Scenario.Wells, Positions, Accel);
+        }
+        else
+        {
+            EvaluateFieldReference(Scenario.Wells, Positions, Accel);
+        }
+
+        for (int32 Index = 0; Index < NumBodies; ++Index)
+        {
+            const float VelocityScale = AccelScales[Index] * TimeStep;
+            Velocities.X[Index] += Accel.X[Index] * VelocityScale;
+            Velocities.Y[Index] += Accel.Y[Index] * VelocityScale;
+            Velocities.Z[Index] += Accel.Z[Index] * VelocityScale;
+
+            Positions.X[Index] += Velocities.X[Index] * TimeStep;
+            Positions.Y[Index] += Velocities.Y[Index] * TimeStep;
+            Positions.Z[Index] += Velocities.Z[Index] * TimeStep;
+        }
+
+        if (Step % RecordInterval == 0)
+        {
+            RecordFrame();
+        }
+    }
+}
+
+FGravityTrajectoryDiff GravityScenario::Diff(const FGravityTrajectory& Actual, const FGravityTrajectory& Golden, float Tolerance)
+{
+    FGravityTrajectoryDiff Result;
+
+    if (Actual.NumBodies != Golden.NumBodies || Actual.GetNumFrames() != Golden.GetNumFrames())
+    {
+        Result.Error = FString::Printf(TEXT("shape mismatch: %d bodies x %d frames, golden has %d x %d"),
+            Actual.NumBodies, Actual.GetNumFrames(), Golden.NumBodies, Golden.GetNumFrames());
+        return Result;
+    }
+
+    if (!FMath::IsNearlyEqual(Actual.FrameInterval, Golden.FrameInterval))
+    {
+        Result.Error = FString::Printf(TEXT("frame interval %fs, golden has %fs"), Actual.FrameInterval, Golden.FrameInterval);
+        return Result;
+    }
+
+    for (int32 Frame = 0; Frame < Actual.GetNumFrames(); ++Frame)
+    {
+        for (int32 Body = 0; Body < Actual.NumBodies; ++Body)
+        {
+            const float Error = FVector3f::Dist(Actual.GetPosition(Frame, Body), Golden.GetPosition(Frame, Body));
+
+            // a NaN compares false against the tolerance and would pass silently
+            if (!FMath::IsFinite(Error))
+            {
+                Result.Error = FString::Printf(TEXT("body %d has a non-finite position at frame %d"), Body, Frame);
+                return Result;
+            }
+
+            if (Error > Tolerance && Result.FirstFrame == INDEX_NONE)
+            {
+                Result.FirstFrame = Frame;
+                Result.FirstBody = Body;
+            }
+
+            if (Error > Result.MaxError)
+            {
+                Result.MaxError = Error;
+                Result.MaxErrorFrame = Frame;
+                Result.MaxErrorBody = Body;
+            }
+        }
+    }
+
+    return Result;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GravityKernels.h"
+
+/** Scene sizes and kernel settings of a kernel microbenchmark run. */
+struct FGravityKernelBenchmarkSettings
+{
+    /** Every well count is run against every body count. */
+    TArray<int32> WellCounts = { 1, 8, 64 };
+    TArray<int32> BodyCounts = { 256, 4096, 65536 };
+
+    /** Timed runs per kernel and size. The median is reported. */
+    int32 Iterations = 20;
+
+    int32 Seed = 1337;
+
+    /** Edge length and height of the box wells and bodies are scattered in, in cm. */
+    float ArenaSize = 20000.f;
+    float ArenaHeight = 4000.f;
+
+    float CacheCellSize = 200.f;
+
+    EGravityFalloff Falloff = EGravityFalloff::InverseSquare;
+};
+
+/** Timing of one kernel at one scene size. */
+struct FGravityKernelBenchmarkResult
+{
+    FString Kernel;
+    int32 NumWells = 0;
+    int32 NumBodies = 0;
+
+    double MedianMs = 0.0;
+
+    /** Median cost per body, or per grid point for the cache build. */
+    double NsPerItem = 0.0;
+
+    /** Largest difference from the double precision reference kernel, in cm/s^2. */
+    float MaxError = 0.f;
+};
+
+namespace GravityCore
+{
+    /**
+     * Times the reference, scalar, SIMD and cached grid kernels over random scenes of every requested size.
+     * Needs no world or actors, only the kernels in this module. The GravityKernelBenchmark commandlet of the game module
+     * runs it, so the engine still starts up, but no level is loaded and a run takes seconds.
+     */
+    GRAVITYCORE_API TArray<FGravityKernelBenchmarkResult> RunKernelBenchmarks(const FGravityKernelBenchmarkSettings& Settings);
+}
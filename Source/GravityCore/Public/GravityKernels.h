@@ -0,0 +1,97 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** How a well's pull scales with distance between its core and its influence radius. */
+enum class EGravityFalloff : uint8
+{
+    /** Strength / r^2, with r clamped to the core radius. */
+    InverseSquare,
+
+    /** Core strength fading linearly to zero at the influence radius. */
+    Linear,
+
+    /** Core strength everywhere inside the influence radius. */
+    Constant,
+};
+
+/** Plain description of a gravity well, independent of the actor that owns it. */
+struct FGravityWell
+{
+    FVector Location = FVector::ZeroVector;
+
+    /** Negative values push bodies away. */
+    float Strength = 3000000.f;
+
+    float MinRadius = 150.f;
+    float MaxRadius = 1500.f;
+    float MaxAccel = 6000.f;
+
+    EGravityFalloff Falloff = EGravityFalloff::InverseSquare;
+};
+
+/** Structure of arrays of 3D vectors, the layout the batched kernels read body positions from and write accelerations to. */
+struct GRAVITYCORE_API FGravityVectorArray
+{
+    TArray<float> X;
+    TArray<float> Y;
+    TArray<float> Z;
+
+    int32 Num() const { return X.Num(); }
+
+    void Reset(int32 NewSize = 0);
+
+    /** Resizes to NewNum zeroed vectors. */
+    void SetNumZeroed(int32 NewNum);
+
+    void Add(const FVector3f& Vector);
+
+    FVector3f Get(int32 Index) const { return FVector3f(X[Index], Y[Index], Z[Index]); }
+};
+
+namespace GravityCore
+{
+    /** Returns the signed acceleration magnitude of a well at the given distance, before the MaxAccel clamp. */
+    GRAVITYCORE_API float ComputeMagnitude(const FGravityWell& Well, float Distance);
+
+    /** Returns the acceleration a single well applies to a body at the given location. Reference kernel. */
+    GRAVITYCORE_API FVector ComputeAcceleration(const FGravityWell& Well, const FVector& TargetLocation);
+
+    /** Sums the acceleration of every well at every position, one body at a time. */
+    GRAVITYCORE_API void EvaluateFieldScalar(TConstArrayView<FGravityWell> Wells, const FGravityVectorArray& Positions, FGravityVectorArray& OutAccel);
+
+    /** Same as EvaluateFieldScalar, four bodies per instruction. Single precision, so results differ from the reference in the last bits. */
+    GRAVITYCORE_API void EvaluateFieldSimd(TConstArrayView<FGravityWell> Wells, const FGravityVectorArray& Positions, FGravityVectorArray& OutAccel);
+}
+
+/**
+ * Dense grid of the summed field sampled at cell corners, interpolated trilinearly.
+ * Trades a build pass and memory for a lookup cost that doesn't grow with the number of wells.
+ */
+class GRAVITYCORE_API FGravityFieldCache
+{
+public:
+    /** Samples the field of the wells over the bounds. Returns false if the grid would exceed MaxPoints. */
+    bool Build(TConstArrayView<FGravityWell> Wells, const FBox3f& InBounds, float InCellSize, int32 MaxPoints = 1 << 22);
+
+    void Reset();
+
+    bool IsBuilt() const { return !Points.IsEmpty(); }
+
+    int32 GetNumPoints() const { return Points.Num(); }
+
+    /** Returns the interpolated acceleration. Positions outside the bounds are clamped to them. */
+    FVector3f Sample(const FVector3f& Position) const;
+
+    void SampleBatch(const FGravityVectorArray& Positions, FGravityVectorArray& OutAccel) const;
+
+private:
+    FVector3f Origin = FVector3f::ZeroVector;
+    float CellSize = 1.f;
+    float InvCellSize = 1.f;
+
+    /** Number of sample points along each axis. */
+    FIntVector Dims = FIntVector::ZeroValue;
+
+    TArray<FVector3f> Points;
+};
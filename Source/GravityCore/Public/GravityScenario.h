@@ -0,0 +1,106 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GravityKernels.h"
+
+/** A body simulated by a scenario. */
+struct FGravityScenarioBody
+{
+    FVector3f Location = FVector3f::ZeroVector;
+    FVector3f Velocity = FVector3f::ZeroVector;
+    float Mass = 1.f;
+
+    /** Characters integrate the field acceleration directly, rigid bodies the way the wells push them. */
+    bool bCharacter = false;
+};
+
+/** Which field kernel a scenario is stepped with. */
+enum class EGravityScenarioKernel : uint8
+{
+    /** Double precision per body kernel, the one the well actors use. */
+    Reference,
+
+    /** Single precision SIMD batch kernel. */
+    Simd,
+};
+
+/**
+ * Wells and bodies simulated offline. Loaded from JSON such as:
+ *
+ *   {
+ *     "TimeStep": 0.0166667, "Steps": 600, "RecordInterval": 1,
+ *     "Wells": [ { "Location": [0, 0, 500], "Strength": 3000000, "MinRadius": 150, "MaxRadius": 1500, "MaxAccel": 6000, "Falloff": "InverseSquare" } ],
+ *     "Bodies": [ { "Location": [800, 0, 500], "Velocity": [0, 600, 0], "Mass": 1, "Character": false } ],
+ *     "RandomBodies": { "Count": 5000, "Seed": 7, "Center": [0, 0, 500], "Extent": [2000, 2000, 500], "MaxSpeed": 400, "Mass": 1 }
+ *   }
+ *
+ * Well fields that are left out keep the FGravityWell defaults. RandomBodies is optional, holds at most a million bodies
+ * and is appended after Bodies.
+ */
+struct FGravityScenario
+{
+    TArray<FGravityWell> Wells;
+    TArray<FGravityScenarioBody> Bodies;
+
+    float TimeStep = 1.f / 60.f;
+    int32 NumSteps = 600;
+
+    /** Steps between recorded frames. */
+    int32 RecordInterval = 1;
+};
+
+/** Recorded body positions, frame major. */
+struct GRAVITYCORE_API FGravityTrajectory
+{
+    int32 NumBodies = 0;
+
+    /** Seconds between recorded frames. */
+    float FrameInterval = 0.f;
+
+    TArray<FVector3f> Positions;
+
+    int32 GetNumFrames() const { return NumBodies > 0 ? Positions.Num() / NumBodies : 0; }
+
+    const FVector3f& GetPosition(int32 Frame, int32 Body) const { return Positions[Frame * NumBodies + Body]; }
+
+    bool SaveBinary(const TCHAR* Filename) const;
+    bool LoadBinary(const TCHAR* Filename);
+
+    /** Writes one Frame,Time,Body,X,Y,Z row per body and frame. */
+    bool SaveCsv(const TCHAR* Filename) const;
+};
+
+/** Result of comparing a trajectory against a golden one. */
+struct FGravityTrajectoryDiff
+{
+    /** Set if the trajectories can't be compared at all, e.g. different body or frame counts. */
+    FString Error;
+
+    /** First frame and body farther from the golden position than the tolerance, or INDEX_NONE. */
+    int32 FirstFrame = INDEX_NONE;
+    int32 FirstBody = INDEX_NONE;
+
+    float MaxError = 0.f;
+    int32 MaxErrorFrame = INDEX_NONE;
+    int32 MaxErrorBody = INDEX_NONE;
+
+    bool IsMatching() const { return Error.IsEmpty() && FirstFrame == INDEX_NONE; }
+};
+
+namespace GravityScenario
+{
+    /** Parses a scenario. Returns false and describes the problem in OutError if the JSON is malformed. */
+    GRAVITYCORE_API bool LoadFromJson(const FString& Json, FGravityScenario& OutScenario, FString& OutError);
+
+    /**
+     * Steps the scenario with semi-implicit Euler and records the trajectory.
+     * Rigid bodies receive the field acceleration scaled by their mass as an acceleration change, like the
+     * AddForce(Accel * Mass, NAME_None, true) call of the well actors. Characters add the acceleration to their velocity.
+     * This checks the field kernels and the integration only, not a level: every well is applied on every step rather than
+     * on the actors' TickInterval timer, and there is no world gravity, collision or solver in between.
+     */
+    GRAVITYCORE_API void Simulate(const FGravityScenario& Scenario, EGravityScenarioKernel Kernel, FGravityTrajectory& OutTrajectory);
+
+    /** Compares positions frame by frame. Positions within Tolerance cm of the golden ones match. A non-finite position is an Error. */
+    GRAVITYCORE_API FGravityTrajectoryDiff Diff(const FGravityTrajectory& Actual, const FGravityTrajectory& Golden, float Tolerance);
+}
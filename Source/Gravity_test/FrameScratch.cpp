@@ -0,0 +1,71 @@
+#include "FrameScratch.h"
+
+#include "GravityStats.h"
+#include "Engine/OverlapResult.h"
+
+namespace
+{
+    /** Overlap arrays returned by finished scopes, ready to be borrowed again. */
+    TArray<TUniquePtr<TArray<FOverlapResult>>>& GetFreeOverlapBuffers()
+    {
+        thread_local TArray<TUniquePtr<TArray<FOverlapResult>>> FreeBuffers;
+        return FreeBuffers;
+    }
+
+    /** Records the scratch bytes a scope used into the per frame peak. Only the game thread reports it. */
+    void RecordScratchUsage(int32 Bytes)
+    {
+        if (!IsInGameThread())
+        {
+            return;
+        }
+
+        static uint64 PeakFrame = 0;
+        static int32 FramePeak = 0;
+
+        if (PeakFrame != GFrameCounter)
+        {
+            PeakFrame = GFrameCounter;
+            FramePeak = 0;
+        }
+
+        if (Bytes > FramePeak)
+        {
+            FramePeak = Bytes;
+            SET_MEMORY_STAT(STAT_FrameScratchPeak, FramePeak);
+        }
+    }
+}
+
+FFrameScratchScope::FFrameScratchScope()
+    : Mark(FMemStack::Get())
+    , StartByteCount(FMemStack::Get().GetByteCount())
+{
+}
+
+FFrameScratchScope::~FFrameScratchScope()
+{
+    // the mark pops after this body, so the stack still holds everything this scope allocated
+    RecordScratchUsage(FMemStack::Get().GetByteCount() - StartByteCount);
+}
+
+FScopedOverlapBuffer::FScopedOverlapBuffer()
+{
+    TArray<TUniquePtr<TArray<FOverlapResult>>>& FreeBuffers = GetFreeOverlapBuffers();
+
+    if (FreeBuffers.IsEmpty())
+    {
+        INC_DWORD_STAT(STAT_PooledOverlapBuffers);
+        Buffer = new TArray<FOverlapResult>();
+    }
+    else
+    {
+        Buffer = FreeBuffers.Pop(EAllowShrinking::No).Release();
+    }
+}
+
+FScopedOverlapBuffer::~FScopedOverlapBuffer()
+{
+    Buffer->Reset();
+    GetFreeOverlapBuffers().Emplace(Buffer);
+}
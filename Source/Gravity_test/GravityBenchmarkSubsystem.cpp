@@ -0,0 +1,254 @@
+#include "GravityBenchmarkSubsystem.h"
+
+#include "GravityWellActor.h"
+#include "WhiteHoleActor.h"
+#include "GravityStats.h"
+#include "GravityTestScene.h"
+#include "Gravity_test.h"
+#include "Engine/World.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "Misc/DateTime.h"
+#include "Physics/Experimental/PhysScene_Chaos.h"
+
+namespace
+{
+    /** Returns the value at the given percentile of an unsorted list. */
+    float Percentile(TArray<float> Values, float Fraction)
+    {
+        if (Values.IsEmpty())
+        {
+            return 0.f;
+        }
+
+        Values.Sort();
+        return Values[FMath::Clamp(FMath::FloorToInt32(Fraction * Values.Num()), 0, Values.Num() - 1)];
+    }
+
+    float CyclesToMs(uint64 Cycles)
+    {
+        return float(FPlatformTime::ToMilliseconds64(Cycles));
+    }
+}
+
+bool FGravityBenchmarkSettings::ParseCommandLine(const TCHAR* CommandLine)
+{
+    if (!FParse::Param(CommandLine, TEXT("GravityBenchmark")))
+    {
+        return false;
+    }
+
+    FParse::Value(CommandLine, TEXT("Wells="), NumWells);
+    FParse::Value(CommandLine, TEXT("WhiteHoles="), NumWhiteHoles);
+    FParse::Value(CommandLine, TEXT("Bodies="), NumBodies);
+    FParse::Value(CommandLine, TEXT("Characters="), NumCharacters);
+    FParse::Value(CommandLine, TEXT("WarmupFrames="), WarmupFrames);
+    FParse::Value(CommandLine, TEXT("Frames="), Frames);
+    FParse::Value(CommandLine, TEXT("Arena="), ArenaSize);
+    FParse::Value(CommandLine, TEXT("Seed="), Seed);
+
+    if (!FParse::Value(CommandLine, TEXT("BenchmarkCsv="), CsvPath))
+    {
+        CsvPath = FPaths::ProfilingDir() / TEXT("GravityBenchmark") / FString::Printf(TEXT("GravityBenchmark_%s.csv"), *FDateTime::Now().ToString());
+    }
+
+    NumWells = FMath::Max(NumWells, 0);
+    NumWhiteHoles = FMath::Max(NumWhiteHoles, 0);
+    NumBodies = FMath::Max(NumBodies, 0);
+    NumCharacters = FMath::Max(NumCharacters, 0);
+    WarmupFrames = FMath::Max(WarmupFrames, 0);
+    Frames = FMath::Max(Frames, 1);
+    ArenaSize = FMath::Max(ArenaSize, 1000.f);
+
+    return true;
+}
+
+bool UGravityBenchmarkSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+    return Super::ShouldCreateSubsystem(Outer) && FParse::Param(FCommandLine::Get(), TEXT("GravityBenchmark"));
+}
+
+bool UGravityBenchmarkSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game;
+}
+
+void UGravityBenchmarkSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+    Super::OnWorldBeginPlay(InWorld);
+
+    if (!Settings.ParseCommandLine(FCommandLine::Get()))
+    {
+        return;
+    }
+
+    UE_LOG(LogGravity_test, Display, TEXT("GravityBenchmark: %d wells, %d white holes, %d bodies, %d characters, %d + %d frames."),
+        Settings.NumWells, Settings.NumWhiteHoles, Settings.NumBodies, Settings.NumCharacters, Settings.WarmupFrames, Settings.Frames);
+
+    SpawnScene(InWorld);
+
+    Samples.Reserve(Settings.Frames);
+    GravityStats::ConsumeFrameCounters();
+
+    TickStartHandle = FWorldDelegates::OnWorldTickStart.AddUObject(this, &UGravityBenchmarkSubsystem::OnWorldTickStart);
+    PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UGravityBenchmarkSubsystem::OnWorldPostActorTick);
+
+    if (FPhysScene_Chaos* PhysScene = InWorld.GetPhysicsScene())
+    {
+        PhysicsPreTickHandle = PhysScene->OnPhysScenePreTick.AddUObject(this, &UGravityBenchmarkSubsystem::OnPhysicsPreTick);
+        PhysicsPostTickHandle = PhysScene->OnPhysScenePostTick.AddUObject(this, &UGravityBenchmarkSubsystem::OnPhysicsPostTick);
+    }
+
+    bRunning = true;
+}
+
+void UGravityBenchmarkSubsystem::Deinitialize()
+{
+    FWorldDelegates::OnWorldTickStart.Remove(TickStartHandle);
+    FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+
+    if (UWorld* World = GetWorld())
+    {
+        if (FPhysScene_Chaos* PhysScene = World->GetPhysicsScene())
+        {
+            PhysScene->OnPhysScenePreTick.Remove(PhysicsPreTickHandle);
+            PhysScene->OnPhysScenePostTick.Remove(PhysicsPostTickHandle);
+        }
+    }
+
+    if (bRunning)
+    {
+        UE_LOG(LogGravity_test, Error, TEXT("GravityBenchmark: world torn down after %d of %d frames."), Samples.Num(), Settings.Frames);
+        WriteResults();
+        Finish(1);
+    }
+
+    Super::Deinitialize();
+}
+
+void UGravityBenchmarkSubsystem::SpawnScene(UWorld& InWorld)
+{
+    FRandomStream Random(Settings.Seed);
+    const float HalfArena = Settings.ArenaSize * 0.5f;
+
+    GravityTestScene::SpawnFloor(InWorld, Settings.ArenaSize);
+
+    const auto RandomLocation = [&Random, HalfArena](float MinZ, float MaxZ)
+    {
+        return FVector(Random.FRandRange(-HalfArena, HalfArena), Random.FRandRange(-HalfArena, HalfArena), Random.FRandRange(MinZ, MaxZ));
+    };
+
+    for (int32 Index = 0; Index < Settings.NumWells + Settings.NumWhiteHoles; ++Index)
+    {
+        const FTransform WellTransform(RandomLocation(500.f, 1500.f));
+        const TSubclassOf<AGravityWellActor> WellClass = Index < Settings.NumWells ? AGravityWellActor::StaticClass() : AWhiteHoleActor::StaticClass();
+
+        FActorSpawnParameters SpawnParams;
+        SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+        InWorld.SpawnActor<AGravityWellActor>(WellClass, WellTransform, SpawnParams);
+    }
+
+    for (int32 Index = 0; Index < Settings.NumBodies; ++Index)
+    {
+        GravityTestScene::SpawnPhysicsBody(InWorld, RandomLocation(200.f, 2000.f));
+    }
+
+    for (int32 Index = 0; Index < Settings.NumCharacters; ++Index)
+    {
+        GravityTestScene::SpawnIdleCharacter(InWorld, RandomLocation(100.f, 100.f));
+    }
+}
+
+void UGravityBenchmarkSubsystem::OnWorldTickStart(UWorld* InWorld, ELevelTick TickType, float DeltaTime)
+{
+    if (InWorld == GetWorld())
+    {
+        LastTickStartCycle = TickStartCycle;
+        TickStartCycle = FPlatformTime::Cycles64();
+        PhysicsCycles = 0;
+    }
+}
+
+void UGravityBenchmarkSubsystem::OnWorldPostActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaTime)
+{
+    if (!bRunning || InWorld != GetWorld())
+    {
+        return;
+    }
+
+    const GravityStats::FFrameCounters Counters = GravityStats::ConsumeFrameCounters();
+
+    if (++FrameIndex <= Settings.WarmupFrames || LastTickStartCycle == 0)
+    {
+        return;
+    }
+
+    FFrameSample& Sample = Samples.AddDefaulted_GetRef();
+    Sample.FrameMs = CyclesToMs(TickStartCycle - LastTickStartCycle);
+    Sample.WorldTickMs = CyclesToMs(FPlatformTime::Cycles64() - TickStartCycle);
+    Sample.PhysicsMs = CyclesToMs(PhysicsCycles);
+    Sample.WellStepMs = CyclesToMs(Counters.WellStepCycles);
+    Sample.WellSteps = Counters.WellSteps;
+    Sample.TrackedBodies = Counters.TrackedBodies;
+    Sample.Characters = Counters.Characters;
+    Sample.ForcesApplied = Counters.ForcesApplied;
+
+    if (Samples.Num() >= Settings.Frames)
+    {
+        bRunning = false;
+        WriteResults();
+        Finish(0);
+    }
+}
+
+void UGravityBenchmarkSubsystem::OnPhysicsPreTick(FPhysScene_Chaos* PhysScene, float DeltaTime)
+{
+    PhysicsStartCycle = FPlatformTime::Cycles64();
+}
+
+void UGravityBenchmarkSubsystem::OnPhysicsPostTick(FPhysScene_Chaos* PhysScene)
+{
+    if (PhysicsStartCycle != 0)
+    {
+        PhysicsCycles += FPlatformTime::Cycles64() - PhysicsStartCycle;
+        PhysicsStartCycle = 0;
+    }
+}
+
+void UGravityBenchmarkSubsystem::WriteResults()
+{
+    TStringBuilder<64 * 1024> Csv;
+    Csv << TEXT("Frame,FrameMs,WorldTickMs,PhysicsMs,WellStepMs,WellSteps,TrackedBodies,Characters,ForcesApplied\n");
+
+    TArray<float> WorldTickTimes;
+    TArray<float> WellStepTimes;
+    WorldTickTimes.Reserve(Samples.Num());
+    WellStepTimes.Reserve(Samples.Num());
+
+    for (int32 Index = 0; Index < Samples.Num(); ++Index)
+    {
+        const FFrameSample& Sample = Samples[Index];
+        Csv.Appendf(TEXT("%d,%.4f,%.4f,%.4f,%.4f,%d,%d,%d,%d\n"), Index, Sample.FrameMs, Sample.WorldTickMs, Sample.PhysicsMs, Sample.WellStepMs,
+            Sample.WellSteps, Sample.TrackedBodies, Sample.Characters, Sample.ForcesApplied);
+
+        WorldTickTimes.Add(Sample.WorldTickMs);
+        WellStepTimes.Add(Sample.WellStepMs);
+    }
+
+    if (!FFileHelper::SaveStringToFile(Csv.ToView(), *Settings.CsvPath))
+    {
+        UE_LOG(LogGravity_test, Error, TEXT("GravityBenchmark: could not write %s."), *Settings.CsvPath);
+        return;
+    }
+
+    UE_LOG(LogGravity_test, Display, TEXT("GravityBenchmark: wrote %d frames to %s. World tick median %.3fms p95 %.3fms, well steps median %.3fms p95 %.3fms."),
+        Samples.Num(), *Settings.CsvPath, Percentile(WorldTickTimes, 0.5f), Percentile(WorldTickTimes, 0.95f), Percentile(WellStepTimes, 0.5f), Percentile(WellStepTimes, 0.95f));
+}
+
+void UGravityBenchmarkSubsystem::Finish(int32 ExitCode)
+{
+    bRunning = false;
+    FPlatformMisc::RequestExitWithStatus(false, ExitCode);
+}
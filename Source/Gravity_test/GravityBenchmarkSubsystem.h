@@ -0,0 +1,98 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GravityBenchmarkSubsystem.generated.h"
+
+class FPhysScene_Chaos;
+
+/** Scene and run settings of a gravity benchmark, parsed from the command line. */
+struct FGravityBenchmarkSettings
+{
+    int32 NumWells = 16;
+    int32 NumWhiteHoles = 4;
+    int32 NumBodies = 256;
+    int32 NumCharacters = 32;
+
+    /** Frames to let the scene settle before recording. */
+    int32 WarmupFrames = 60;
+
+    /** Frames to record. */
+    int32 Frames = 600;
+
+    /** Edge length of the square arena, in cm. */
+    float ArenaSize = 20000.f;
+
+    int32 Seed = 1337;
+
+    /** Output CSV path. Defaults to Saved/Profiling/GravityBenchmark. */
+    FString CsvPath;
+
+    /** Returns false if the command line doesn't ask for a benchmark. */
+    bool ParseCommandLine(const TCHAR* CommandLine);
+};
+
+/**
+ * Headless stress benchmark for the gravity wells.
+ *
+ * Activated by -GravityBenchmark on a game run, e.g. on a GPU-less box:
+ *   Gravity_test /Engine/Maps/Entry -game -nullrhi -nosound -unattended -benchmark -fps=30
+ *       -GravityBenchmark -Wells=64 -WhiteHoles=16 -Bodies=1000 -Characters=100 -Frames=1000 -BenchmarkCsv=out.csv
+ *
+ * Builds a procedural arena in whatever map is loaded, records per-frame world tick, physics and gravity
+ * timings and counters to CSV, then exits. The exit code is non-zero if the run could not complete.
+ */
+UCLASS()
+class GRAVITY_TEST_API UGravityBenchmarkSubsystem : public UWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+    virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+    virtual void Deinitialize() override;
+
+private:
+    /** One recorded frame. */
+    struct FFrameSample
+    {
+        float FrameMs = 0.f;
+        float WorldTickMs = 0.f;
+        float PhysicsMs = 0.f;
+        float WellStepMs = 0.f;
+        int32 WellSteps = 0;
+        int32 TrackedBodies = 0;
+        int32 Characters = 0;
+        int32 ForcesApplied = 0;
+    };
+
+    void SpawnScene(UWorld& InWorld);
+    void WriteResults();
+    void Finish(int32 ExitCode);
+
+    void OnWorldTickStart(UWorld* InWorld, ELevelTick TickType, float DeltaTime);
+    void OnWorldPostActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaTime);
+    void OnPhysicsPreTick(FPhysScene_Chaos* PhysScene, float DeltaTime);
+    void OnPhysicsPostTick(FPhysScene_Chaos* PhysScene);
+
+    FGravityBenchmarkSettings Settings;
+
+    TArray<FFrameSample> Samples;
+
+    int32 FrameIndex = 0;
+    bool bRunning = false;
+
+    /** Cycle the current and the previous world tick started at. */
+    uint64 TickStartCycle = 0;
+    uint64 LastTickStartCycle = 0;
+
+    /** Physics step cycles of the current frame. */
+    uint64 PhysicsStartCycle = 0;
+    uint64 PhysicsCycles = 0;
+
+    FDelegateHandle TickStartHandle;
+    FDelegateHandle PostActorTickHandle;
+    FDelegateHandle PhysicsPreTickHandle;
+    FDelegateHandle PhysicsPostTickHandle;
+};
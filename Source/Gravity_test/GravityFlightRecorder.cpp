@@ -0,0 +1,625 @@
+#include "GravityFlightRecorder.h"
+
+#include "Gravity_test.h"
+#include "Algo/Sort.h"
+#include "Engine/EngineTypes.h"
+#include "GenericPlatform/GenericPlatformFile.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "HAL/ThreadManager.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/DateTime.h"
+#include "Misc/DelayedAutoRegister.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/Archive.h"
+#include <atomic>
+
+namespace GravityFlightRecorder
+{
+    namespace
+    {
+        bool GEnabled = true;
+        FAutoConsoleVariableRef CVarEnabled(
+            TEXT("Gravity.FlightRecorder.Enable"),
+            GEnabled,
+            TEXT("Record gravity and combat events into the per thread flight recorder rings."),
+            ECVF_Default);
+
+        int32 GCapacity = 4096;
+        FAutoConsoleVariableRef CVarCapacity(
+            TEXT("Gravity.FlightRecorder.Capacity"),
+            GCapacity,
+            TEXT("Records kept per thread, rounded up to a power of two. Read when a thread records its first event."),
+            ECVF_ReadOnly);
+
+        bool GDumpOnEnsure = true;
+        FAutoConsoleVariableRef CVarDumpOnEnsure(
+            TEXT("Gravity.FlightRecorder.DumpOnEnsure"),
+            GDumpOnEnsure,
+            TEXT("Dump the flight recorder when an ensure fires."),
+            ECVF_Default);
+
+        constexpr uint32 KFileMagic = 0x43524647;
+        constexpr uint32 KFileVersion = 1;
+
+        /** Upper bound on the records read per thread, so a corrupt file can't request a huge allocation. */
+        constexpr int32 KMaxRecordsPerThread = 1 << 24;
+
+        /** Minimum time between two ensure dumps, so an ensure firing in a loop doesn't flood the disk. */
+        constexpr double KMinEnsureDumpIntervalSeconds = 10.0;
+
+        /** Distinct names a crash dump can resolve. Objects past it decode as unnamed. */
+        constexpr int32 KMaxCrashDumpNames = 16 * 1024;
+
+        static_assert(sizeof(FRecord) == 48, "Flight recorder records are written to disk as is");
+
+        /** A single thread's ring. Only its owning thread writes records, dumps read them from any thread. */
+        struct FThreadRing
+        {
+            TUniquePtr<FRecord[]> Records;
+            uint32 Mask = 0;
+            uint32 ThreadId = 0;
+            FString ThreadName;
+
+            /** Index of the next record to write. Every record below it is complete. */
+            std::atomic<uint64> WriteIndex{0};
+
+            FThreadRing* Next = nullptr;
+        };
+
+        /** Every ring ever created. Rings are never freed, so the history of exited threads survives until the dump. */
+        std::atomic<FThreadRing*> GRings{nullptr};
+
+        /** Everything a crash dump needs, allocated up front because the crash handler must not allocate. */
+        struct FCrashDumpState
+        {
+            FString FilePath;
+
+            /** Snapshot of one ring at a time. */
+            TArray<FRecord> Records;
+
+            TArray<uint32> NameIds;
+        };
+
+        FCrashDumpState GCrashDump;
+
+        uint32 GetRingCapacity()
+        {
+            return FMath::RoundUpToPowerOfTwo(uint32(FMath::Max(GCapacity, 16)));
+        }
+
+        FThreadRing* CreateThreadRing()
+        {
+            LLM_SCOPE_BYTAG(Gravity);
+
+            const uint32 Capacity = GetRingCapacity();
+
+            FThreadRing* Ring = new FThreadRing();
+            Ring->Records = MakeUnique<FRecord[]>(Capacity);
+            Ring->Mask = Capacity - 1;
+            Ring->ThreadId = FPlatformTLS::GetCurrentThreadId();
+            Ring->ThreadName = IsInGameThread() ? FString(TEXT("GameThread")) : FThreadManager::GetThreadName(Ring->ThreadId);
+
+            if (Ring->ThreadName.IsEmpty())
+            {
+                Ring->ThreadName = FString::Printf(TEXT("Thread %u"), Ring->ThreadId);
+            }
+
+            FThreadRing* Head = GRings.load(std::memory_order_relaxed);
+            do
+            {
+                Ring->Next = Head;
+            }
+            while (!GRings.compare_exchange_weak(Head, Ring, std::memory_order_release, std::memory_order_relaxed));
+
+            return Ring;
+        }
+
+        FThreadRing& GetThreadRing()
+        {
+            thread_local FThreadRing* Ring = CreateThreadRing();
+            return *Ring;
+        }
+
+        void EncodeObject(const UObject* Object, uint32& OutName, int32& OutNumber)
+        {
+            const FName Name = Object ? Object->GetFName() : FName();
+            OutName = Name.GetDisplayIndex().ToUnstableInt();
+            OutNumber = Name.GetNumber();
+        }
+
+        /** Copies the complete records of a ring, oldest first. Records the writer overwrote during the copy are dropped. */
+        void SnapshotRing(const FThreadRing& Ring, TArray<FRecord>& OutRecords)
+        {
+            const uint64 Capacity = uint64(Ring.Mask) + 1;
+            const uint64 End = Ring.WriteIndex.load(std::memory_order_acquire);
+            const uint64 Begin = End > Capacity ? End - Capacity : 0;
+
+            OutRecords.SetNumUninitialized(int32(End - Begin));
+            for (uint64 Index = Begin; Index < End; ++Index)
+            {
+                OutRecords[int32(Index - Begin)] = Ring.Records[Index & Ring.Mask];
+            }
+
+            // keep the plain record copies above from being reordered past the validation load on weakly ordered CPUs
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            // the record being written after EndAfter overwrites the slot of EndAfter + 1 - Capacity
+            const uint64 EndAfter = Ring.WriteIndex.load(std::memory_order_acquire);
+            const uint64 FirstIntact = EndAfter + 1 > Capacity ? EndAfter + 1 - Capacity : 0;
+
+            if (FirstIntact > Begin)
+            {
+                OutRecords.RemoveAt(0, int32(FMath::Min(FirstIntact, End) - Begin), EAllowShrinking::No);
+            }
+        }
+
+        enum class EValueKind : uint8
+        {
+            None,
+            Float,
+            Flag,
+            MovementMode,
+            EndPlayReason
+        };
+
+        struct FEventFormat
+        {
+            const TCHAR* Name;
+            const TCHAR* ValueNames[4];
+            EValueKind ValueKinds[4];
+        };
+
+        const FEventFormat EventFormats[] = {
+            { TEXT("WellSpawn"), { TEXT("X"), TEXT("Y"), TEXT("Z"), TEXT("Radius") }, { EValueKind::Float, EValueKind::Float, EValueKind::Float, EValueKind::Float } },
+            { TEXT("WellDespawn"), { TEXT("Reason") }, { EValueKind::EndPlayReason, EValueKind::None, EValueKind::None, EValueKind::None } },
+            { TEXT("WellActivate"), { TEXT("X"), TEXT("Y"), TEXT("Z") }, { EValueKind::Float, EValueKind::Float, EValueKind::Float, EValueKind::None } },
+            { TEXT("WellDeactivate"), {}, { EValueKind::None, EValueKind::None, EValueKind::None, EValueKind::None } },
+            { TEXT("CharacterEnter"), { TEXT("StoredGravity"), TEXT("StoredMode"), TEXT("HadState") }, { EValueKind::Float, EValueKind::MovementMode, EValueKind::Flag, EValueKind::None } },
+            { TEXT("CharacterExit"), { TEXT("RestoredGravity"), TEXT("RestoredMode"), TEXT("HadState") }, { EValueKind::Float, EValueKind::MovementMode, EValueKind::Flag, EValueKind::None } },
+            { TEXT("ProjectileFire"), { TEXT("X"), TEXT("Y"), TEXT("Z") }, { EValueKind::Float, EValueKind::Float, EValueKind::Float, EValueKind::None } },
+            { TEXT("Damage"), { TEXT("Damage"), TEXT("HP") }, { EValueKind::Float, EValueKind::Float, EValueKind::None, EValueKind::None } },
+            { TEXT("Death"), { TEXT("X"), TEXT("Y"), TEXT("Z") }, { EValueKind::Float, EValueKind::Float, EValueKind::Float, EValueKind::None } },
+        };
+        static_assert(UE_ARRAY_COUNT(EventFormats) == int32(EEvent::Num), "Every event needs a decoder format");
+
+        FString FormatValue(EValueKind Kind, float Value)
+        {
+            switch (Kind)
+            {
+            case EValueKind::Flag:
+                return Value != 0.f ? TEXT("true") : TEXT("false");
+            case EValueKind::MovementMode:
+                return StaticEnum<EMovementMode>()->GetNameStringByValue(int64(Value));
+            case EValueKind::EndPlayReason:
+                return StaticEnum<EEndPlayReason::Type>()->GetNameStringByValue(int64(Value));
+            default:
+                return FString::Printf(TEXT("%.2f"), Value);
+            }
+        }
+
+        FString FormatObject(const TMap<uint32, FString>& Names, uint32 NameId, int32 Number)
+        {
+            const FString* Name = Names.Find(NameId);
+            if (!Name || *Name == TEXT("None"))
+            {
+                return TEXT("-");
+            }
+
+            return Number != NAME_NO_NUMBER_INTERNAL ? FString::Printf(TEXT("%s_%d"), **Name, NAME_INTERNAL_TO_EXTERNAL(Number)) : *Name;
+        }
+
+        /** Set while the calling thread is dumping, so an ensure raised by the dump itself doesn't recurse. */
+        thread_local bool bDumping = false;
+
+        std::atomic<uint64> GLastEnsureDumpCycles{0};
+
+        void HandleSystemEnsure()
+        {
+            if (!GDumpOnEnsure || bDumping)
+            {
+                return;
+            }
+
+            const uint64 Now = FPlatformTime::Cycles64();
+            uint64 LastDump = GLastEnsureDumpCycles.load(std::memory_order_relaxed);
+
+            if (LastDump != 0 && FPlatformTime::ToSeconds64(Now - LastDump) < KMinEnsureDumpIntervalSeconds)
+            {
+                return;
+            }
+
+            if (GLastEnsureDumpCycles.compare_exchange_strong(LastDump, Now))
+            {
+                Dump(TEXT("Ensure"));
+            }
+        }
+
+        /** Writes crash dump data straight to a platform file handle, in the layout FArchive gives the regular dump. */
+        struct FCrashDumpWriter
+        {
+            IFileHandle& File;
+
+            template <typename T>
+            void Write(const T& Value)
+            {
+                File.Write(reinterpret_cast<const uint8*>(&Value), sizeof(T));
+            }
+
+            /** Writes a string as an ANSI FString. Characters outside of ANSI are replaced, as converting them would allocate. */
+            void WriteString(const TCHAR* String)
+            {
+                const int32 Len = FCString::Strlen(String);
+                Write(Len > 0 ? Len + 1 : 0);
+
+                ANSICHAR Chunk[256];
+                for (int32 Start = 0; Start < Len; Start += UE_ARRAY_COUNT(Chunk))
+                {
+                    const int32 ChunkLen = FMath::Min(Len - Start, int32(UE_ARRAY_COUNT(Chunk)));
+                    for (int32 Index = 0; Index < ChunkLen; ++Index)
+                    {
+                        const TCHAR Char = String[Start + Index];
+                        Chunk[Index] = Char < 128 ? ANSICHAR(Char) : '?';
+                    }
+
+                    File.Write(reinterpret_cast<const uint8*>(Chunk), ChunkLen);
+                }
+
+                if (Len > 0)
+                {
+                    Write(ANSICHAR(0));
+                }
+            }
+        };
+
+        /** Same file as Dump, but written from the buffers and path prepared at startup, without allocating. */
+        void DumpForCrash()
+        {
+            TUniquePtr<IFileHandle> File(FPlatformFileManager::Get().GetPlatformFile().OpenWrite(*GCrashDump.FilePath));
+            if (!File)
+            {
+                return;
+            }
+
+            FCrashDumpWriter Writer{ *File };
+
+            int32 NumRings = 0;
+            for (FThreadRing* Ring = GRings.load(std::memory_order_acquire); Ring; Ring = Ring->Next)
+            {
+                ++NumRings;
+            }
+
+            Writer.Write(KFileMagic);
+            Writer.Write(KFileVersion);
+            Writer.Write(FPlatformTime::GetSecondsPerCycle64());
+            Writer.Write(FPlatformTime::Cycles64());
+            Writer.Write(uint32(GFrameCounter));
+            Writer.WriteString(TEXT("Crash"));
+            Writer.Write(NumRings);
+
+            TArray<FRecord>& Records = GCrashDump.Records;
+            TArray<uint32>& NameIds = GCrashDump.NameIds;
+            NameIds.Reset();
+
+            FThreadRing* Ring = GRings.load(std::memory_order_acquire);
+            for (int32 RingIndex = 0; RingIndex < NumRings; ++RingIndex, Ring = Ring->Next)
+            {
+                SnapshotRing(*Ring, Records);
+
+                // the reserved space is never exceeded, so collecting names doesn't allocate
+                for (const FRecord& Entry : Records)
+                {
+                    if (NameIds.Num() + 2 <= NameIds.Max())
+                    {
+                        NameIds.Add(Entry.ObjectName);
+                        NameIds.Add(Entry.OtherName);
+                    }
+                }
+
+                Writer.Write(Ring->ThreadId);
+                Writer.WriteString(*Ring->ThreadName);
+                Writer.Write(Records.Num());
+                File->Write(reinterpret_cast<const uint8*>(Records.GetData()), int64(Records.Num()) * sizeof(FRecord));
+            }
+
+            // dedupe in place
+            Algo::Sort(NameIds);
+
+            int32 NumNames = 0;
+            for (int32 Index = 0; Index < NameIds.Num(); ++Index)
+            {
+                if (NumNames == 0 || NameIds[NumNames - 1] != NameIds[Index])
+                {
+                    NameIds[NumNames++] = NameIds[Index];
+                }
+            }
+
+            Writer.Write(NumNames);
+
+            for (int32 Index = 0; Index < NumNames; ++Index)
+            {
+                TCHAR Name[NAME_SIZE];
+                FName::GetEntry(FNameEntryId::FromUnstableInt(NameIds[Index]))->GetName(Name);
+
+                Writer.Write(NameIds[Index]);
+                Writer.WriteString(Name);
+            }
+
+            File->Flush();
+        }
+
+        void HandleSystemError()
+        {
+            if (!bDumping)
+            {
+                TGuardValue<bool> DumpingGuard(bDumping, true);
+                DumpForCrash();
+            }
+        }
+
+        FDelayedAutoRegisterHelper RegisterErrorHandlers(EDelayedRegisterRunPhase::EndOfEngineInit, []
+        {
+            LLM_SCOPE_BYTAG(Gravity);
+
+            const FString Directory = FPaths::ConvertRelativePathToFull(FPaths::ProjectSavedDir() / TEXT("FlightRecorder"));
+            FPlatformFileManager::Get().GetPlatformFile().CreateDirectoryTree(*Directory);
+
+            GCrashDump.FilePath = Directory / FString::Printf(TEXT("FlightRecorder-%s-Crash.gfr"), *FDateTime::Now().ToString());
+            GCrashDump.Records.Reserve(GetRingCapacity());
+            GCrashDump.NameIds.Reserve(KMaxCrashDumpNames);
+
+            FCoreDelegates::OnHandleSystemEnsure.AddStatic(&HandleSystemEnsure);
+            FCoreDelegates::OnHandleSystemError.AddStatic(&HandleSystemError);
+        });
+
+        /** Decodes a dump into a text file next to it. */
+        void WriteDecodedText(const FString& FilePath)
+        {
+            FString Text;
+            if (!DecodeToText(FilePath, Text))
+            {
+                UE_LOG(LogGravity_test, Warning, TEXT("Flight recorder: could not decode %s."), *FilePath);
+                return;
+            }
+
+            const FString TextPath = FPaths::ChangeExtension(FilePath, TEXT("txt"));
+            if (FFileHelper::SaveStringToFile(Text, *TextPath))
+            {
+                UE_LOG(LogGravity_test, Display, TEXT("Flight recorder: decoded to %s."), *TextPath);
+            }
+        }
+
+        FAutoConsoleCommand DumpCommand(
+            TEXT("Gravity.FlightRecorder.Dump"),
+            TEXT("Dumps the flight recorder to Saved/FlightRecorder together with its decoded text. Usage: Gravity.FlightRecorder.Dump [Reason]"),
+            FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+            {
+                const FString FilePath = Dump(Args.Num() > 0 ? *Args[0] : TEXT("Manual"));
+                if (!FilePath.IsEmpty())
+                {
+                    WriteDecodedText(FilePath);
+                }
+            }));
+
+        FAutoConsoleCommand DecodeCommand(
+            TEXT("Gravity.FlightRecorder.Decode"),
+            TEXT("Decodes a flight recorder dump into a text file next to it. Usage: Gravity.FlightRecorder.Decode <file.gfr>"),
+            FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+            {
+                if (Args.Num() > 0)
+                {
+                    WriteDecodedText(Args[0]);
+                }
+            }));
+    }
+
+    void Record(EEvent Event, const UObject* Object, const UObject* Other, float Value0, float Value1, float Value2, float Value3)
+    {
+        if (!GEnabled)
+        {
+            return;
+        }
+
+        FThreadRing& Ring = GetThreadRing();
+        const uint64 Index = Ring.WriteIndex.load(std::memory_order_relaxed);
+
+        FRecord& Entry = Ring.Records[Index & Ring.Mask];
+        Entry.Cycles = FPlatformTime::Cycles64();
+        Entry.Frame = uint32(GFrameCounter);
+        Entry.Event = uint8(Event);
+        EncodeObject(Object, Entry.ObjectName, Entry.ObjectNumber);
+        EncodeObject(Other, Entry.OtherName, Entry.OtherNumber);
+        Entry.Values[0] = Value0;
+        Entry.Values[1] = Value1;
+        Entry.Values[2] = Value2;
+        Entry.Values[3] = Value3;
+
+        Ring.WriteIndex.store(Index + 1, std::memory_order_release);
+    }
+
+    FString Dump(const TCHAR* Reason)
+    {
+        TGuardValue<bool> DumpingGuard(bDumping, true);
+
+        const FString FilePath = FPaths::ProjectSavedDir() / TEXT("FlightRecorder")
+            / FString::Printf(TEXT("FlightRecorder-%s-%s.gfr"), *FDateTime::Now().ToString(), Reason);
+
+        TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*FilePath));
+        if (!Writer)
+        {
+            UE_LOG(LogGravity_test, Error, TEXT("Flight recorder: could not write %s."), *FilePath);
+            return FString();
+        }
+
+        uint32 Magic = KFileMagic;
+        uint32 Version = KFileVersion;
+        double SecondsPerCycle = FPlatformTime::GetSecondsPerCycle64();
+        uint64 DumpCycles = FPlatformTime::Cycles64();
+        uint32 DumpFrame = uint32(GFrameCounter);
+        FString DumpReason = Reason;
+
+        int32 NumRings = 0;
+        for (FThreadRing* Ring = GRings.load(std::memory_order_acquire); Ring; Ring = Ring->Next)
+        {
+            ++NumRings;
+        }
+
+        *Writer << Magic << Version << SecondsPerCycle << DumpCycles << DumpFrame << DumpReason << NumRings;
+
+        TSet<uint32> NameIds;
+        TArray<FRecord> Records;
+        int32 NumRecords = 0;
+
+        // rings are only ever pushed at the head, so walking from the head seen above visits exactly NumRings of them
+        FThreadRing* Ring = GRings.load(std::memory_order_acquire);
+        for (int32 RingIndex = 0; RingIndex < NumRings; ++RingIndex, Ring = Ring->Next)
+        {
+            SnapshotRing(*Ring, Records);
+
+            for (const FRecord& Entry : Records)
+            {
+                NameIds.Add(Entry.ObjectName);
+                NameIds.Add(Entry.OtherName);
+            }
+
+            uint32 ThreadId = Ring->ThreadId;
+            int32 RingRecords = Records.Num();
+            *Writer << ThreadId << Ring->ThreadName << RingRecords;
+            Writer->Serialize(Records.GetData(), int64(RingRecords) * sizeof(FRecord));
+
+            NumRecords += RingRecords;
+        }
+
+        int32 NumNames = NameIds.Num();
+        *Writer << NumNames;
+
+        for (uint32 NameId : NameIds)
+        {
+            FString Name = FName::CreateFromDisplayId(FNameEntryId::FromUnstableInt(NameId), NAME_NO_NUMBER_INTERNAL).ToString();
+            *Writer << NameId << Name;
+        }
+
+        if (!Writer->Close())
+        {
+            UE_LOG(LogGravity_test, Error, TEXT("Flight recorder: could not write %s."), *FilePath);
+            return FString();
+        }
+
+        UE_LOG(LogGravity_test, Display, TEXT("Flight recorder: dumped %d records from %d threads to %s."), NumRecords, NumRings, *FilePath);
+        return FilePath;
+    }
+
+    bool DecodeToText(const FString& FilePath, FString& OutText)
+    {
+        TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*FilePath));
+        if (!Reader)
+        {
+            return false;
+        }
+
+        uint32 Magic = 0;
+        uint32 Version = 0;
+        double SecondsPerCycle = 0.0;
+        uint64 DumpCycles = 0;
+        uint32 DumpFrame = 0;
+        FString DumpReason;
+        int32 NumRings = 0;
+
+        *Reader << Magic << Version << SecondsPerCycle << DumpCycles << DumpFrame << DumpReason << NumRings;
+
+        if (Reader->IsError() || Magic != KFileMagic || Version != KFileVersion || NumRings < 0)
+        {
+            return false;
+        }
+
+        struct FDecodedRecord
+        {
+            FRecord Record;
+            int32 ThreadIndex = 0;
+        };
+
+        TArray<FString> ThreadNames;
+        TArray<FDecodedRecord> Records;
+
+        for (int32 RingIndex = 0; RingIndex < NumRings; ++RingIndex)
+        {
+            uint32 ThreadId = 0;
+            FString ThreadName;
+            int32 RingRecords = 0;
+            *Reader << ThreadId << ThreadName << RingRecords;
+
+            if (Reader->IsError() || RingRecords < 0 || RingRecords > KMaxRecordsPerThread)
+            {
+                return false;
+            }
+
+            TArray<FRecord> RingData;
+            RingData.SetNumUninitialized(RingRecords);
+            Reader->Serialize(RingData.GetData(), int64(RingRecords) * sizeof(FRecord));
+
+            const int32 ThreadIndex = ThreadNames.Add(ThreadName);
+            for (const FRecord& Entry : RingData)
+            {
+                Records.Add({ Entry, ThreadIndex });
+            }
+        }
+
+        int32 NumNames = 0;
+        *Reader << NumNames;
+
+        if (Reader->IsError() || NumNames < 0)
+        {
+            return false;
+        }
+
+        TMap<uint32, FString> Names;
+        for (int32 NameIndex = 0; NameIndex < NumNames; ++NameIndex)
+        {
+            uint32 NameId = 0;
+            FString Name;
+            *Reader << NameId << Name;
+            Names.Add(NameId, MoveTemp(Name));
+        }
+
+        if (Reader->IsError())
+        {
+            return false;
+        }
+
+        Records.StableSort([](const FDecodedRecord& A, const FDecodedRecord& B) { return A.Record.Cycles < B.Record.Cycles; });
+
+        OutText = FString::Printf(TEXT("Flight recorder dump (%s) at frame %u: %d records from %d threads. Times are relative to the dump.\n"),
+            *DumpReason, DumpFrame, Records.Num(), NumRings);
+
+        for (const FDecodedRecord& Decoded : Records)
+        {
+            const FRecord& Entry = Decoded.Record;
+            const double Seconds = (double(Entry.Cycles) - double(DumpCycles)) * SecondsPerCycle;
+
+            if (Entry.Event >= uint8(EEvent::Num))
+            {
+                OutText += FString::Printf(TEXT("%+12.6fs frame %-8u unknown event %u\n"), Seconds, Entry.Frame, Entry.Event);
+                continue;
+            }
+
+            const FEventFormat& Format = EventFormats[Entry.Event];
+
+            OutText += FString::Printf(TEXT("%+12.6fs frame %-8u %-12s %-15s %s -> %s"), Seconds, Entry.Frame, *ThreadNames[Decoded.ThreadIndex], Format.Name,
+                *FormatObject(Names, Entry.ObjectName, Entry.ObjectNumber), *FormatObject(Names, Entry.OtherName, Entry.OtherNumber));
+
+            for (int32 ValueIndex = 0; ValueIndex < UE_ARRAY_COUNT(Entry.Values); ++ValueIndex)
+            {
+                if (Format.ValueKinds[ValueIndex] != EValueKind::None)
+                {
+                    OutText += FString::Printf(TEXT(" %s=%s"), Format.ValueNames[ValueIndex], *FormatValue(Format.ValueKinds[ValueIndex], Entry.Values[ValueIndex]));
+                }
+            }
+
+            OutText += TEXT("\n");
+        }
+
+        return true;
+    }
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Always-on flight recorder for gravity and combat events.
+ *
+ * Every thread that records gets its own fixed size ring of compact binary records, written without locks,
+ * so recording costs a few stores and the oldest history is simply overwritten. The rings are dumped to
+ * Saved/FlightRecorder on crash, on ensure and with Gravity.FlightRecorder.Dump, and decoded to text with
+ * Gravity.FlightRecorder.Decode or -run=GravityFlightRecorder -In=<file.gfr>. The crash dump is written from a buffer and
+ * file path prepared at startup, so it doesn't allocate inside the crash handler.
+ */
+namespace GravityFlightRecorder
+{
+    enum class EEvent : uint8
+    {
+        /** Object: well. Other: owner. Values: location X, Y, Z, radius. */
+        WellSpawn,
+        /** Object: well. Values: end play reason. */
+        WellDespawn,
+        /** Object: gravity well projectile. Other: well. Values: location X, Y, Z. */
+        WellActivate,
+        /** Object: gravity well projectile. Other: well. */
+        WellDeactivate,
+        /** Object: character. Other: well. Values: stored gravity scale, stored movement mode, previous state found. */
+        CharacterEnter,
+        /** Object: character. Other: well. Values: restored gravity scale, restored movement mode, stored state found. */
+        CharacterExit,
+        /** Object: projectile. Other: instigator. Values: location X, Y, Z. */
+        ProjectileFire,
+        /** Object: damaged actor. Other: damage causer. Values: damage, remaining HP. */
+        Damage,
+        /** Object: dead actor. Values: location X, Y, Z. */
+        Death,
+
+        Num
+    };
+
+    /** One recorded event. Objects are stored as name ids, which stay valid for the lifetime of the process. */
+    struct FRecord
+    {
+        uint64 Cycles = 0;
+        uint32 Frame = 0;
+        uint8 Event = 0;
+        uint8 Padding[3] = {};
+        uint32 ObjectName = 0;
+        int32 ObjectNumber = 0;
+        uint32 OtherName = 0;
+        int32 OtherNumber = 0;
+        float Values[4] = {};
+    };
+
+    /** Records an event on the calling thread's ring. Safe to call from any thread. */
+    GRAVITY_TEST_API void Record(EEvent Event, const UObject* Object, const UObject* Other, float Value0 = 0.f, float Value1 = 0.f, float Value2 = 0.f, float Value3 = 0.f);
+
+    inline void Record(EEvent Event, const UObject* Object, const UObject* Other, const FVector& Location, float Value3 = 0.f)
+    {
+        Record(Event, Object, Other, float(Location.X), float(Location.Y), float(Location.Z), Value3);
+    }
+
+    /** Writes every ring to a new .gfr file and returns its path, or an empty string if the file couldn't be written. */
+    GRAVITY_TEST_API FString Dump(const TCHAR* Reason);
+
+    /** Decodes a .gfr file into a time ordered text listing. Returns false if the file is missing or malformed. */
+    GRAVITY_TEST_API bool DecodeToText(const FString& FilePath, FString& OutText);
+}
@@ -0,0 +1,54 @@
+#include "GravityFlightRecorderCommandlet.h"
+
+#include "GravityFlightRecorder.h"
+#include "Gravity_test.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+
+UGravityFlightRecorderCommandlet::UGravityFlightRecorderCommandlet()
+{
+    IsClient = false;
+    IsEditor = false;
+    IsServer = false;
+    LogToConsole = true;
+}
+
+int32 UGravityFlightRecorderCommandlet::Main(const FString& Params)
+{
+    FString InPath;
+    if (!FParse::Value(*Params, TEXT("In="), InPath))
+    {
+        UE_LOG(LogGravity_test, Error, TEXT("GravityFlightRecorder: missing -In=<dump file>."));
+        return 1;
+    }
+
+    FString Text;
+    if (!GravityFlightRecorder::DecodeToText(InPath, Text))
+    {
+        UE_LOG(LogGravity_test, Error, TEXT("GravityFlightRecorder: %s is missing or isn't a flight recorder dump."), *InPath);
+        return 1;
+    }
+
+    FString OutPath;
+    if (!FParse::Value(*Params, TEXT("Out="), OutPath))
+    {
+        TArray<FString> Lines;
+        Text.ParseIntoArrayLines(Lines);
+
+        for (const FString& Line : Lines)
+        {
+            UE_LOG(LogGravity_test, Display, TEXT("%s"), *Line);
+        }
+
+        return 0;
+    }
+
+    if (!FFileHelper::SaveStringToFile(Text, *OutPath))
+    {
+        UE_LOG(LogGravity_test, Error, TEXT("GravityFlightRecorder: could not write %s."), *OutPath);
+        return 1;
+    }
+
+    UE_LOG(LogGravity_test, Display, TEXT("GravityFlightRecorder: decoded %s to %s."), *InPath, *OutPath);
+    return 0;
+}
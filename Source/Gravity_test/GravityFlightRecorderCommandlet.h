@@ -0,0 +1,21 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "GravityFlightRecorderCommandlet.generated.h"
+
+/**
+ * Decodes a flight recorder dump into text.
+ * Usage: -run=GravityFlightRecorder -In=Path.gfr [-Out=Path.txt]
+ * Without -Out the decoded events are written to the log.
+ */
+UCLASS()
+class GRAVITY_TEST_API UGravityFlightRecorderCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UGravityFlightRecorderCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,95 @@
+#include "GravityKernelBenchmarkCommandlet.h"
+
+#include "GravityKernelBenchmark.h"
+#include "Gravity_test.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+
+namespace
+{
+    /** Parses a comma separated list of positive counts, keeping the defaults if the switch is missing. */
+    void ParseCounts(const FString& Params, const TCHAR* Switch, TArray<int32>& OutCounts)
+    {
+        FString Value;
+        if (!FParse::Value(*Params, Switch, Value, false))
+        {
+            return;
+        }
+
+        TArray<FString> Tokens;
+        Value.ParseIntoArray(Tokens, TEXT(","));
+
+        OutCounts.Reset();
+        for (const FString& Token : Tokens)
+        {
+            const int32 Count = FCString::Atoi(*Token);
+            if (Count > 0)
+            {
+                OutCounts.Add(Count);
+            }
+        }
+    }
+}
+
+UGravityKernelBenchmarkCommandlet::UGravityKernelBenchmarkCommandlet()
+{
+    IsClient = false;
+    IsEditor = false;
+    IsServer = false;
+    LogToConsole = true;
+}
+
+int32 UGravityKernelBenchmarkCommandlet::Main(const FString& Params)
+{
+    FGravityKernelBenchmarkSettings Settings;
+    ParseCounts(Params, TEXT("Wells="), Settings.WellCounts);
+    ParseCounts(Params, TEXT("Bodies="), Settings.BodyCounts);
+    FParse::Value(*Params, TEXT("Iterations="), Settings.Iterations);
+    FParse::Value(*Params, TEXT("Seed="), Settings.Seed);
+    FParse::Value(*Params, TEXT("CellSize="), Settings.CacheCellSize);
+
+    FString Falloff;
+    if (FParse::Value(*Params, TEXT("Falloff="), Falloff))
+    {
+        if (Falloff == TEXT("Linear"))
+        {
+            Settings.Falloff = EGravityFalloff::Linear;
+        }
+        else if (Falloff == TEXT("Constant"))
+        {
+            Settings.Falloff = EGravityFalloff::Constant;
+        }
+        else if (Falloff != TEXT("InverseSquare"))
+        {
+            UE_LOG(LogGravity_test, Error, TEXT("GravityKernelBenchmark: unknown falloff %s."), *Falloff);
+            return 1;
+        }
+    }
+
+    if (Settings.WellCounts.IsEmpty() || Settings.BodyCounts.IsEmpty())
+    {
+        UE_LOG(LogGravity_test, Error, TEXT("GravityKernelBenchmark: -Wells= and -Bodies= need at least one positive count."));
+        return 1;
+    }
+
+    const TArray<FGravityKernelBenchmarkResult> Results = GravityCore::RunKernelBenchmarks(Settings);
+
+    TStringBuilder<4096> Csv;
+    Csv << TEXT("Kernel,Wells,Bodies,MedianMs,NsPerItem,MaxError\n");
+
+    UE_LOG(LogGravity_test, Display, TEXT("%-12s %6s %8s %10s %10s %10s"), TEXT("Kernel"), TEXT("Wells"), TEXT("Bodies"), TEXT("Median ms"), TEXT("ns/item"), TEXT("Max error"));
+    for (const FGravityKernelBenchmarkResult& Result : Results)
+    {
+        UE_LOG(LogGravity_test, Display, TEXT("%-12s %6d %8d %10.3f %10.2f %10.4f"), *Result.Kernel, Result.NumWells, Result.NumBodies, Result.MedianMs, Result.NsPerItem, Result.MaxError);
+        Csv.Appendf(TEXT("%s,%d,%d,%.4f,%.3f,%.5f\n"), *Result.Kernel, Result.NumWells, Result.NumBodies, Result.MedianMs, Result.NsPerItem, Result.MaxError);
+    }
+
+    FString CsvPath;
+    if (FParse::Value(*Params, TEXT("Csv="), CsvPath) && !FFileHelper::SaveStringToFile(Csv.ToView(), *CsvPath))
+    {
+        UE_LOG(LogGravity_test, Error, TEXT("GravityKernelBenchmark: could not write %s."), *CsvPath);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "GravityKernelBenchmarkCommandlet.generated.h"
+
+/**
+ * Microbenchmarks the GravityCore field kernels without loading a world.
+ * Usage: -run=GravityKernelBenchmark [-Wells=1,8,64] [-Bodies=256,4096,65536] [-Iterations=20] [-Seed=1337]
+ *        [-CellSize=200] [-Falloff=InverseSquare|Linear|Constant] [-Csv=Path]
+ */
+UCLASS()
+class GRAVITY_TEST_API UGravityKernelBenchmarkCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UGravityKernelBenchmarkCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
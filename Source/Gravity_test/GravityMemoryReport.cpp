@@ -0,0 +1,125 @@
+#include "GravityWellActor.h"
+#include "GravityWellSubsystem.h"
+#include "Gravity_test.h"
+#include "ShooterNPC.h"
+#include "ShooterProjectile.h"
+#include "ShooterWeapon.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+#include "Materials/MaterialInstanceDynamic.h"
+#include "NiagaraComponent.h"
+#include "UObject/UObjectIterator.h"
+
+namespace
+{
+    constexpr double KBytesToKB = 1.0 / 1024.0;
+
+    /** Returns the bytes tracked under an LLM tag, or a negative value if LLM isn't running. */
+    int64 GetLLMTagBytes(const TCHAR* TagName)
+    {
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+        if (FLowLevelMemTracker::IsEnabled())
+        {
+            return FLowLevelMemTracker::Get().GetTagAmountForTracker(ELLMTracker::Default, FName(TagName), ELLMTagSet::None);
+        }
+#endif
+        return -1;
+    }
+
+    /** Logs the instance count and estimated size of every actor of a class in the world. */
+    template <typename ActorType>
+    void ReportActors(UWorld* World, const TCHAR* Label, FOutputDevice& Ar)
+    {
+        int32 Count = 0;
+        int64 Bytes = 0;
+
+        for (TActorIterator<ActorType> It(World); It; ++It)
+        {
+            ++Count;
+            Bytes += It->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
+        }
+
+        Ar.Logf(TEXT("  %-20s %6d instances %10.1f KB"), Label, Count, Bytes * KBytesToKB);
+    }
+
+    void ReportMemory(const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+    {
+        if (!World)
+        {
+            return;
+        }
+
+        Ar.Logf(TEXT("LLM tags:"));
+
+        static const TCHAR* const TagNames[] = {
+            TEXT("Gravity"), TEXT("Gravity/Wells"), TEXT("Gravity/Field"),
+            TEXT("Shooter"), TEXT("Shooter/Projectiles"), TEXT("Shooter/Weapons"), TEXT("Shooter/AI") };
+
+        for (const TCHAR* TagName : TagNames)
+        {
+            const int64 Bytes = GetLLMTagBytes(TagName);
+            if (Bytes < 0)
+            {
+                Ar.Logf(TEXT("  LLM is off. Run with -llm to track bytes per tag."));
+                break;
+            }
+
+            Ar.Logf(TEXT("  %-20s %10.1f KB"), TagName, Bytes * KBytesToKB);
+        }
+
+        Ar.Logf(TEXT("Actors (estimated resource size):"));
+        ReportActors<AGravityWellActor>(World, TEXT("Wells"), Ar);
+        ReportActors<AShooterProjectile>(World, TEXT("Projectiles"), Ar);
+        ReportActors<AShooterWeapon>(World, TEXT("Weapons"), Ar);
+        ReportActors<AShooterNPC>(World, TEXT("NPCs"), Ar);
+
+        // per well state
+        int32 NumTrackedBodies = 0;
+        int32 NumAffectedCharacters = 0;
+        for (TActorIterator<AGravityWellActor> It(World); It; ++It)
+        {
+            NumTrackedBodies += It->GetNumTrackedBodies();
+            NumAffectedCharacters += It->GetNumAffectedCharacters();
+        }
+
+        int32 NumWellMIDs = 0;
+        int32 NumMIDs = 0;
+        for (TObjectIterator<UMaterialInstanceDynamic> It; It; ++It)
+        {
+            if (It->GetWorld() == World)
+            {
+                ++NumMIDs;
+                NumWellMIDs += It->GetTypedOuter<AGravityWellActor>() != nullptr;
+            }
+        }
+
+        int32 NumNiagara = 0;
+        int32 NumActiveNiagara = 0;
+        int32 NumWellNiagara = 0;
+        for (TObjectIterator<UNiagaraComponent> It; It; ++It)
+        {
+            if (It->GetWorld() == World)
+            {
+                ++NumNiagara;
+                NumActiveNiagara += It->IsActive();
+                NumWellNiagara += Cast<AGravityWellActor>(It->GetOwner()) != nullptr;
+            }
+        }
+
+        Ar.Logf(TEXT("Gravity:"));
+        Ar.Logf(TEXT("  %-20s %6d bodies, %d characters"), TEXT("Tracked"), NumTrackedBodies, NumAffectedCharacters);
+        Ar.Logf(TEXT("  %-20s %6d, %d owned by wells"), TEXT("Dynamic materials"), NumMIDs, NumWellMIDs);
+        Ar.Logf(TEXT("  %-20s %6d, %d active, %d owned by wells"), TEXT("Niagara components"), NumNiagara, NumActiveNiagara, NumWellNiagara);
+
+        if (const UGravityWellSubsystem* GravitySubsystem = World->GetSubsystem<UGravityWellSubsystem>())
+        {
+            Ar.Logf(TEXT("  %-20s %6d cells %10.1f KB"), TEXT("Well subsystem"), GravitySubsystem->GetNumFieldCells(), GravitySubsystem->GetAllocatedSize() * KBytesToKB);
+        }
+    }
+
+    FAutoConsoleCommandWithWorldArgsAndOutputDevice MemReportCommand(
+        TEXT("Gravity.MemReport"),
+        TEXT("Dumps LLM bytes per gameplay tag and instance counts of wells, projectiles, weapons, NPCs, their materials and VFX."),
+        FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateStatic(&ReportMemory));
+}
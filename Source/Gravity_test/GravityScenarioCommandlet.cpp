@@ -0,0 +1,117 @@
+#include "GravityScenarioCommandlet.h"
+
+#include "GravityScenario.h"
+#include "Gravity_test.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+
+UGravityScenarioCommandlet::UGravityScenarioCommandlet()
+{
+    IsClient = false;
+    IsEditor = false;
+    IsServer = false;
+    LogToConsole = true;
+}
+
+int32 UGravityScenarioCommandlet::Main(const FString& Params)
+{
+    FString ScenarioPath;
+    if (!FParse::Value(*Params, TEXT("Scenario="), ScenarioPath))
+    {
+        UE_LOG(LogGravity_test, Error, TEXT("GravityScenario: missing -Scenario=<json file>."));
+        return 1;
+    }
+
+    FString Json;
+    if (!FFileHelper::LoadFileToString(Json, *ScenarioPath))
+    {
+        UE_LOG(LogGravity_test, Error, TEXT("GravityScenario: could not read %s."), *ScenarioPath);
+        return 1;
+    }
+
+    FGravityScenario Scenario;
+    FString ParseError;
+    if (!GravityScenario::LoadFromJson(Json, Scenario, ParseError))
+    {
+        UE_LOG(LogGravity_test, Error, TEXT("GravityScenario: %s: %s."), *ScenarioPath, *ParseError);
+        return 1;
+    }
+
+    FParse::Value(*Params, TEXT("Steps="), Scenario.NumSteps);
+    Scenario.NumSteps = FMath::Max(Scenario.NumSteps, 0);
+
+    FString KernelName;
+    EGravityScenarioKernel Kernel = EGravityScenarioKernel::Reference;
+    if (FParse::Value(*Params, TEXT("Kernel="), KernelName) && KernelName == TEXT("Simd"))
+    {
+        Kernel = EGravityScenarioKernel::Simd;
+    }
+
+    FGravityTrajectory Trajectory;
+
+    const uint64 StartCycle = FPlatformTime::Cycles64();
+    GravityScenario::Simulate(Scenario, Kernel, Trajectory);
+    const double SimulationMs = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycle);
+
+    const int64 BodySteps = int64(Scenario.Bodies.Num()) * Scenario.NumSteps;
+    UE_LOG(LogGravity_test, Display, TEXT("GravityScenario: %d wells, %d bodies, %d steps with the %s kernel in %.2fms, %.1fns per body step."),
+        Scenario.Wells.Num(), Scenario.Bodies.Num(), Scenario.NumSteps, Kernel == EGravityScenarioKernel::Simd ? TEXT("Simd") : TEXT("Reference"),
+        SimulationMs, BodySteps > 0 ? SimulationMs * 1.0e6 / BodySteps : 0.0);
+
+    FString OutPath;
+    if (FParse::Value(*Params, TEXT("Out="), OutPath))
+    {
+        const bool bCsv = FPaths::GetExtension(OutPath).Equals(TEXT("csv"), ESearchCase::IgnoreCase);
+        if (!(bCsv ? Trajectory.SaveCsv(*OutPath) : Trajectory.SaveBinary(*OutPath)))
+        {
+            UE_LOG(LogGravity_test, Error, TEXT("GravityScenario: could not write %s."), *OutPath);
+            return 1;
+        }
+    }
+
+    FString GoldenPath;
+    if (!FParse::Value(*Params, TEXT("Golden="), GoldenPath))
+    {
+        return 0;
+    }
+
+    if (FParse::Param(*Params, TEXT("UpdateGolden")))
+    {
+        if (!Trajectory.SaveBinary(*GoldenPath))
+        {
+            UE_LOG(LogGravity_test, Error, TEXT("GravityScenario: could not write %s."), *GoldenPath);
+            return 1;
+        }
+
+        UE_LOG(LogGravity_test, Display, TEXT("GravityScenario: updated golden %s."), *GoldenPath);
+        return 0;
+    }
+
+    FGravityTrajectory Golden;
+    if (!Golden.LoadBinary(*GoldenPath))
+    {
+        UE_LOG(LogGravity_test, Error, TEXT("GravityScenario: %s is missing or not a trajectory file."), *GoldenPath);
+        return 1;
+    }
+
+    float Tolerance = 0.5f;
+    FParse::Value(*Params, TEXT("Tolerance="), Tolerance);
+
+    const FGravityTrajectoryDiff Diff = GravityScenario::Diff(Trajectory, Golden, Tolerance);
+    if (!Diff.Error.IsEmpty())
+    {
+        UE_LOG(LogGravity_test, Error, TEXT("GravityScenario: can't diff against %s, %s."), *GoldenPath, *Diff.Error);
+        return 1;
+    }
+
+    if (!Diff.IsMatching())
+    {
+        UE_LOG(LogGravity_test, Error, TEXT("GravityScenario: body %d drifts from %s at frame %d. Largest error %.3fcm on body %d at frame %d."),
+            Diff.FirstBody, *GoldenPath, Diff.FirstFrame, Diff.MaxError, Diff.MaxErrorBody, Diff.MaxErrorFrame);
+        return 1;
+    }
+
+    UE_LOG(LogGravity_test, Display, TEXT("GravityScenario: matches %s, largest error %.4fcm."), *GoldenPath, Diff.MaxError);
+    return 0;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "GravityScenarioCommandlet.generated.h"
+
+/**
+ * Simulates a gravity scenario file headless and records the body trajectories, optionally diffing them against a golden run.
+ * Usage: -run=GravityScenario -Scenario=Path.json [-Steps=600] [-Kernel=Reference|Simd] [-Out=Path.gtraj|Path.csv]
+ *        [-Golden=Path.gtraj [-Tolerance=0.5] [-UpdateGolden]]
+ * Returns non-zero if the scenario can't be loaded or the trajectories drift from the golden ones by more than the tolerance.
+ */
+UCLASS()
+class GRAVITY_TEST_API UGravityScenarioCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UGravityScenarioCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,470 @@
+#include "GravitySoakSubsystem.h"
+
+#include "GravityWellActor.h"
+#include "GravityWellProjectile.h"
+#include "GravityTestScene.h"
+#include "Gravity_test.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "HAL/LowLevelMemTracker.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/CommandLine.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "UObject/UObjectArray.h"
+#include "UObject/UObjectIterator.h"
+
+namespace
+{
+    /** Destroy paths a soak well can be retired through. */
+    enum ERetirePath : int32
+    {
+        /** The weapon's path: the projectile deactivates the well and destroys itself. */
+        Retire_Deactivate,
+
+        /** The projectile is destroyed while its well is active, so EndPlay has to clean up. */
+        Retire_DestroyProjectile,
+
+        /** The well is destroyed under the projectile first. */
+        Retire_DestroyWell,
+
+        /** The projectile never activates. */
+        Retire_NeverActivated,
+
+        Retire_Num
+    };
+
+    /** Frames between moving the characters and bodies around the arena. */
+    constexpr int32 KShuffleFrames = 30;
+
+    constexpr double KBytesToMB = 1.0 / (1024.0 * 1024.0);
+
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+    /** Returns the MB tracked under one of the project's LLM tags. */
+    double GetLLMTagMB(const TCHAR* TagName)
+    {
+        return FLowLevelMemTracker::Get().GetTagAmountForTracker(ELLMTracker::Default, FName(TagName), ELLMTagSet::None) * KBytesToMB;
+    }
+#endif
+
+    template <typename ActorType>
+    int32 CountLiveActors(const UWorld* World)
+    {
+        int32 Count = 0;
+        for (TObjectIterator<ActorType> It; It; ++It)
+        {
+            Count += It->GetWorld() == World;
+        }
+        return Count;
+    }
+
+    /** Least squares slope of Y over X. */
+    double GetSlope(TConstArrayView<double> X, TConstArrayView<double> Y)
+    {
+        const int32 Num = X.Num();
+        double MeanX = 0.0;
+        double MeanY = 0.0;
+        for (int32 Index = 0; Index < Num; ++Index)
+        {
+            MeanX += X[Index] / Num;
+            MeanY += Y[Index] / Num;
+        }
+
+        double Covariance = 0.0;
+        double Variance = 0.0;
+        for (int32 Index = 0; Index < Num; ++Index)
+        {
+            Covariance += (X[Index] - MeanX) * (Y[Index] - MeanY);
+            Variance += FMath::Square(X[Index] - MeanX);
+        }
+
+        return Variance > 0.0 ? Covariance / Variance : 0.0;
+    }
+}
+
+bool FGravitySoakSettings::ParseCommandLine(const TCHAR* CommandLine)
+{
+    if (!FParse::Param(CommandLine, TEXT("GravitySoak")))
+    {
+        return false;
+    }
+
+    FParse::Value(CommandLine, TEXT("Cycles="), Cycles);
+    FParse::Value(CommandLine, TEXT("LiveWells="), MaxLiveWells);
+    FParse::Value(CommandLine, TEXT("MinWellFrames="), MinWellFrames);
+    FParse::Value(CommandLine, TEXT("MaxWellFrames="), MaxWellFrames);
+    FParse::Value(CommandLine, TEXT("Characters="), NumCharacters);
+    FParse::Value(CommandLine, TEXT("Bodies="), NumBodies);
+    FParse::Value(CommandLine, TEXT("Arena="), ArenaSize);
+    FParse::Value(CommandLine, TEXT("SampleInterval="), SampleInterval);
+    FParse::Value(CommandLine, TEXT("WarmupCycles="), WarmupCycles);
+    FParse::Value(CommandLine, TEXT("MaxObjectGrowth="), MaxObjectGrowth);
+    FParse::Value(CommandLine, TEXT("MaxMemoryGrowthMB="), MaxMemoryGrowthMB);
+    FParse::Value(CommandLine, TEXT("Seed="), Seed);
+
+    if (!FParse::Value(CommandLine, TEXT("SoakCsv="), CsvPath))
+    {
+        CsvPath = FPaths::ProfilingDir() / TEXT("GravitySoak") / FString::Printf(TEXT("GravitySoak_%s.csv"), *FDateTime::Now().ToString());
+    }
+
+    Cycles = FMath::Max(Cycles, 1);
+    MaxLiveWells = FMath::Max(MaxLiveWells, 1);
+    MinWellFrames = FMath::Max(MinWellFrames, 1);
+    MaxWellFrames = FMath::Max(MaxWellFrames, MinWellFrames);
+    NumCharacters = FMath::Max(NumCharacters, 0);
+    NumBodies = FMath::Max(NumBodies, 0);
+    ArenaSize = FMath::Max(ArenaSize, 1000.f);
+    SampleInterval = FMath::Max(SampleInterval, 1);
+    WarmupCycles = FMath::Max(WarmupCycles, 0);
+
+    return true;
+}
+
+bool UGravitySoakSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+    return Super::ShouldCreateSubsystem(Outer) && FParse::Param(FCommandLine::Get(), TEXT("GravitySoak"));
+}
+
+bool UGravitySoakSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game;
+}
+
+void UGravitySoakSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+    Super::OnWorldBeginPlay(InWorld);
+
+    if (!Settings.ParseCommandLine(FCommandLine::Get()))
+    {
+        return;
+    }
+
+    UE_LOG(LogGravity_test, Display, TEXT("GravitySoak: %d cycles, %d live wells, %d characters, %d bodies."),
+        Settings.Cycles, Settings.MaxLiveWells, Settings.NumCharacters, Settings.NumBodies);
+
+    Random.Initialize(Settings.Seed);
+    SpawnScene(InWorld);
+
+    LiveWells.Reserve(Settings.MaxLiveWells);
+    Samples.Reserve(Settings.Cycles / Settings.SampleInterval + 2);
+
+    bRunning = true;
+}
+
+void UGravitySoakSubsystem::Deinitialize()
+{
+    if (bRunning)
+    {
+        UE_LOG(LogGravity_test, Error, TEXT("GravitySoak: world torn down after %d of %d cycles."), CyclesStarted, Settings.Cycles);
+        WriteResults();
+        Finish(1);
+    }
+
+    Super::Deinitialize();
+}
+
+void UGravitySoakSubsystem::Tick(float DeltaTime)
+{
+    if (!bRunning)
+    {
+        return;
+    }
+
+    ++FrameIndex;
+
+    if (FrameIndex % KShuffleFrames == 0)
+    {
+        ShuffleScene();
+    }
+
+    // retire wells that are due. Projectiles that died on their own, e.g. by lifetime, just drop out
+    for (int32 Index = LiveWells.Num() - 1; Index >= 0; --Index)
+    {
+        const FLiveWell& LiveWell = LiveWells[Index];
+        AGravityWellProjectile* Projectile = LiveWell.Projectile.Get();
+
+        if (Projectile && FrameIndex < LiveWell.RetireFrame)
+        {
+            continue;
+        }
+
+        RetireWell(Projectile, LiveWell.RetirePath);
+        LiveWells.RemoveAtSwap(Index, EAllowShrinking::No);
+    }
+
+    bool bSampleDue = false;
+    while (LiveWells.Num() < Settings.MaxLiveWells && CyclesStarted < Settings.Cycles)
+    {
+        SpawnWell();
+        bSampleDue |= ++CyclesStarted % Settings.SampleInterval == 0;
+    }
+
+    if (bSampleDue)
+    {
+        TakeSample();
+    }
+
+    if (CyclesStarted >= Settings.Cycles && LiveWells.IsEmpty())
+    {
+        const int32 ExitCode = Verify();
+        WriteResults();
+        Finish(ExitCode);
+    }
+}
+
+TStatId UGravitySoakSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UGravitySoakSubsystem, STATGROUP_Tickables);
+}
+
+void UGravitySoakSubsystem::SpawnScene(UWorld& InWorld)
+{
+    GravityTestScene::SpawnFloor(InWorld, Settings.ArenaSize);
+
+    for (int32 Index = 0; Index < Settings.NumCharacters; ++Index)
+    {
+        Characters.Add(GravityTestScene::SpawnIdleCharacter(InWorld, FVector(0.f, 0.f, 100.f)));
+    }
+
+    for (int32 Index = 0; Index < Settings.NumBodies; ++Index)
+    {
+        Bodies.Add(GravityTestScene::SpawnPhysicsBody(InWorld, FVector(0.f, 0.f, 200.f)));
+    }
+
+    ShuffleScene();
+}
+
+void UGravitySoakSubsystem::ShuffleScene()
+{
+    const float HalfArena = Settings.ArenaSize * 0.5f;
+
+    // teleport everything, so bodies keep entering and leaving wells without waiting for the physics to move them
+    for (const TWeakObjectPtr<ACharacter>& Character : Characters)
+    {
+        if (Character.IsValid())
+        {
+            Character->SetActorLocation(FVector(Random.FRandRange(-HalfArena, HalfArena), Random.FRandRange(-HalfArena, HalfArena), 100.f), false, nullptr, ETeleportType::TeleportPhysics);
+        }
+    }
+
+    for (const TWeakObjectPtr<UPrimitiveComponent>& Body : Bodies)
+    {
+        if (Body.IsValid())
+        {
+            Body->SetWorldLocation(FVector(Random.FRandRange(-HalfArena, HalfArena), Random.FRandRange(-HalfArena, HalfArena), Random.FRandRange(100.f, 600.f)), false, nullptr, ETeleportType::TeleportPhysics);
+            Body->SetPhysicsLinearVelocity(FVector::ZeroVector);
+        }
+    }
+}
+
+void UGravitySoakSubsystem::SpawnWell()
+{
+    const float HalfArena = Settings.ArenaSize * 0.5f;
+    const FTransform SpawnTransform(
+        FRotator(0.f, Random.FRandRange(0.f, 360.f), 0.f),
+        FVector(Random.FRandRange(-HalfArena, HalfArena), Random.FRandRange(-HalfArena, HalfArena), Random.FRandRange(100.f, 400.f)));
+
+    FActorSpawnParameters SpawnParams;
+    SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+    AGravityWellProjectile* Projectile = GetWorld()->SpawnActor<AGravityWellProjectile>(AGravityWellProjectile::StaticClass(), SpawnTransform, SpawnParams);
+    if (!Projectile)
+    {
+        return;
+    }
+
+    FLiveWell& LiveWell = LiveWells.AddDefaulted_GetRef();
+    LiveWell.Projectile = Projectile;
+    LiveWell.RetireFrame = FrameIndex + Random.RandRange(Settings.MinWellFrames, Settings.MaxWellFrames);
+    LiveWell.RetirePath = CyclesStarted % Retire_Num;
+
+    if (LiveWell.RetirePath != Retire_NeverActivated)
+    {
+        Projectile->ActivateBlackHole();
+    }
+}
+
+void UGravitySoakSubsystem::RetireWell(AGravityWellProjectile* Projectile, int32 RetirePath)
+{
+    if (!IsValid(Projectile))
+    {
+        return;
+    }
+
+    switch (RetirePath)
+    {
+    case Retire_DestroyProjectile:
+        Projectile->Destroy();
+        break;
+
+    case Retire_DestroyWell:
+    {
+        TArray<AActor*> AttachedActors;
+        Projectile->GetAttachedActors(AttachedActors);
+
+        for (AActor* Attached : AttachedActors)
+        {
+            if (Cast<AGravityWellActor>(Attached))
+            {
+                Attached->Destroy();
+            }
+        }
+
+        Projectile->Destroy();
+        break;
+    }
+
+    case Retire_Deactivate:
+    case Retire_NeverActivated:
+    default:
+        Projectile->DeactivateBlackHole();
+        break;
+    }
+}
+
+void UGravitySoakSubsystem::TakeSample()
+{
+    CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+
+    const FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+
+    FSoakSample& Sample = Samples.AddDefaulted_GetRef();
+    Sample.Cycle = CyclesStarted;
+    Sample.LiveObjects = GUObjectArray.GetObjectArrayNumMinusAvailable();
+    Sample.LiveWells = CountLiveActors<AGravityWellActor>(GetWorld());
+    Sample.LiveProjectiles = CountLiveActors<AGravityWellProjectile>(GetWorld());
+    Sample.UsedPhysicalMB = MemoryStats.UsedPhysical * KBytesToMB;
+
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+    if (FLowLevelMemTracker::IsEnabled())
+    {
+        Sample.LLMTrackedMB = FLowLevelMemTracker::Get().GetTagAmountForTracker(ELLMTracker::Default, ELLMTag::TrackedTotal) * KBytesToMB;
+        Sample.LLMUObjectMB = FLowLevelMemTracker::Get().GetTagAmountForTracker(ELLMTracker::Default, ELLMTag::UObject) * KBytesToMB;
+        Sample.LLMGravityMB = GetLLMTagMB(TEXT("Gravity"));
+        Sample.LLMShooterMB = GetLLMTagMB(TEXT("Shooter"));
+    }
+#endif
+
+    if (Samples.Num() > 1)
+    {
+        const FSoakSample& Previous = Samples[Samples.Num() - 2];
+        const int32 Cycles = FMath::Max(Sample.Cycle - Previous.Cycle, 1);
+        Sample.ResidentBytesPerCycle = (Sample.UsedPhysicalMB - Previous.UsedPhysicalMB) / KBytesToMB / Cycles;
+    }
+
+    UE_LOG(LogGravity_test, Display, TEXT("GravitySoak: cycle %d, %d objects, %d wells, %d projectiles, %.1fMB used, %+.1f resident bytes per cycle, LLM Gravity %.2fMB, Shooter %.2fMB."),
+        Sample.Cycle, Sample.LiveObjects, Sample.LiveWells, Sample.LiveProjectiles, Sample.UsedPhysicalMB, Sample.ResidentBytesPerCycle,
+        Sample.LLMGravityMB, Sample.LLMShooterMB);
+}
+
+int32 UGravitySoakSubsystem::Verify()
+{
+    int32 ExitCode = 0;
+
+    // growth trend over the measured samples, before the final cleanup drops everything
+    TArray<double> SampleCycles;
+    TArray<double> SampleObjects;
+    TArray<double> SampleMemory;
+    TArray<double> SampleProjectMemory;
+
+    for (const FSoakSample& Sample : Samples)
+    {
+        if (Sample.Cycle >= Settings.WarmupCycles)
+        {
+            SampleCycles.Add(Sample.Cycle);
+            SampleObjects.Add(Sample.LiveObjects);
+            SampleMemory.Add(Sample.UsedPhysicalMB);
+            SampleProjectMemory.Add(Sample.LLMGravityMB + Sample.LLMShooterMB);
+        }
+    }
+
+    if (SampleCycles.Num() >= 3)
+    {
+        const double MeasuredCycles = SampleCycles.Last() - SampleCycles[0];
+        const double ObjectGrowth = GetSlope(SampleCycles, SampleObjects) * MeasuredCycles;
+        const double MemoryGrowthMB = GetSlope(SampleCycles, SampleMemory) * MeasuredCycles;
+
+        // the project tags only see our own allocations, so they catch leaks the resident set hides in allocator slack
+        const double ProjectGrowthMB = GetSlope(SampleCycles, SampleProjectMemory) * MeasuredCycles;
+
+        UE_LOG(LogGravity_test, Display, TEXT("GravitySoak: over %.0f measured cycles, objects trend %+.1f, resident memory %+.2fMB and LLM Gravity+Shooter %+.2fMB."),
+            MeasuredCycles, ObjectGrowth, MemoryGrowthMB, ProjectGrowthMB);
+
+        if (ObjectGrowth > Settings.MaxObjectGrowth)
+        {
+            UE_LOG(LogGravity_test, Error, TEXT("GravitySoak: live objects grow by %.1f, more than the allowed %d."), ObjectGrowth, Settings.MaxObjectGrowth);
+            ExitCode = 1;
+        }
+
+        if (MemoryGrowthMB > Settings.MaxMemoryGrowthMB)
+        {
+            UE_LOG(LogGravity_test, Error, TEXT("GravitySoak: resident memory grows by %.2fMB, more than the allowed %.2fMB."), MemoryGrowthMB, Settings.MaxMemoryGrowthMB);
+            ExitCode = 1;
+        }
+
+        if (ProjectGrowthMB > Settings.MaxMemoryGrowthMB)
+        {
+            UE_LOG(LogGravity_test, Error, TEXT("GravitySoak: LLM Gravity+Shooter memory grows by %.2fMB, more than the allowed %.2fMB."), ProjectGrowthMB, Settings.MaxMemoryGrowthMB);
+            ExitCode = 1;
+        }
+    }
+    else
+    {
+        UE_LOG(LogGravity_test, Warning, TEXT("GravitySoak: not enough samples after warmup to check growth. Run more cycles or lower -SampleInterval."));
+    }
+
+    // every well is retired by now, so nothing may be left alive
+    TakeSample();
+
+    const FSoakSample& Final = Samples.Last();
+    if (Final.LiveWells > 0 || Final.LiveProjectiles > 0)
+    {
+        UE_LOG(LogGravity_test, Error, TEXT("GravitySoak: %d wells and %d projectiles outlived the run."), Final.LiveWells, Final.LiveProjectiles);
+        ExitCode = 1;
+    }
+
+    for (const TWeakObjectPtr<ACharacter>& Character : Characters)
+    {
+        const UCharacterMovementComponent* MoveComp = Character.IsValid() ? Character->GetCharacterMovement() : nullptr;
+
+        if (MoveComp && (MoveComp->MovementMode == MOVE_Flying || MoveComp->GravityScale != 1.f))
+        {
+            UE_LOG(LogGravity_test, Error, TEXT("GravitySoak: %s was left in movement mode %d with gravity scale %.2f."),
+                *Character->GetName(), int32(MoveComp->MovementMode), MoveComp->GravityScale);
+            ExitCode = 1;
+        }
+    }
+
+    return ExitCode;
+}
+
+void UGravitySoakSubsystem::WriteResults() const
+{
+    TStringBuilder<16 * 1024> Csv;
+    Csv << TEXT("Cycle,LiveObjects,LiveWells,LiveProjectiles,UsedPhysicalMB,LLMTrackedMB,LLMUObjectMB,LLMGravityMB,LLMShooterMB,ResidentBytesPerCycle\n");
+
+    for (const FSoakSample& Sample : Samples)
+    {
+        Csv.Appendf(TEXT("%d,%d,%d,%d,%.3f,%.3f,%.3f,%.3f,%.3f,%.2f\n"), Sample.Cycle, Sample.LiveObjects, Sample.LiveWells, Sample.LiveProjectiles,
+            Sample.UsedPhysicalMB, Sample.LLMTrackedMB, Sample.LLMUObjectMB, Sample.LLMGravityMB, Sample.LLMShooterMB, Sample.ResidentBytesPerCycle);
+    }
+
+    if (!FFileHelper::SaveStringToFile(Csv.ToView(), *Settings.CsvPath))
+    {
+        UE_LOG(LogGravity_test, Error, TEXT("GravitySoak: could not write %s."), *Settings.CsvPath);
+        return;
+    }
+
+    UE_LOG(LogGravity_test, Display, TEXT("GravitySoak: wrote %d samples to %s."), Samples.Num(), *Settings.CsvPath);
+}
+
+void UGravitySoakSubsystem::Finish(int32 ExitCode)
+{
+    bRunning = false;
+    UE_LOG(LogGravity_test, Display, TEXT("GravitySoak: %s after %d cycles."), ExitCode == 0 ? TEXT("passed") : TEXT("failed"), CyclesStarted);
+    FPlatformMisc::RequestExitWithStatus(false, ExitCode);
+}
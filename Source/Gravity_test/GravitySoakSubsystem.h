@@ -0,0 +1,128 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GravitySoakSubsystem.generated.h"
+
+class ACharacter;
+class AGravityWellProjectile;
+class UPrimitiveComponent;
+
+/** Soak run settings, parsed from the command line. */
+struct FGravitySoakSettings
+{
+    /** Wells to spawn and retire over the whole run. */
+    int32 Cycles = 200000;
+
+    /** Wells alive at the same time. */
+    int32 MaxLiveWells = 64;
+
+    /** Frames a well stays active, picked at random per well. */
+    int32 MinWellFrames = 2;
+    int32 MaxWellFrames = 4;
+
+    int32 NumCharacters = 16;
+    int32 NumBodies = 64;
+
+    /** Edge length of the square arena, in cm. Small, so wells keep catching characters and bodies. */
+    float ArenaSize = 6000.f;
+
+    /** Cycles between samples. Each sample runs a full garbage collection first. */
+    int32 SampleInterval = 5000;
+
+    /** Cycles before the growth baseline is taken, so pools, caches and allocator bins can fill up. */
+    int32 WarmupCycles = 10000;
+
+    /** Fails the run if live UObjects, resident memory or the project's LLM tags trend upwards by more than this over the measured cycles. */
+    int32 MaxObjectGrowth = 256;
+    float MaxMemoryGrowthMB = 32.f;
+
+    int32 Seed = 1337;
+
+    /** Output CSV path. Defaults to Saved/Profiling/GravitySoak. */
+    FString CsvPath;
+
+    /** Returns false if the command line doesn't ask for a soak run. */
+    bool ParseCommandLine(const TCHAR* CommandLine);
+};
+
+/**
+ * Spawn/destroy soak test for gravity wells.
+ *
+ * Activated by -GravitySoak on a game run, e.g.:
+ *   Gravity_test /Engine/Maps/Entry -game -nullrhi -nosound -unattended -GravitySoak -Cycles=500000 -SoakCsv=soak.csv
+ *
+ * Keeps firing gravity well projectiles into an arena of characters and physics bodies that keep moving in and out of range,
+ * retiring them through every destroy path (deactivation, projectile destroyed, well destroyed, never activated).
+ * Periodically collects garbage and samples live UObjects, live wells and projectiles, process memory and LLM totals,
+ * including the project's Gravity and Shooter tags when run with -llm.
+ * Exits non-zero if objects or memory trend upwards, wells or projectiles outlive the run, or a character is left without gravity.
+ */
+UCLASS()
+class GRAVITY_TEST_API UGravitySoakSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+    virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+    virtual void Deinitialize() override;
+
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+private:
+    /** A well projectile the soak spawned and still has to retire. */
+    struct FLiveWell
+    {
+        TWeakObjectPtr<AGravityWellProjectile> Projectile;
+        int32 RetireFrame = 0;
+
+        /** Which destroy path retires it. */
+        int32 RetirePath = 0;
+    };
+
+    struct FSoakSample
+    {
+        int32 Cycle = 0;
+        int32 LiveObjects = 0;
+        int32 LiveWells = 0;
+        int32 LiveProjectiles = 0;
+        double UsedPhysicalMB = 0.0;
+        double LLMTrackedMB = 0.0;
+        double LLMUObjectMB = 0.0;
+
+        /** Memory under the project's LLM tags. Zero without -llm. */
+        double LLMGravityMB = 0.0;
+        double LLMShooterMB = 0.0;
+
+        /** Resident process memory change per cycle since the previous sample. A net delta, not an allocation count. */
+        double ResidentBytesPerCycle = 0.0;
+    };
+
+    void SpawnScene(UWorld& InWorld);
+    void ShuffleScene();
+    void SpawnWell();
+    static void RetireWell(AGravityWellProjectile* Projectile, int32 RetirePath);
+    void TakeSample();
+
+    /** Retires everything, checks nothing leaked and returns the exit code. */
+    int32 Verify();
+
+    void WriteResults() const;
+    void Finish(int32 ExitCode);
+
+    FGravitySoakSettings Settings;
+
+    FRandomStream Random;
+
+    TArray<FLiveWell> LiveWells;
+    TArray<TWeakObjectPtr<ACharacter>> Characters;
+    TArray<TWeakObjectPtr<UPrimitiveComponent>> Bodies;
+    TArray<FSoakSample> Samples;
+
+    int32 CyclesStarted = 0;
+    int32 FrameIndex = 0;
+    bool bRunning = false;
+};
@@ -0,0 +1,102 @@
+#include "GravityStats.h"
+
+#include "GameFramework/Actor.h"
+
+DEFINE_STAT(STAT_GravityWellStep);
+DEFINE_STAT(STAT_GravityWellQuery);
+DEFINE_STAT(STAT_GravityFieldRebuild);
+
+DEFINE_STAT(STAT_GravityWells);
+DEFINE_STAT(STAT_GravityWellSteps);
+DEFINE_STAT(STAT_GravityTrackedBodies);
+DEFINE_STAT(STAT_GravityCharacters);
+DEFINE_STAT(STAT_GravityForcesApplied);
+
+DEFINE_STAT(STAT_FrameScratchPeak);
+DEFINE_STAT(STAT_PooledOverlapBuffers);
+
+DEFINE_STAT(STAT_GravityGovernorTier);
+DEFINE_STAT(STAT_GravityGovernorLoad);
+
+CSV_DEFINE_CATEGORY_MODULE(GRAVITY_TEST_API, Gravity, true);
+
+UE_TRACE_CHANNEL_DEFINE(GravityChannel);
+
+UE_TRACE_EVENT_BEGIN(Gravity, WellBegin)
+    UE_TRACE_EVENT_FIELD(uint64, Cycle)
+    UE_TRACE_EVENT_FIELD(uint32, WellId)
+    UE_TRACE_EVENT_FIELD(float, Radius)
+    UE_TRACE_EVENT_FIELD(UE::Trace::WideString, Name)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(Gravity, WellEnd)
+    UE_TRACE_EVENT_FIELD(uint64, Cycle)
+    UE_TRACE_EVENT_FIELD(uint32, WellId)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(Gravity, WellStep)
+    UE_TRACE_EVENT_FIELD(uint64, StartCycle)
+    UE_TRACE_EVENT_FIELD(uint64, EndCycle)
+    UE_TRACE_EVENT_FIELD(uint32, WellId)
+    UE_TRACE_EVENT_FIELD(uint32, NumBodies)
+    UE_TRACE_EVENT_FIELD(uint32, NumForces)
+UE_TRACE_EVENT_END()
+
+namespace GravityStats
+{
+    FFrameCounters& GetFrameCounters()
+    {
+        check(IsInGameThread());
+        static FFrameCounters Counters;
+        return Counters;
+    }
+
+    FFrameCounters ConsumeFrameCounters()
+    {
+        FFrameCounters& Counters = GetFrameCounters();
+        const FFrameCounters Consumed = Counters;
+        Counters = FFrameCounters();
+        return Consumed;
+    }
+}
+
+namespace GravityTrace
+{
+    void OutputWellBegin(const AActor* Well, float Radius)
+    {
+        if (!UE_TRACE_CHANNELEXPR_IS_ENABLED(GravityChannel) || !Well)
+        {
+            return;
+        }
+
+        const FString Name = Well->GetName();
+
+        UE_TRACE_LOG(Gravity, WellBegin, GravityChannel)
+            << WellBegin.Cycle(FPlatformTime::Cycles64())
+            << WellBegin.WellId(Well->GetUniqueID())
+            << WellBegin.Radius(Radius)
+            << WellBegin.Name(*Name, Name.Len());
+    }
+
+    void OutputWellEnd(const AActor* Well)
+    {
+        if (!Well)
+        {
+            return;
+        }
+
+        UE_TRACE_LOG(Gravity, WellEnd, GravityChannel)
+            << WellEnd.Cycle(FPlatformTime::Cycles64())
+            << WellEnd.WellId(Well->GetUniqueID());
+    }
+
+    void OutputWellStep(const AActor* Well, uint64 StartCycle, uint64 EndCycle, int32 NumBodies, int32 NumForces)
+    {
+        UE_TRACE_LOG(Gravity, WellStep, GravityChannel)
+            << WellStep.StartCycle(StartCycle)
+            << WellStep.EndCycle(EndCycle)
+            << WellStep.WellId(Well->GetUniqueID())
+            << WellStep.NumBodies(uint32(NumBodies))
+            << WellStep.NumForces(uint32(NumForces));
+    }
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "Trace/Trace.h"
+
+class AActor;
+
+/**
+ * Observability for the gravity simulation: `stat Gravity`, the Gravity CSV profiler category
+ * and the Gravity Insights trace channel (enable with -trace=default,gravity).
+ */
+
+DECLARE_STATS_GROUP(TEXT("Gravity"), STATGROUP_Gravity, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Well Step"), STAT_GravityWellStep, STATGROUP_Gravity, GRAVITY_TEST_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Well Overlap Query"), STAT_GravityWellQuery, STATGROUP_Gravity, GRAVITY_TEST_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Field Grid Rebuild"), STAT_GravityFieldRebuild, STATGROUP_Gravity, GRAVITY_TEST_API);
+
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Wells"), STAT_GravityWells, STATGROUP_Gravity, GRAVITY_TEST_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Well Steps"), STAT_GravityWellSteps, STATGROUP_Gravity, GRAVITY_TEST_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Tracked Bodies"), STAT_GravityTrackedBodies, STATGROUP_Gravity, GRAVITY_TEST_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Characters"), STAT_GravityCharacters, STATGROUP_Gravity, GRAVITY_TEST_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Forces Applied"), STAT_GravityForcesApplied, STATGROUP_Gravity, GRAVITY_TEST_API);
+
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Frame Scratch Peak"), STAT_FrameScratchPeak, STATGROUP_Gravity, GRAVITY_TEST_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Pooled Overlap Buffers"), STAT_PooledOverlapBuffers, STATGROUP_Gravity, GRAVITY_TEST_API);
+
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Governor Tier"), STAT_GravityGovernorTier, STATGROUP_Gravity, GRAVITY_TEST_API);
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Governor Load"), STAT_GravityGovernorLoad, STATGROUP_Gravity, GRAVITY_TEST_API);
+
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(GRAVITY_TEST_API, Gravity);
+
+UE_TRACE_CHANNEL_EXTERN(GravityChannel, GRAVITY_TEST_API);
+
+namespace GravityStats
+{
+    /**
+     * Gravity workload of the current frame. Unlike the stats above these are compiled into every build,
+     * so tools such as the benchmark driver can read them without a stats capture.
+     */
+    struct FFrameCounters
+    {
+        int32 WellSteps = 0;
+        int32 TrackedBodies = 0;
+        int32 Characters = 0;
+        int32 ForcesApplied = 0;
+        uint64 WellStepCycles = 0;
+    };
+
+    /** Returns the counters of the current frame. Game thread only. */
+    GRAVITY_TEST_API FFrameCounters& GetFrameCounters();
+
+    /** Returns the counters gathered since the last call and starts a new frame. Game thread only. */
+    GRAVITY_TEST_API FFrameCounters ConsumeFrameCounters();
+}
+
+namespace GravityTrace
+{
+    /** Emits a well lifecycle event on the Gravity trace channel. */
+    GRAVITY_TEST_API void OutputWellBegin(const AActor* Well, float Radius);
+    GRAVITY_TEST_API void OutputWellEnd(const AActor* Well);
+
+    /** Emits the timing and workload of one well step on the Gravity trace channel. */
+    GRAVITY_TEST_API void OutputWellStep(const AActor* Well, uint64 StartCycle, uint64 EndCycle, int32 NumBodies, int32 NumForces);
+}
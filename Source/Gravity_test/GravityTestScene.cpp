@@ -0,0 +1,72 @@
+#include "GravityTestScene.h"
+
+#include "Components/StaticMeshComponent.h"
+#include "Engine/CollisionProfile.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/CharacterMovementComponent.h"
+
+namespace
+{
+    FActorSpawnParameters MakeSpawnParams()
+    {
+        FActorSpawnParameters SpawnParams;
+        SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+        return SpawnParams;
+    }
+
+    AStaticMeshActor* SpawnMeshActor(UWorld& World, const FVector& Location, const TCHAR* MeshPath)
+    {
+        AStaticMeshActor* Actor = World.SpawnActor<AStaticMeshActor>(Location, FRotator::ZeroRotator, MakeSpawnParams());
+
+        if (Actor)
+        {
+            Actor->GetStaticMeshComponent()->SetMobility(EComponentMobility::Movable);
+            Actor->GetStaticMeshComponent()->SetStaticMesh(LoadObject<UStaticMesh>(nullptr, MeshPath));
+        }
+
+        return Actor;
+    }
+}
+
+AStaticMeshActor* GravityTestScene::SpawnFloor(UWorld& World, float ArenaSize)
+{
+    // the basic shapes are 100cm across
+    AStaticMeshActor* Floor = SpawnMeshActor(World, FVector(0.f, 0.f, -50.f), TEXT("/Engine/BasicShapes/Cube.Cube"));
+
+    if (Floor)
+    {
+        Floor->SetActorScale3D(FVector(ArenaSize / 100.f, ArenaSize / 100.f, 1.f));
+    }
+
+    return Floor;
+}
+
+UPrimitiveComponent* GravityTestScene::SpawnPhysicsBody(UWorld& World, const FVector& Location)
+{
+    AStaticMeshActor* Body = SpawnMeshActor(World, Location, TEXT("/Engine/BasicShapes/Sphere.Sphere"));
+    if (!Body)
+    {
+        return nullptr;
+    }
+
+    UStaticMeshComponent* BodyMesh = Body->GetStaticMeshComponent();
+    BodyMesh->SetWorldScale3D(FVector(0.5f));
+    BodyMesh->SetCollisionProfileName(UCollisionProfile::PhysicsActor_ProfileName);
+    BodyMesh->SetSimulatePhysics(true);
+    return BodyMesh;
+}
+
+ACharacter* GravityTestScene::SpawnIdleCharacter(UWorld& World, const FVector& Location)
+{
+    ACharacter* Character = World.SpawnActor<ACharacter>(ACharacter::StaticClass(), Location, FRotator::ZeroRotator, MakeSpawnParams());
+
+    if (Character)
+    {
+        Character->GetCharacterMovement()->bRunPhysicsWithNoController = true;
+    }
+
+    return Character;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UWorld;
+class ACharacter;
+class AStaticMeshActor;
+class UPrimitiveComponent;
+
+/** Building blocks of the procedural arenas the headless gravity benchmark and soak runs play in. */
+namespace GravityTestScene
+{
+    /** Spawns a square floor of the given edge length, top face at Z = 0. */
+    AStaticMeshActor* SpawnFloor(UWorld& World, float ArenaSize);
+
+    /** Spawns a simulating physics sphere and returns its body. */
+    UPrimitiveComponent* SpawnPhysicsBody(UWorld& World, const FVector& Location);
+
+    /** Spawns a character that runs movement without a controller, since nobody possesses it. */
+    ACharacter* SpawnIdleCharacter(UWorld& World, const FVector& Location);
+}
@@ -1,5 +1,14 @@
 #include "GravityWellActor.h"
 
+#include "GravityWellSubsystem.h"
+#include "GravityWellNavModifierComponent.h"
+#include "GravityStats.h"
+#include "GravityKernels.h"
+#include "FrameScratch.h"
+#include "GravityFlightRecorder.h"
+#include "PerformanceGovernorSubsystem.h"
+#include "ShooterLatencySubsystem.h"
+#include "Gravity_test.h"
 #include "Components/SceneComponent.h"
 #include "Components/SphereComponent.h"
 #include "Components/PrimitiveComponent.h"
@@ -15,6 +24,9 @@
 #include "CollisionShape.h"
 #include "WorldCollision.h"
 #include "Misc/Optional.h"
+#include "Algo/BinarySearch.h"
+#include "Algo/Sort.h"
+#include "Algo/Unique.h"
 #include "Materials/MaterialInstanceDynamic.h"
 #include "NiagaraComponent.h"
 #include "NiagaraSystem.h"
@@ -43,6 +55,7 @@ AGravityWellActor::AGravityWellActor()
     InfluenceSphere->SetCollisionResponseToChannel(ECC_PhysicsBody, ECR_Overlap);
     InfluenceSphere->SetGenerateOverlapEvents(true);
     InfluenceSphere->bHiddenInGame = true;
+    InfluenceSphere->SetCanEverAffectNavigation(false);
 
     VisualizationMesh = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("VisualizationMesh"));
     VisualizationMesh->SetupAttachment(SceneRoot);
@@ -63,6 +76,8 @@ AGravityWellActor::AGravityWellActor()
     AccretionVfxComponent->SetupAttachment(SceneRoot);
     AccretionVfxComponent->SetAutoActivate(false);
     AccretionVfxComponent->SetCanEverAffectNavigation(false);
+
+    NavModifier = CreateDefaultSubobject<UGravityWellNavModifierComponent>(TEXT("NavModifier"));
 }
 
 void AGravityWellActor::OnConstruction(const FTransform& Transform)
@@ -78,18 +93,52 @@ void AGravityWellActor::OnConstruction(const FTransform& Transform)
 
 void AGravityWellActor::BeginPlay()
 {
+    LLM_SCOPE_BYTAG(Gravity_Wells);
+
     Super::BeginPlay();
     UpdateSphereRadius();
+
+    // wells spawned mid-game start at the governor's current quality. It hands out the VFX budget on its next update
+    if (const UPerformanceGovernorSubsystem* Governor = GetWorld()->GetSubsystem<UPerformanceGovernorSubsystem>())
+    {
+        const FPerformanceTierSettings& TierSettings = Governor->GetTierSettings();
+        TickIntervalScale = TierSettings.WellTickIntervalScale;
+        MaxBodiesPerStep = TierSettings.MaxBodiesPerWell;
+        bAccretionVfxAllowed = Governor->GetTier() == EPerformanceTier::Full;
+    }
+
+    bAwaitingFirstForce = true;
     StartGravityTimer();
     PulseAccumulator = 0.f;
     RefreshVisualizationAssets();
     UpdateVisualizationActivation();
     UpdateVisualizationScale();
     UpdateVisualizationParameters(0.f);
+
+    GravityTrace::OutputWellBegin(this, InfluenceSphere->GetScaledSphereRadius());
+    GravityFlightRecorder::Record(GravityFlightRecorder::EEvent::WellSpawn, this, GetOwner(), GetWellLocation(), InfluenceSphere->GetScaledSphereRadius());
+
+    if (UGravityWellSubsystem* GravitySubsystem = GetWorld()->GetSubsystem<UGravityWellSubsystem>())
+    {
+        GravitySubsystem->RegisterWell(this);
+
+        if (bAffectNavigation)
+        {
+            GravitySubsystem->RequestNavModifierUpdate(NavModifier);
+        }
+    }
 }
 
 void AGravityWellActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
+    GravityTrace::OutputWellEnd(this);
+    GravityFlightRecorder::Record(GravityFlightRecorder::EEvent::WellDespawn, this, nullptr, float(EndPlayReason));
+
+    if (UGravityWellSubsystem* GravitySubsystem = GetWorld()->GetSubsystem<UGravityWellSubsystem>())
+    {
+        GravitySubsystem->UnregisterWell(this);
+    }
+
     if (AccretionVfxComponent)
     {
         AccretionVfxComponent->DeactivateImmediate();
@@ -112,10 +161,20 @@ void AGravityWellActor::PostEditChangeProperty(FPropertyChangedEvent& PropertyCh
 }
 #endif
 
+FVector AGravityWellActor::GetWellLocation() const
+{
+    return InfluenceSphere ? InfluenceSphere->GetComponentLocation() : GetActorLocation();
+}
+
 void AGravityWellActor::UpdateSphereRadius()
 {
     const float SafeRadius = FMath::Max(MaxRadius, 0.f);
     InfluenceSphere->SetSphereRadius(SafeRadius, true);
+
+    if (NavModifier)
+    {
+        NavModifier->SetRadii(MinRadius, SafeRadius);
+    }
 }
 
 void AGravityWellActor::StartGravityTimer()
@@ -126,7 +185,32 @@ void AGravityWellActor::StartGravityTimer()
     }
 
     GetWorldTimerManager().ClearTimer(GravityTimerHandle);
-    GetWorldTimerManager().SetTimer(GravityTimerHandle, this, &AGravityWellActor::ApplyGravityTick, TickInterval, true, 0.f);
+    GetWorldTimerManager().SetTimer(GravityTimerHandle, this, &AGravityWellActor::ApplyGravityTick, TickInterval * TickIntervalScale, true, 0.f);
+}
+
+void AGravityWellActor::SetPerformanceBudget(float InTickIntervalScale, int32 InMaxBodiesPerStep)
+{
+    MaxBodiesPerStep = InMaxBodiesPerStep;
+
+    if (TickIntervalScale != InTickIntervalScale)
+    {
+        TickIntervalScale = InTickIntervalScale;
+
+        // keep stepping at the new rate, without an extra step right away
+        if (GravityTimerHandle.IsValid())
+        {
+            GetWorldTimerManager().SetTimer(GravityTimerHandle, this, &AGravityWellActor::ApplyGravityTick, TickInterval * TickIntervalScale, true);
+        }
+    }
+}
+
+void AGravityWellActor::SetAccretionVfxAllowed(bool bAllowed)
+{
+    if (bAccretionVfxAllowed != bAllowed)
+    {
+        bAccretionVfxAllowed = bAllowed;
+        UpdateVisualizationActivation();
+    }
 }
 
 void AGravityWellActor::ApplyGravityTick()
@@ -136,6 +220,15 @@ void AGravityWellActor::ApplyGravityTick()
         return;
     }
 
+    SCOPE_CYCLE_COUNTER(STAT_GravityWellStep);
+    CSV_SCOPED_TIMING_STAT(Gravity, WellStep);
+    LLM_SCOPE_BYTAG(Gravity_Wells);
+    INC_DWORD_STAT(STAT_GravityWellSteps);
+
+    const uint64 StepStartCycle = FPlatformTime::Cycles64();
+    int32 NumForces = 0;
+    int32 NumBodiesPushed = 0;
+
     const FVector WellLocation = InfluenceSphere->GetComponentLocation();
     const float DeltaSeconds = FMath::Max(GravityTimerHandle.IsValid()
         ? GetWorldTimerManager().GetTimerRate(GravityTimerHandle)
@@ -145,11 +238,15 @@ void AGravityWellActor::ApplyGravityTick()
     UpdateVisualizationScale();
     UpdateVisualizationParameters(DeltaSeconds);
 
-    TSet<TWeakObjectPtr<ACharacter>> CurrentlyOverlappingCharacters;
-    TArray<UPrimitiveComponent*> OverlappingComponents;
+    // per step temporaries live on the frame scratch stack, so steady state steps don't hit the heap
+    FFrameScratchScope ScratchScope;
+    TFrameScratchArray<ACharacter*> CurrentlyOverlappingCharacters;
+    TFrameScratchArray<UPrimitiveComponent*> OverlappingComponents;
 
     if (UWorld* World = GetWorld())
     {
+        SCOPE_CYCLE_COUNTER(STAT_GravityWellQuery);
+
         FCollisionObjectQueryParams ObjectParams;
         ObjectParams.AddObjectTypesToQuery(ECC_Pawn);
         ObjectParams.AddObjectTypesToQuery(ECC_PhysicsBody);
@@ -162,20 +259,27 @@ void AGravityWellActor::ApplyGravityTick()
         const float SphereRadius = InfluenceSphere->GetScaledSphereRadius();
         const FCollisionShape SphereShape = FCollisionShape::MakeSphere(SphereRadius);
 
-        TArray<FOverlapResult> Overlaps;
+        FScopedOverlapBuffer OverlapBuffer;
+        TArray<FOverlapResult>& Overlaps = OverlapBuffer.Get();
         if (World->OverlapMultiByObjectType(Overlaps, WellLocation, FQuat::Identity, ObjectParams, SphereShape, QueryParams))
         {
+            OverlappingComponents.Reserve(Overlaps.Num());
+
             for (const FOverlapResult& Overlap : Overlaps)
             {
                 if (UPrimitiveComponent* Primitive = Overlap.Component.Get())
                 {
-                    OverlappingComponents.AddUnique(Primitive);
+                    OverlappingComponents.Add(Primitive);
                 }
             }
+
+            // components with several bodies overlap more than once. Sorting drops them in n log n instead of an AddUnique scan per result
+            Algo::Sort(OverlappingComponents);
+            OverlappingComponents.SetNum(Algo::Unique(OverlappingComponents), EAllowShrinking::No);
         }
     }
 
-    UE_LOG(LogGravityWell, Log, TEXT("%s ticking with %d overlapping components"), *GetName(), OverlappingComponents.Num());
+    UE_LOG(LogGravityWell, VeryVerbose, TEXT("%s ticking with %d overlapping components"), *GetName(), OverlappingComponents.Num());
 
     for (UPrimitiveComponent* Primitive : OverlappingComponents)
     {
@@ -194,14 +298,16 @@ void AGravityWellActor::ApplyGravityTick()
 
         if (!Accel.IsNearlyZero())
         {
-            if (bAffectRigidBodies && Primitive->IsSimulatingPhysics())
+            if (bAffectRigidBodies && NumBodiesPushed < MaxBodiesPerStep && Primitive->IsSimulatingPhysics())
             {
                 Primitive->WakeAllRigidBodies();
                 const float Mass = Primitive->GetMass();
                 if (Mass > KINDA_SMALL_NUMBER)
                 {
                     Primitive->AddForce(Accel * Mass, NAME_None, true);
-                    UE_LOG(LogGravityWell, Log, TEXT("Applied accel %s to %s (mass %.2f)"), *Accel.ToString(), *Primitive->GetName(), Mass);
+                    ++NumForces;
+                    ++NumBodiesPushed;
+                    UE_LOG(LogGravityWell, VeryVerbose, TEXT("Applied accel %s to %s (mass %.2f)"), *Accel.ToString(), *Primitive->GetName(), Mass);
                 }
             }
 
@@ -217,18 +323,23 @@ void AGravityWellActor::ApplyGravityTick()
                         {
                             if (UCharacterMovementComponent* MoveComp = Character->GetCharacterMovement())
                             {
-                                if (!FindCharacterState(Character))
+                                const FAffectedCharacterState* State = FindCharacterState(Character);
+                                const bool bHadState = State != nullptr;
+                                if (!State)
                                 {
                                     FAffectedCharacterState NewState;
                                     NewState.Character = Character;
                                     NewState.PreviousGravityScale = MoveComp->GravityScale;
                                     NewState.PreviousMovementMode = static_cast<uint8>(MoveComp->MovementMode);
-                                    CharacterStates.Add(NewState);
+                                    State = &CharacterStates.Add_GetRef(NewState);
                                 }
 
+                                GravityFlightRecorder::Record(GravityFlightRecorder::EEvent::CharacterEnter, Character, this,
+                                    State->PreviousGravityScale, float(State->PreviousMovementMode), bHadState ? 1.f : 0.f);
+
                                 MoveComp->GravityScale = 0.f;
                                 MoveComp->SetMovementMode(MOVE_Flying);
-                                UE_LOG(LogGravityWell, Log, TEXT("%s entering gravity well; stored gravity %.2f mode %d"), *Character->GetName(), MoveComp->GravityScale, MoveComp->MovementMode);
+                                UE_LOG(LogGravityWell, Verbose, TEXT("%s entering gravity well; stored gravity %.2f mode %d"), *Character->GetName(), MoveComp->GravityScale, MoveComp->MovementMode);
                             }
                             AffectedCharacters.Add(Character);
                         }
@@ -237,7 +348,8 @@ void AGravityWellActor::ApplyGravityTick()
                         {
                             MoveComp->Velocity += Accel * DeltaSeconds;
                             MoveComp->UpdateComponentVelocity();
-                            UE_LOG(LogGravityWell, Log, TEXT("Applied character accel %s to %s; new velocity %s"), *Accel.ToString(), *Character->GetName(), *MoveComp->Velocity.ToString());
+                            ++NumForces;
+                            UE_LOG(LogGravityWell, VeryVerbose, TEXT("Applied character accel %s to %s; new velocity %s"), *Accel.ToString(), *Character->GetName(), *MoveComp->Velocity.ToString());
                         }
                     }
                 }
@@ -245,16 +357,46 @@ void AGravityWellActor::ApplyGravityTick()
         }
     }
 
+    // a character overlaps once per component, so sort and dedupe before counting and searching
+    Algo::Sort(CurrentlyOverlappingCharacters);
+    CurrentlyOverlappingCharacters.SetNum(Algo::Unique(CurrentlyOverlappingCharacters), EAllowShrinking::No);
+
     // Restore gravity for characters no longer affected.
     for (auto It = AffectedCharacters.CreateIterator(); It; ++It)
     {
         TWeakObjectPtr<ACharacter>& CharacterPtr = *It;
-        if (!CharacterPtr.IsValid() || !CurrentlyOverlappingCharacters.Contains(CharacterPtr))
+        if (!CharacterPtr.IsValid() || Algo::BinarySearch(CurrentlyOverlappingCharacters, CharacterPtr.Get()) == INDEX_NONE)
         {
             RestoreCharacterGravity(CharacterPtr);
             It.RemoveCurrent();
         }
     }
+
+    NumTrackedBodies = OverlappingComponents.Num();
+
+    INC_DWORD_STAT_BY(STAT_GravityTrackedBodies, OverlappingComponents.Num());
+    INC_DWORD_STAT_BY(STAT_GravityCharacters, CurrentlyOverlappingCharacters.Num());
+    INC_DWORD_STAT_BY(STAT_GravityForcesApplied, NumForces);
+    CSV_CUSTOM_STAT(Gravity, TrackedBodies, OverlappingComponents.Num(), ECsvCustomStatOp::Accumulate);
+    CSV_CUSTOM_STAT(Gravity, ForcesApplied, NumForces, ECsvCustomStatOp::Accumulate);
+
+    const uint64 StepEndCycle = FPlatformTime::Cycles64();
+
+    GravityStats::FFrameCounters& FrameCounters = GravityStats::GetFrameCounters();
+    ++FrameCounters.WellSteps;
+    FrameCounters.TrackedBodies += OverlappingComponents.Num();
+    FrameCounters.Characters += CurrentlyOverlappingCharacters.Num();
+    FrameCounters.ForcesApplied += NumForces;
+    FrameCounters.WellStepCycles += StepEndCycle - StepStartCycle;
+
+    GravityTrace::OutputWellStep(this, StepStartCycle, StepEndCycle, OverlappingComponents.Num(), NumForces);
+
+    // report the activation latency of the projectile that spawned this well
+    if (bAwaitingFirstForce)
+    {
+        UShooterLatencySubsystem* Latency = GetWorld()->GetSubsystem<UShooterLatencySubsystem>();
+        bAwaitingFirstForce = Latency && Latency->MarkWellStep(GetOwner(), NumForces > 0);
+    }
 }
 
 void AGravityWellActor::RestoreCharacterGravity(TWeakObjectPtr<ACharacter> CharacterPtr)
@@ -271,13 +413,15 @@ void AGravityWellActor::RestoreCharacterGravity(TWeakObjectPtr<ACharacter> Chara
         {
             MoveComp->GravityScale = State->PreviousGravityScale;
             MoveComp->SetMovementMode(static_cast<EMovementMode>(State->PreviousMovementMode));
-            UE_LOG(LogGravityWell, Log, TEXT("%s exiting gravity well; restored gravity %.2f mode %d"), *CharacterPtr->GetName(), State->PreviousGravityScale, State->PreviousMovementMode);
+            GravityFlightRecorder::Record(GravityFlightRecorder::EEvent::CharacterExit, CharacterPtr.Get(), this, State->PreviousGravityScale, float(State->PreviousMovementMode), 1.f);
+            UE_LOG(LogGravityWell, Verbose, TEXT("%s exiting gravity well; restored gravity %.2f mode %d"), *CharacterPtr->GetName(), State->PreviousGravityScale, State->PreviousMovementMode);
         }
         else
         {
             MoveComp->GravityScale = 1.f;
             MoveComp->SetMovementMode(MOVE_Walking);
-            UE_LOG(LogGravityWell, Log, TEXT("%s exiting gravity well with default restore"), *CharacterPtr->GetName());
+            GravityFlightRecorder::Record(GravityFlightRecorder::EEvent::CharacterExit, CharacterPtr.Get(), this, 1.f, float(MOVE_Walking), 0.f);
+            UE_LOG(LogGravityWell, Verbose, TEXT("%s exiting gravity well with default restore"), *CharacterPtr->GetName());
         }
     }
 
@@ -296,29 +440,18 @@ void AGravityWellActor::RestoreAllCharacters()
 
 FVector AGravityWellActor::ComputeAcceleration(const FVector& WellLocation, const FVector& TargetLocation) const
 {
-    const FVector Delta = WellLocation - TargetLocation;
-    const float Distance = Delta.Size();
-
-    if (Distance > MaxRadius)
-    {
-        return FVector::ZeroVector;
-    }
-
-    if (Distance <= KINDA_SMALL_NUMBER)
-    {
-        return FVector::ZeroVector;
-    }
-
-    const float ClampedRadius = FMath::Max(Distance, MinRadius);
-    FVector Direction = Delta.GetSafeNormal();
-    if (Direction.IsNearlyZero())
-    {
-        return FVector::ZeroVector;
-    }
+    return GravityCore::ComputeAcceleration(MakeGravityWell(WellLocation), TargetLocation);
+}
 
-    const float AccelMagnitude = Strength / FMath::Max(ClampedRadius * ClampedRadius, 1.f);
-    FVector Accel = Direction * AccelMagnitude;
-    return Accel.GetClampedToMaxSize(MaxAccel);
+FGravityWell AGravityWellActor::MakeGravityWell(const FVector& WellLocation) const
+{
+    FGravityWell Well;
+    Well.Location = WellLocation;
+    Well.Strength = Strength;
+    Well.MinRadius = MinRadius;
+    Well.MaxRadius = MaxRadius;
+    Well.MaxAccel = MaxAccel;
+    return Well;
 }
 
 void AGravityWellActor::RefreshVisualizationAssets()
@@ -365,7 +498,7 @@ void AGravityWellActor::UpdateVisualizationActivation()
 
     if (AccretionVfxComponent)
     {
-        if (bEnableVisualization && AccretionNiagaraSystem)
+        if (bEnableVisualization && bAccretionVfxAllowed && AccretionNiagaraSystem)
         {
             if (!AccretionVfxComponent->IsActive())
             {
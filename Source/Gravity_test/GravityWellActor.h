@@ -12,8 +12,11 @@ class UMaterialInstanceDynamic;
 class UNiagaraComponent;
 class UNiagaraSystem;
 class ACharacter;
+class UGravityWellNavModifierComponent;
+struct FGravityWell;
 
-DECLARE_LOG_CATEGORY_EXTERN(LogGravityWell, Log, All);
+// Compiled up to Verbose, so the per-body VeryVerbose logs and their string formatting cost nothing in any build.
+DECLARE_LOG_CATEGORY_EXTERN(LogGravityWell, Log, Verbose);
 
 struct FAffectedCharacterState
 {
@@ -40,6 +43,31 @@ public:
     virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
 #endif
 
+    /** World location the well pulls towards. */
+    FVector GetWellLocation() const;
+
+    float GetMinRadius() const { return MinRadius; }
+    float GetMaxRadius() const { return MaxRadius; }
+
+    float GetStrength() const { return Strength; }
+
+    /** Sets the well strength, clamped to zero like the editor property. Use AWhiteHoleActor to push bodies away. */
+    void SetStrength(float InStrength) { Strength = FMath::Max(InStrength, 0.f); }
+
+    /** Bodies overlapping the well on its last gravity step. */
+    int32 GetNumTrackedBodies() const { return NumTrackedBodies; }
+
+    int32 GetNumAffectedCharacters() const { return AffectedCharacters.Num(); }
+
+    /** Returns the acceleration this well applies to a body at the given location. */
+    FVector SampleAcceleration(const FVector& TargetLocation) const { return ComputeAcceleration(GetWellLocation(), TargetLocation); }
+
+    /** Slows the gravity step down by a multiple of TickInterval and caps the rigid bodies pushed per step. Set by the performance governor. */
+    void SetPerformanceBudget(float InTickIntervalScale, int32 InMaxBodiesPerStep);
+
+    /** Lets the accretion VFX run or stops it. Set by the performance governor. */
+    void SetAccretionVfxAllowed(bool bAllowed);
+
 protected:
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
     TObjectPtr<USceneComponent> SceneRoot;
@@ -53,6 +81,9 @@ protected:
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components", meta = (AllowPrivateAccess = "true"))
     TObjectPtr<UNiagaraComponent> AccretionVfxComponent;
 
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components", meta = (AllowPrivateAccess = "true"))
+    TObjectPtr<UGravityWellNavModifierComponent> NavModifier;
+
     UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "GravityWell", meta = (ClampMin = "0.0"))
     float Strength = 3000000.f;
 
@@ -71,6 +102,10 @@ protected:
     UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "GravityWell")
     bool bAffectCharacters = true;
 
+    /** If true, the well publishes a high cost ring and a blocked core to the navmesh while active. */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "GravityWell")
+    bool bAffectNavigation = true;
+
     UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "GravityWell", meta = (ClampMin = "0.005"))
     float TickInterval = 0.03f;
 
@@ -104,6 +139,9 @@ protected:
     virtual FVector ComputeAcceleration(const FVector& WellLocation, const FVector& TargetLocation) const;
 
 private:
+    /** Describes this well to the GravityCore kernels. */
+    FGravityWell MakeGravityWell(const FVector& WellLocation) const;
+
     void UpdateSphereRadius();
     void StartGravityTimer();
     void ApplyGravityTick();
@@ -125,4 +163,14 @@ private:
     TObjectPtr<UMaterialInstanceDynamic> VisualizationMID;
 
     float PulseAccumulator = 0.f;
+
+    int32 NumTrackedBodies = 0;
+
+    /** Performance governor budgets. */
+    float TickIntervalScale = 1.f;
+    int32 MaxBodiesPerStep = MAX_int32;
+    bool bAccretionVfxAllowed = true;
+
+    /** True until the latency of the well's first applied force has been reported. */
+    bool bAwaitingFirstForce = false;
 };
@@ -0,0 +1,86 @@
+#include "GravityWellNavModifierComponent.h"
+
+#include "GravityWellActor.h"
+#include "NavArea_GravityWell.h"
+#include "NavAreas/NavArea_Null.h"
+#include "AI/NavigationModifier.h"
+#include "AI/Navigation/NavigationRelevantData.h"
+
+UGravityWellNavModifierComponent::UGravityWellNavModifierComponent(const FObjectInitializer& ObjectInitializer)
+    : Super(ObjectInitializer)
+{
+    RingAreaClass = UNavArea_GravityWellRing::StaticClass();
+    CoreAreaClass = UNavArea_Null::StaticClass();
+
+    // published later by the gravity well subsystem
+    bNavigationRelevant = false;
+    bAttachToOwnersRoot = false;
+}
+
+void UGravityWellNavModifierComponent::SetRadii(float InCoreRadius, float InRingRadius)
+{
+    const float NewCoreRadius = FMath::Max(InCoreRadius, 0.f);
+    const float NewRingRadius = FMath::Max(InRingRadius, NewCoreRadius);
+
+    if (FMath::IsNearlyEqual(NewCoreRadius, CoreRadius) && FMath::IsNearlyEqual(NewRingRadius, RingRadius))
+    {
+        return;
+    }
+
+    CoreRadius = NewCoreRadius;
+    RingRadius = NewRingRadius;
+
+    if (IsNavigationRelevant() && IsRegistered())
+    {
+        RefreshNavigationModifiers();
+    }
+}
+
+void UGravityWellNavModifierComponent::PublishModifiers()
+{
+    if (!IsRegistered() || RingRadius <= KINDA_SMALL_NUMBER)
+    {
+        return;
+    }
+
+    if (IsNavigationRelevant())
+    {
+        RefreshNavigationModifiers();
+    }
+    else
+    {
+        SetNavigationRelevancy(true);
+    }
+}
+
+FVector UGravityWellNavModifierComponent::GetModifierCenter() const
+{
+    if (const AGravityWellActor* Well = Cast<AGravityWellActor>(GetOwner()))
+    {
+        return Well->GetWellLocation();
+    }
+    return GetOwner() ? GetOwner()->GetActorLocation() : FVector::ZeroVector;
+}
+
+void UGravityWellNavModifierComponent::CalcAndCacheBounds() const
+{
+    Bounds = FBox::BuildAABB(GetModifierCenter(), FVector(RingRadius, RingRadius, HalfHeight));
+}
+
+void UGravityWellNavModifierComponent::GetNavigationData(FNavigationRelevantData& Data) const
+{
+    // cylinders are built upwards from their base
+    const FTransform BaseTransform(GetModifierCenter() - FVector(0.f, 0.f, HalfHeight));
+    const float Height = HalfHeight * 2.f;
+
+    if (RingAreaClass && RingRadius > CoreRadius)
+    {
+        Data.Modifiers.Add(FAreaNavModifier(RingRadius, Height, BaseTransform, RingAreaClass));
+    }
+
+    // the core goes last so it overrides the ring
+    if (CoreAreaClass && CoreRadius > KINDA_SMALL_NUMBER)
+    {
+        Data.Modifiers.Add(FAreaNavModifier(CoreRadius, Height, BaseTransform, CoreAreaClass));
+    }
+}
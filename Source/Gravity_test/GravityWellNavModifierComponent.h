@@ -0,0 +1,51 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "NavRelevantComponent.h"
+#include "GravityWellNavModifierComponent.generated.h"
+
+class UNavArea;
+
+/**
+ * Publishes a gravity well to the navmesh as a high cost ring around a blocked core.
+ * Starts out irrelevant to navigation; the gravity well subsystem publishes it once the well
+ * has been alive long enough, so short-lived wells never dirty the navmesh.
+ */
+UCLASS(ClassGroup = (Navigation), meta = (BlueprintSpawnableComponent))
+class GRAVITY_TEST_API UGravityWellNavModifierComponent : public UNavRelevantComponent
+{
+    GENERATED_BODY()
+
+public:
+    UGravityWellNavModifierComponent(const FObjectInitializer& ObjectInitializer);
+
+    /** Updates the modifier shape, refreshing the navmesh only if the modifiers are already published. */
+    void SetRadii(float InCoreRadius, float InRingRadius);
+
+    /** Makes the modifiers relevant to navigation, dirtying the navmesh tiles under them. */
+    void PublishModifiers();
+
+    bool AreModifiersPublished() const { return IsNavigationRelevant(); }
+
+    virtual void CalcAndCacheBounds() const override;
+    virtual void GetNavigationData(FNavigationRelevantData& Data) const override;
+
+protected:
+    /** Area applied between the core and the influence radius. */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Navigation")
+    TSubclassOf<UNavArea> RingAreaClass;
+
+    /** Area applied inside the core. */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Navigation")
+    TSubclassOf<UNavArea> CoreAreaClass;
+
+    /** Half height of the modifier cylinders, centered on the well. */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Navigation", meta = (ClampMin = "1.0"))
+    float HalfHeight = 300.f;
+
+private:
+    FVector GetModifierCenter() const;
+
+    float CoreRadius = 0.f;
+    float RingRadius = 0.f;
+};
@@ -0,0 +1,291 @@
+#include "GravityWellSubsystem.h"
+
+#include "GravityWellActor.h"
+#include "GravityWellNavModifierComponent.h"
+#include "GravityStats.h"
+#include "Gravity_test.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "TimerManager.h"
+
+namespace
+{
+    TAutoConsoleVariable<float> CVarGravityFieldCellSize(
+        TEXT("Gravity.FieldGrid.CellSize"),
+        200.f,
+        TEXT("Edge length in cm of the cells of the cached gravity field used by AI queries."),
+        ECVF_Default);
+
+    TAutoConsoleVariable<float> CVarGravityNavCoalesceDelay(
+        TEXT("Gravity.Nav.CoalesceDelay"),
+        0.5f,
+        TEXT("Seconds gravity well nav modifier updates are batched for before the navmesh is dirtied. 0 publishes on the next tick."),
+        ECVF_Default);
+
+    /** Wells moving less than this fraction of a cell do not invalidate the cached field. */
+    constexpr float KWellMoveToleranceCells = 0.5f;
+
+    /**
+     * Calls Function(Coord, DistSq) for every cell whose center lies within Radius of Center.
+     * Walks the sphere row by row instead of its bounding cube.
+     */
+    template <typename FunctionType>
+    void ForEachCellInSphere(const FGravityFieldGrid& Grid, const FVector& Center, float Radius, FunctionType&& Function)
+    {
+        const float RadiusSq = FMath::Square(Radius);
+        const FIntVector MinCoord = Grid.GetCellCoord(Center - FVector(Radius));
+        const FIntVector MaxCoord = Grid.GetCellCoord(Center + FVector(Radius));
+
+        for (int32 X = MinCoord.X; X <= MaxCoord.X; ++X)
+        {
+            const float DistXSq = FMath::Square((X + 0.5f) * Grid.CellSize - Center.X);
+            if (DistXSq > RadiusSq)
+            {
+                continue;
+            }
+
+            for (int32 Y = MinCoord.Y; Y <= MaxCoord.Y; ++Y)
+            {
+                const float DistXYSq = DistXSq + FMath::Square((Y + 0.5f) * Grid.CellSize - Center.Y);
+                if (DistXYSq > RadiusSq)
+                {
+                    continue;
+                }
+
+                // only the cells of this column whose centers fall inside the sphere
+                const float HalfHeight = FMath::Sqrt(RadiusSq - DistXYSq);
+                const int32 MinZ = FMath::CeilToInt32((Center.Z - HalfHeight) / Grid.CellSize - 0.5f);
+                const int32 MaxZ = FMath::FloorToInt32((Center.Z + HalfHeight) / Grid.CellSize - 0.5f);
+
+                for (int32 Z = MinZ; Z <= MaxZ; ++Z)
+                {
+                    Function(FIntVector(X, Y, Z), DistXYSq + FMath::Square((Z + 0.5f) * Grid.CellSize - Center.Z));
+                }
+            }
+        }
+    }
+}
+
+void FGravityFieldGrid::Reset()
+{
+    Cells.Reset();
+    Cores.Reset();
+}
+
+FIntVector FGravityFieldGrid::GetCellCoord(const FVector& Location) const
+{
+    return FIntVector(
+        FMath::FloorToInt32(Location.X / CellSize),
+        FMath::FloorToInt32(Location.Y / CellSize),
+        FMath::FloorToInt32(Location.Z / CellSize));
+}
+
+FVector FGravityFieldGrid::GetCellCenter(const FIntVector& Coord) const
+{
+    return (FVector(Coord) + FVector(0.5f)) * CellSize;
+}
+
+float FGravityFieldGrid::SampleMagnitude(const FVector& Location) const
+{
+    const FGravityFieldCell* Cell = Cells.Find(GetCellCoord(Location));
+    return Cell ? Cell->Accel.Size() : 0.f;
+}
+
+bool FGravityFieldGrid::IsInsideCore(const FVector& Location, float Margin) const
+{
+    // a core within Margin of the location overlaps at least one of the cells within Margin of it,
+    // and every cell a core overlaps lists it
+    const float CellMargin = FMath::Max(Margin, 0.f);
+    const FIntVector MinCoord = GetCellCoord(Location - FVector(CellMargin));
+    const FIntVector MaxCoord = GetCellCoord(Location + FVector(CellMargin));
+
+    for (int32 X = MinCoord.X; X <= MaxCoord.X; ++X)
+    {
+        for (int32 Y = MinCoord.Y; Y <= MaxCoord.Y; ++Y)
+        {
+            for (int32 Z = MinCoord.Z; Z <= MaxCoord.Z; ++Z)
+            {
+                const FGravityFieldCell* Cell = Cells.Find(FIntVector(X, Y, Z));
+                if (!Cell)
+                {
+                    continue;
+                }
+
+                for (const int32 CoreIndex : Cell->CoreIndices)
+                {
+                    const FSphere& Core = Cores[CoreIndex];
+                    if (FVector::DistSquared(Core.Center, Location) <= FMath::Square(Core.W + Margin))
+                    {
+                        return true;
+                    }
+                }
+            }
+        }
+    }
+    return false;
+}
+
+bool UGravityWellSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UGravityWellSubsystem::RegisterWell(AGravityWellActor* Well)
+{
+    if (Well && !Wells.Contains(Well))
+    {
+        Wells.Add(Well);
+        MarkFieldDirty();
+        INC_DWORD_STAT(STAT_GravityWells);
+    }
+}
+
+void UGravityWellSubsystem::UnregisterWell(AGravityWellActor* Well)
+{
+    if (Wells.RemoveSingleSwap(Well) > 0)
+    {
+        MarkFieldDirty();
+        DEC_DWORD_STAT(STAT_GravityWells);
+    }
+}
+
+void UGravityWellSubsystem::Deinitialize()
+{
+    if (UWorld* World = GetWorld())
+    {
+        World->GetTimerManager().ClearTimer(NavFlushTimerHandle);
+        World->GetTimerManager().ClearTimer(FieldRebuildTimerHandle);
+    }
+    PendingNavModifiers.Reset();
+
+    Super::Deinitialize();
+}
+
+SIZE_T UGravityWellSubsystem::GetAllocatedSize() const
+{
+    return Wells.GetAllocatedSize()
+        + CachedWellLocations.GetAllocatedSize()
+        + FieldGrid.Cells.GetAllocatedSize()
+        + FieldGrid.Cores.GetAllocatedSize()
+        + PendingNavModifiers.GetAllocatedSize();
+}
+
+void UGravityWellSubsystem::RequestNavModifierUpdate(UGravityWellNavModifierComponent* Modifier)
+{
+    if (!Modifier)
+    {
+        return;
+    }
+
+    PendingNavModifiers.AddUnique(Modifier);
+
+    FTimerManager& TimerManager = GetWorld()->GetTimerManager();
+    if (!TimerManager.IsTimerActive(NavFlushTimerHandle))
+    {
+        const float Delay = CVarGravityNavCoalesceDelay.GetValueOnGameThread();
+        if (Delay > 0.f)
+        {
+            TimerManager.SetTimer(NavFlushTimerHandle, this, &UGravityWellSubsystem::FlushNavModifierUpdates, Delay, false);
+        }
+        else
+        {
+            NavFlushTimerHandle = TimerManager.SetTimerForNextTick(this, &UGravityWellSubsystem::FlushNavModifierUpdates);
+        }
+    }
+}
+
+void UGravityWellSubsystem::FlushNavModifierUpdates()
+{
+    NavFlushTimerHandle.Invalidate();
+
+    // the navigation system merges the dirty areas of every modifier published here into a single tile rebuild pass
+    for (const TWeakObjectPtr<UGravityWellNavModifierComponent>& ModifierPtr : PendingNavModifiers)
+    {
+        if (UGravityWellNavModifierComponent* Modifier = ModifierPtr.Get())
+        {
+            Modifier->PublishModifiers();
+        }
+    }
+    PendingNavModifiers.Reset();
+}
+
+void UGravityWellSubsystem::MarkFieldDirty()
+{
+    UWorld* World = GetWorld();
+    if (!World || World->bIsTearingDown)
+    {
+        return;
+    }
+
+    FTimerManager& TimerManager = World->GetTimerManager();
+    if (!TimerManager.TimerExists(FieldRebuildTimerHandle))
+    {
+        FieldRebuildTimerHandle = TimerManager.SetTimerForNextTick(this, &UGravityWellSubsystem::RebuildFieldGrid);
+    }
+}
+
+const FGravityFieldGrid& UGravityWellSubsystem::GetFieldGrid()
+{
+    if (HaveWellsMoved())
+    {
+        MarkFieldDirty();
+    }
+    return FieldGrid;
+}
+
+bool UGravityWellSubsystem::HaveWellsMoved() const
+{
+    if (CachedWellLocations.Num() != Wells.Num())
+    {
+        return true;
+    }
+
+    const float ToleranceSq = FMath::Square(FieldGrid.CellSize * KWellMoveToleranceCells);
+    for (int32 Index = 0; Index < Wells.Num(); ++Index)
+    {
+        const AGravityWellActor* Well = Wells[Index].Get();
+        if (!Well || FVector::DistSquared(Well->GetWellLocation(), CachedWellLocations[Index]) > ToleranceSq)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void UGravityWellSubsystem::RebuildFieldGrid()
+{
+    SCOPE_CYCLE_COUNTER(STAT_GravityFieldRebuild);
+    CSV_SCOPED_TIMING_STAT(Gravity, FieldGridRebuild);
+    LLM_SCOPE_BYTAG(Gravity_Field);
+
+    FieldRebuildTimerHandle.Invalidate();
+
+    Wells.RemoveAllSwap([](const TWeakObjectPtr<AGravityWellActor>& Well) { return !Well.IsValid(); });
+
+    FieldGrid.Reset();
+    FieldGrid.CellSize = FMath::Max(CVarGravityFieldCellSize.GetValueOnGameThread(), 10.f);
+    CachedWellLocations.Reset(Wells.Num());
+
+    const float CellHalfDiagonal = FieldGrid.CellSize * UE_HALF_SQRT_3;
+
+    for (const TWeakObjectPtr<AGravityWellActor>& WellPtr : Wells)
+    {
+        const AGravityWellActor* Well = WellPtr.Get();
+        const FVector WellLocation = Well->GetWellLocation();
+        CachedWellLocations.Add(WellLocation);
+
+        ForEachCellInSphere(FieldGrid, WellLocation, Well->GetMaxRadius() + CellHalfDiagonal, [this, Well](const FIntVector& Coord, float DistSq)
+        {
+            FGravityFieldCell& Cell = FieldGrid.Cells.FindOrAdd(Coord);
+            Cell.Accel += FVector3f(Well->SampleAcceleration(FieldGrid.GetCellCenter(Coord)));
+        });
+
+        // list the core in every cell it may overlap, so core tests only look at the cores near them
+        const int32 CoreIndex = FieldGrid.Cores.Add(FSphere(WellLocation, Well->GetMinRadius()));
+
+        ForEachCellInSphere(FieldGrid, WellLocation, Well->GetMinRadius() + CellHalfDiagonal, [this, CoreIndex](const FIntVector& Coord, float DistSq)
+        {
+            FieldGrid.Cells.FindOrAdd(Coord).CoreIndices.Add(CoreIndex);
+        });
+    }
+}
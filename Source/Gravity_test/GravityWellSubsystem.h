@@ -0,0 +1,104 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GravityWellSubsystem.generated.h"
+
+class AGravityWellActor;
+class UGravityWellNavModifierComponent;
+
+/** One cell of the coarse gravity field cache. */
+struct FGravityFieldCell
+{
+    /** Summed acceleration of every well at the cell center. */
+    FVector3f Accel = FVector3f::ZeroVector;
+
+    /** Indices into FGravityFieldGrid::Cores of the well cores overlapping the cell. */
+    TArray<int32, TInlineAllocator<1>> CoreIndices;
+};
+
+/**
+ * Coarse, sparse snapshot of the gravity field produced by all active wells.
+ * Only cells inside a well's influence radius are stored; everything else samples as zero.
+ */
+struct GRAVITY_TEST_API FGravityFieldGrid
+{
+    /** Edge length of a cell, in cm. */
+    float CellSize = 200.f;
+
+    /** Cells inside the influence radius of at least one well. */
+    TMap<FIntVector, FGravityFieldCell> Cells;
+
+    /** Core spheres of the wells the grid was built from. */
+    TArray<FSphere> Cores;
+
+    void Reset();
+
+    FIntVector GetCellCoord(const FVector& Location) const;
+    FVector GetCellCenter(const FIntVector& Coord) const;
+
+    /** Returns the cached acceleration magnitude at the given location. */
+    float SampleMagnitude(const FVector& Location) const;
+
+    /** Returns true if the location lies within a well core, grown by Margin. Only tests the cores of the cells within Margin. */
+    bool IsInsideCore(const FVector& Location, float Margin = 0.f) const;
+};
+
+/**
+ * Tracks the gravity wells active in a world and owns the cached coarse field used by AI queries.
+ */
+UCLASS()
+class GRAVITY_TEST_API UGravityWellSubsystem : public UWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+    void RegisterWell(AGravityWellActor* Well);
+    void UnregisterWell(AGravityWellActor* Well);
+
+    /** Schedules a rebuild of the cached field for the next tick. Requests made in the same frame share one rebuild. */
+    void MarkFieldDirty();
+
+    const TArray<TWeakObjectPtr<AGravityWellActor>>& GetWells() const { return Wells; }
+
+    /**
+     * Returns the cached field. Never rebuilds it; a well that moved since the last rebuild only schedules one,
+     * so queries may see the field up to a frame late.
+     */
+    const FGravityFieldGrid& GetFieldGrid();
+
+    /**
+     * Queues a well's nav modifiers to be published with the next coalesced navmesh update.
+     * Wells that end play before the update fires never touch the navmesh.
+     */
+    void RequestNavModifierUpdate(UGravityWellNavModifierComponent* Modifier);
+
+    virtual void Deinitialize() override;
+
+    /** Heap bytes owned by the subsystem, mostly the cached field. */
+    SIZE_T GetAllocatedSize() const;
+
+    int32 GetNumFieldCells() const { return FieldGrid.Cells.Num(); }
+
+private:
+    void FlushNavModifierUpdates();
+
+    bool HaveWellsMoved() const;
+    void RebuildFieldGrid();
+
+    TArray<TWeakObjectPtr<AGravityWellActor>> Wells;
+
+    /** Well locations the cached field was built with, parallel to Wells. */
+    TArray<FVector> CachedWellLocations;
+
+    FGravityFieldGrid FieldGrid;
+
+    FTimerHandle FieldRebuildTimerHandle;
+
+    /** Nav modifiers waiting for the coalesced navmesh update. */
+    TArray<TWeakObjectPtr<UGravityWellNavModifierComponent>> PendingNavModifiers;
+
+    FTimerHandle NavFlushTimerHandle;
+};
@@ -5,4 +5,12 @@
 
 IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, Gravity_test, "Gravity_test" );
 
-DEFINE_LOG_CATEGORY(LogGravity_test)
\ No newline at end of file
+DEFINE_LOG_CATEGORY(LogGravity_test)
+
+LLM_DEFINE_TAG(Gravity);
+LLM_DEFINE_TAG(Gravity_Wells);
+LLM_DEFINE_TAG(Gravity_Field);
+LLM_DEFINE_TAG(Shooter);
+LLM_DEFINE_TAG(Shooter_Projectiles);
+LLM_DEFINE_TAG(Shooter_Weapons);
+LLM_DEFINE_TAG(Shooter_AI);
\ No newline at end of file
@@ -3,6 +3,16 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "HAL/LowLevelMemTracker.h"
 
 /** Main log category used across the project */
-DECLARE_LOG_CATEGORY_EXTERN(LogGravity_test, Log, All);
\ No newline at end of file
+DECLARE_LOG_CATEGORY_EXTERN(LogGravity_test, Log, All);
+
+/** Low level memory tags. Run with -llm, then use 'stat LLMFULL' or Gravity.MemReport to read them */
+LLM_DECLARE_TAG_API(Gravity, GRAVITY_TEST_API);
+LLM_DECLARE_TAG_API(Gravity_Wells, GRAVITY_TEST_API);
+LLM_DECLARE_TAG_API(Gravity_Field, GRAVITY_TEST_API);
+LLM_DECLARE_TAG_API(Shooter, GRAVITY_TEST_API);
+LLM_DECLARE_TAG_API(Shooter_Projectiles, GRAVITY_TEST_API);
+LLM_DECLARE_TAG_API(Shooter_Weapons, GRAVITY_TEST_API);
+LLM_DECLARE_TAG_API(Shooter_AI, GRAVITY_TEST_API);
\ No newline at end of file
@@ -6,13 +6,16 @@
 #include "Components/CapsuleComponent.h"
 #include "Components/SkeletalMeshComponent.h"
 #include "Engine/CollisionProfile.h"
+#include "Engine/SkeletalMesh.h"
 #include "EnhancedInputComponent.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "InputActionValue.h"
-#include "UObject/ConstructorHelpers.h"
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
 #include "Gravity_test.h"
 
-AGravity_testCharacter::AGravity_testCharacter()
+AGravity_testCharacter::AGravity_testCharacter(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
 {
 	// Set size for collision capsule
 	GetCapsuleComponent()->InitCapsuleSize(55.f, 96.0f);
@@ -52,17 +55,6 @@ AGravity_testCharacter::AGravity_testCharacter()
 	ThirdPersonPistolMesh->SetCanEverAffectNavigation(false);
 	ThirdPersonPistolMesh->bCastDynamicShadow = true;
 
-	static ConstructorHelpers::FObjectFinder<USkeletalMesh> PistolMeshFinder(TEXT("/Game/Weapons/Pistol/Meshes/SK_Pistol.SK_Pistol"));
-	if (PistolMeshFinder.Succeeded())
-	{
-		FirstPersonPistolMesh->SetSkeletalMesh(PistolMeshFinder.Object);
-		ThirdPersonPistolMesh->SetSkeletalMesh(PistolMeshFinder.Object);
-	}
-	else
-	{
-		UE_LOG(LogGravity_test, Warning, TEXT("First person pistol mesh asset not found. Update the path in AGravity_testCharacter."));
-	}
-
 	// configure the character comps
 	GetMesh()->SetOwnerNoSee(true);
 	GetMesh()->FirstPersonPrimitiveType = EFirstPersonPrimitiveType::WorldSpaceRepresentation;
@@ -78,6 +70,14 @@ void AGravity_testCharacter::BeginPlay()
 {
 	Super::BeginPlay();
 
+	// stream in the pistol mesh instead of hard loading it with the character class
+	const bool bNeedsPistolMesh = (FirstPersonPistolMesh && !FirstPersonPistolMesh->GetSkeletalMeshAsset()) || (ThirdPersonPistolMesh && !ThirdPersonPistolMesh->GetSkeletalMeshAsset());
+	if (bNeedsPistolMesh && !PistolMeshAsset.IsNull())
+	{
+		PistolMeshLoadHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(PistolMeshAsset.ToSoftObjectPath(),
+			FStreamableDelegate::CreateUObject(this, &AGravity_testCharacter::OnPistolMeshLoaded));
+	}
+
 	const FAttachmentTransformRules AttachRules(EAttachmentRule::SnapToTarget, true);
 
 	if (FirstPersonMesh && FirstPersonPistolMesh)
@@ -116,6 +116,24 @@ void AGravity_testCharacter::BeginPlay()
 	}
 }
 
+void AGravity_testCharacter::OnPistolMeshLoaded()
+{
+	USkeletalMesh* PistolMesh = PistolMeshAsset.Get();
+	if (!PistolMesh)
+	{
+		UE_LOG(LogGravity_test, Warning, TEXT("Pistol mesh asset %s could not be loaded."), *PistolMeshAsset.ToString());
+		return;
+	}
+
+	for (USkeletalMeshComponent* PistolComponent : { FirstPersonPistolMesh, ThirdPersonPistolMesh })
+	{
+		if (PistolComponent && !PistolComponent->GetSkeletalMeshAsset())
+		{
+			PistolComponent->SetSkeletalMesh(PistolMesh);
+		}
+	}
+}
+
 void AGravity_testCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
 {	
 	// Set up action bindings
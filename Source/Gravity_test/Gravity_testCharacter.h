@@ -11,7 +11,9 @@ class UInputComponent;
 class USkeletalMeshComponent;
 class UCameraComponent;
 class UInputAction;
+class USkeletalMesh;
 struct FInputActionValue;
+struct FStreamableHandle;
 
 DECLARE_LOG_CATEGORY_EXTERN(LogTemplateCharacter, Log, All);
 
@@ -46,6 +48,13 @@ class AGravity_testCharacter : public ACharacter
 	/** Socket used to attach the third person pistol */
 	UPROPERTY(EditDefaultsOnly, Category="Weapons")
 	FName ThirdPersonPistolSocket = FName("hand_r");
+
+	/** Pistol mesh streamed in at BeginPlay for pistol components that don't have a mesh set */
+	UPROPERTY(EditDefaultsOnly, Category="Weapons")
+	TSoftObjectPtr<USkeletalMesh> PistolMeshAsset = TSoftObjectPtr<USkeletalMesh>(FSoftObjectPath(TEXT("/Game/Weapons/Pistol/Meshes/SK_Pistol.SK_Pistol")));
+
+	/** Keeps the pistol mesh loaded while it streams in */
+	TSharedPtr<FStreamableHandle> PistolMeshLoadHandle;
 
 protected:
 
@@ -66,13 +75,16 @@ protected:
 	class UInputAction* MouseLookAction;
 	
 public:
-	AGravity_testCharacter();
+	AGravity_testCharacter(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
 
 protected:
 
 	/** Handle component setup that depends on loaded assets */
 	virtual void BeginPlay() override;
 
+	/** Applies the streamed in pistol mesh to any pistol component that doesn't have one */
+	void OnPistolMeshLoaded();
+
 	/** Called from Input Actions for movement input */
 	void MoveInput(const FInputActionValue& Value);
 
@@ -0,0 +1,109 @@
+#include "HUDModelSubsystem.h"
+#include "Engine/LocalPlayer.h"
+
+namespace
+{
+	/** Smallest sprint meter change worth a widget update */
+	constexpr float KSprintPercentTolerance = 0.005f;
+}
+
+void UHUDModelSubsystem::SetAmmo(int32 InMagazineSize, int32 InBullets)
+{
+	if (InMagazineSize != MagazineSize || InBullets != Bullets)
+	{
+		MagazineSize = InMagazineSize;
+		Bullets = InBullets;
+		MarkDirty(EHUDModelField::Ammo);
+	}
+}
+
+void UHUDModelSubsystem::SetLifePercent(float InLifePercent)
+{
+	if (InLifePercent != LifePercent)
+	{
+		LifePercent = InLifePercent;
+		MarkDirty(EHUDModelField::Life);
+	}
+}
+
+void UHUDModelSubsystem::SetSprintPercent(float InSprintPercent)
+{
+	// always let the meter reach its ends, even if the last step was small
+	const bool bReachedEnd = (InSprintPercent <= 0.0f || InSprintPercent >= 1.0f) && InSprintPercent != SprintPercent;
+
+	if (bReachedEnd || !FMath::IsNearlyEqual(InSprintPercent, SprintPercent, KSprintPercentTolerance))
+	{
+		SprintPercent = InSprintPercent;
+		MarkDirty(EHUDModelField::Sprint);
+	}
+}
+
+void UHUDModelSubsystem::SetSprinting(bool bInSprinting)
+{
+	if (bInSprinting != bSprinting)
+	{
+		bSprinting = bInSprinting;
+		MarkDirty(EHUDModelField::SprintState);
+	}
+}
+
+void UHUDModelSubsystem::SetTeamScore(uint8 TeamByte, int32 Score)
+{
+	int32& CurrentScore = TeamScores.FindOrAdd(TeamByte, INDEX_NONE);
+
+	if (CurrentScore != Score)
+	{
+		CurrentScore = Score;
+		DirtyTeams.AddUnique(TeamByte);
+		MarkDirty(EHUDModelField::Score);
+	}
+}
+
+void UHUDModelSubsystem::RefreshAll()
+{
+	// values still at their out of range start were never set, so there's nothing to show for them
+	if (MagazineSize != INDEX_NONE)
+	{
+		MarkDirty(EHUDModelField::Ammo);
+	}
+
+	if (LifePercent >= 0.0f)
+	{
+		MarkDirty(EHUDModelField::Life);
+	}
+
+	if (SprintPercent >= 0.0f)
+	{
+		MarkDirty(EHUDModelField::Sprint | EHUDModelField::SprintState);
+	}
+
+	if (TeamScores.Num() > 0)
+	{
+		TeamScores.GenerateKeyArray(DirtyTeams);
+		MarkDirty(EHUDModelField::Score);
+	}
+}
+
+void UHUDModelSubsystem::Tick(float DeltaTime)
+{
+	// clear the dirty state first so widgets can push values from their handlers for the next frame
+	const EHUDModelField ChangedFields = DirtyFields;
+	DirtyFields = EHUDModelField::None;
+
+	Swap(ChangedTeams, DirtyTeams);
+	DirtyTeams.Reset();
+
+	OnFlushed.Broadcast(ChangedFields);
+
+	ChangedTeams.Reset();
+}
+
+UWorld* UHUDModelSubsystem::GetTickableGameObjectWorld() const
+{
+	return GetLocalPlayer() ? GetLocalPlayer()->GetWorld() : nullptr;
+}
+
+TStatId UHUDModelSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UHUDModelSubsystem, STATGROUP_Tickables);
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/LocalPlayerSubsystem.h"
+#include "Tickable.h"
+#include "HUDModelSubsystem.generated.h"
+
+/** HUD values tracked by the model. Used as flags to tell widgets which values changed */
+enum class EHUDModelField : uint8
+{
+	None		= 0,
+	Ammo		= 1 << 0,
+	Life		= 1 << 1,
+	Sprint		= 1 << 2,
+	SprintState	= 1 << 3,
+	Score		= 1 << 4,
+};
+ENUM_CLASS_FLAGS(EHUDModelField);
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FHUDModelFlushedDelegate, EHUDModelField /* ChangedFields */);
+
+/**
+ *  Per player HUD view model
+ *  Gameplay code pushes HUD values here as often as it likes. Values that didn't change are dropped, and
+ *  the ones that did are flushed to the widgets at most once per frame, so widgets only update on real changes
+ */
+UCLASS()
+class GRAVITY_TEST_API UHUDModelSubsystem : public ULocalPlayerSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+	/** Fields changed since the last flush */
+	EHUDModelField DirtyFields = EHUDModelField::None;
+
+	/** Teams whose score changed since the last flush */
+	TArray<uint8> DirtyTeams;
+
+	/** Teams whose score changed in the flush being broadcast */
+	TArray<uint8> ChangedTeams;
+
+	int32 MagazineSize = INDEX_NONE;
+	int32 Bullets = INDEX_NONE;
+
+	/** Starts out of range so the first value always goes through */
+	float LifePercent = -1.0f;
+	float SprintPercent = -1.0f;
+
+	bool bSprinting = false;
+
+	/** Score of each team */
+	TMap<uint8, int32> TeamScores;
+
+public:
+
+	/** Broadcast once per frame with the fields that changed */
+	FHUDModelFlushedDelegate OnFlushed;
+
+	/** Sets the ammo counter */
+	void SetAmmo(int32 InMagazineSize, int32 InBullets);
+
+	/** Sets the life bar */
+	void SetLifePercent(float InLifePercent);
+
+	/** Sets the sprint meter. Changes smaller than a meter pixel are dropped */
+	void SetSprintPercent(float InSprintPercent);
+
+	/** Sets the sprint state */
+	void SetSprinting(bool bInSprinting);
+
+	/** Sets the score of a team */
+	void SetTeamScore(uint8 TeamByte, int32 Score);
+
+	/**
+	 *  Flags every value the model holds for the next flush, even if it didn't change.
+	 *  The model outlives level travel and HUD widgets, so new widgets call this after subscribing to pick up the current state
+	 */
+	void RefreshAll();
+
+	int32 GetMagazineSize() const { return MagazineSize; }
+	int32 GetBullets() const { return Bullets; }
+	float GetLifePercent() const { return LifePercent; }
+	float GetSprintPercent() const { return SprintPercent; }
+	bool IsSprinting() const { return bSprinting; }
+
+	/** Returns the score of a team */
+	int32 GetTeamScore(uint8 TeamByte) const { return TeamScores.FindRef(TeamByte); }
+
+	/** Returns the teams whose score changed. Only valid while OnFlushed is being broadcast */
+	const TArray<uint8>& GetChangedTeams() const { return ChangedTeams; }
+
+	//~Begin FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override { return ETickableTickType::Conditional; }
+	virtual bool IsTickable() const override { return DirtyFields != EHUDModelField::None; }
+	virtual bool IsTickableWhenPaused() const override { return true; }
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+	virtual TStatId GetStatId() const override;
+	//~End FTickableGameObject interface
+
+protected:
+
+	/** Flags a field for the next flush */
+	void MarkDirty(EHUDModelField Field) { DirtyFields |= Field; }
+};
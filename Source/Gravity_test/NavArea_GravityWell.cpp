@@ -0,0 +1,9 @@
+#include "NavArea_GravityWell.h"
+
+UNavArea_GravityWellRing::UNavArea_GravityWellRing(const FObjectInitializer& ObjectInitializer)
+    : Super(ObjectInitializer)
+{
+    DefaultCost = 20.f;
+    FixedAreaEnteringCost = 500.f;
+    DrawColor = FColor(128, 0, 160);
+}
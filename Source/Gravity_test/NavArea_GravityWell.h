@@ -0,0 +1,17 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "NavAreas/NavArea.h"
+#include "NavArea_GravityWell.generated.h"
+
+/**
+ * High cost navigation area published in the influence ring of an active gravity well.
+ */
+UCLASS(Config = Engine)
+class GRAVITY_TEST_API UNavArea_GravityWellRing : public UNavArea
+{
+    GENERATED_BODY()
+
+public:
+    UNavArea_GravityWellRing(const FObjectInitializer& ObjectInitializer);
+};
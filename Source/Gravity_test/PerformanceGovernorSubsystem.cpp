@@ -0,0 +1,317 @@
+#include "PerformanceGovernorSubsystem.h"
+
+#include "GravityWellActor.h"
+#include "GravityWellSubsystem.h"
+#include "GravityStats.h"
+#include "FrameScratch.h"
+#include "Gravity_test.h"
+#include "ShooterAIController.h"
+#include "ShooterRagdollSubsystem.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "Physics/Experimental/PhysScene_Chaos.h"
+#include "RenderCore.h"
+
+namespace
+{
+    TAutoConsoleVariable<bool> CVarGovernorEnable(
+        TEXT("Gravity.Governor.Enable"),
+        true,
+        TEXT("Lower gravity, VFX and AI quality when frames run over budget."),
+        ECVF_Default);
+
+    TAutoConsoleVariable<float> CVarGovernorBudgetMs(
+        TEXT("Gravity.Governor.BudgetMs"),
+        0.f,
+        TEXT("Frame budget in ms for the game and render threads. 0 derives it from the engine's max tick rate, or 60 fps if uncapped."),
+        ECVF_Default);
+
+    TAutoConsoleVariable<float> CVarGovernorPhysicsBudgetMs(
+        TEXT("Gravity.Governor.PhysicsBudgetMs"),
+        6.f,
+        TEXT("Budget in ms for the physics step."),
+        ECVF_Default);
+
+    TAutoConsoleVariable<float> CVarGovernorUpgradeLoad(
+        TEXT("Gravity.Governor.UpgradeLoad"),
+        0.7f,
+        TEXT("Load below which the governor starts counting towards a higher tier. Between this and 1 the tier holds."),
+        ECVF_Default);
+
+    TAutoConsoleVariable<float> CVarGovernorDowngradeTime(
+        TEXT("Gravity.Governor.DowngradeTime"),
+        0.5f,
+        TEXT("Seconds the load has to stay over budget before quality drops a tier."),
+        ECVF_Default);
+
+    TAutoConsoleVariable<float> CVarGovernorUpgradeTime(
+        TEXT("Gravity.Governor.UpgradeTime"),
+        5.f,
+        TEXT("Seconds the load has to stay below Gravity.Governor.UpgradeLoad before quality rises a tier."),
+        ECVF_Default);
+
+    TAutoConsoleVariable<int32> CVarGovernorForceTier(
+        TEXT("Gravity.Governor.ForceTier"),
+        -1,
+        TEXT("Pins the governor to a tier (0 Full, 1 Reduced, 2 Low, 3 Minimal). -1 lets it adapt."),
+        ECVF_Default);
+
+    constexpr FPerformanceTierSettings KTierSettings[] = {
+        // scale, bodies, vfx, AI interval, ragdolls
+        { 1.f, MAX_int32, MAX_int32, 0.f, MAX_int32 },
+        { 1.5f, 128, 16, 0.1f, 6 },
+        { 2.f, 64, 6, 0.2f, 4 },
+        { 3.f, 24, 2, 0.33f, 2 },
+    };
+    static_assert(UE_ARRAY_COUNT(KTierSettings) == int32(EPerformanceTier::Num), "Every tier needs settings");
+
+    /** Weight of the newest frame in the smoothed load. */
+    constexpr float KLoadSmoothing = 0.1f;
+
+    /** Seconds between handing out the VFX budget, which sorts every well by view distance. */
+    constexpr float KVfxUpdateInterval = 0.5f;
+
+    constexpr float KDefaultBudgetMs = 1000.f / 60.f;
+
+    float CyclesToMs(uint64 Cycles)
+    {
+        return float(FPlatformTime::ToMilliseconds64(Cycles));
+    }
+
+    /** The engine's thread times are 32-bit FPlatformTime::Cycles, which don't share Cycles64 units on every platform. */
+    float ThreadCyclesToMs(uint32 Cycles)
+    {
+        return FPlatformTime::ToMilliseconds(Cycles);
+    }
+
+    float GetFrameBudgetMs()
+    {
+        const float BudgetMs = CVarGovernorBudgetMs.GetValueOnGameThread();
+        if (BudgetMs > 0.f)
+        {
+            return BudgetMs;
+        }
+
+        // dedicated servers are capped by their net tick rate, clients by t.MaxFPS or frame rate smoothing
+        const float MaxTickRate = GEngine ? GEngine->GetMaxTickRate(0.f, false) : 0.f;
+        return MaxTickRate > 0.f ? 1000.f / MaxTickRate : KDefaultBudgetMs;
+    }
+}
+
+bool UPerformanceGovernorSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UPerformanceGovernorSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+    Super::OnWorldBeginPlay(InWorld);
+
+    TickStartHandle = FWorldDelegates::OnWorldTickStart.AddUObject(this, &UPerformanceGovernorSubsystem::OnWorldTickStart);
+    PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UPerformanceGovernorSubsystem::OnWorldPostActorTick);
+
+    if (FPhysScene_Chaos* PhysScene = InWorld.GetPhysicsScene())
+    {
+        PhysicsPreTickHandle = PhysScene->OnPhysScenePreTick.AddUObject(this, &UPerformanceGovernorSubsystem::OnPhysicsPreTick);
+        PhysicsPostTickHandle = PhysScene->OnPhysScenePostTick.AddUObject(this, &UPerformanceGovernorSubsystem::OnPhysicsPostTick);
+    }
+}
+
+void UPerformanceGovernorSubsystem::Deinitialize()
+{
+    FWorldDelegates::OnWorldTickStart.Remove(TickStartHandle);
+    FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+
+    if (UWorld* World = GetWorld())
+    {
+        if (FPhysScene_Chaos* PhysScene = World->GetPhysicsScene())
+        {
+            PhysScene->OnPhysScenePreTick.Remove(PhysicsPreTickHandle);
+            PhysScene->OnPhysScenePostTick.Remove(PhysicsPostTickHandle);
+        }
+    }
+
+    Super::Deinitialize();
+}
+
+void UPerformanceGovernorSubsystem::Tick(float DeltaTime)
+{
+    const int32 ForcedTier = CVarGovernorForceTier.GetValueOnGameThread();
+
+    if (ForcedTier >= 0)
+    {
+        SetTier(EPerformanceTier(FMath::Min(ForcedTier, int32(EPerformanceTier::Num) - 1)));
+    }
+    else if (!CVarGovernorEnable.GetValueOnGameThread())
+    {
+        SetTier(EPerformanceTier::Full);
+    }
+    else if (WorldTickCycles > 0)
+    {
+        // the frame is as slow as its most loaded thread. Physics runs inside the world tick but gets its own budget,
+        // so a physics spike from a well-spam moment degrades quality before it eats the whole frame
+        const float BudgetMs = GetFrameBudgetMs();
+        const float GameLoad = CyclesToMs(WorldTickCycles) / BudgetMs;
+        const float RenderLoad = FMath::Max(ThreadCyclesToMs(GRenderThreadTime), ThreadCyclesToMs(GRHIThreadTime)) / BudgetMs;
+        const float PhysicsLoad = CyclesToMs(PhysicsCycles) / FMath::Max(CVarGovernorPhysicsBudgetMs.GetValueOnGameThread(), KINDA_SMALL_NUMBER);
+
+        const float Load = FMath::Max3(GameLoad, RenderLoad, PhysicsLoad);
+        SmoothedLoad = FMath::Lerp(SmoothedLoad, Load, KLoadSmoothing);
+
+        OverBudgetTime = SmoothedLoad > 1.f ? OverBudgetTime + DeltaTime : 0.f;
+        UnderBudgetTime = SmoothedLoad < CVarGovernorUpgradeLoad.GetValueOnGameThread() ? UnderBudgetTime + DeltaTime : 0.f;
+
+        if (OverBudgetTime >= CVarGovernorDowngradeTime.GetValueOnGameThread() && Tier != EPerformanceTier::Minimal)
+        {
+            SetTier(EPerformanceTier(int32(Tier) + 1));
+        }
+        else if (UnderBudgetTime >= CVarGovernorUpgradeTime.GetValueOnGameThread() && Tier != EPerformanceTier::Full)
+        {
+            SetTier(EPerformanceTier(int32(Tier) - 1));
+        }
+    }
+
+    TimeSinceVfxUpdate += DeltaTime;
+    if (TimeSinceVfxUpdate >= KVfxUpdateInterval)
+    {
+        TimeSinceVfxUpdate = 0.f;
+        DistributeVfxBudget();
+    }
+
+    SET_DWORD_STAT(STAT_GravityGovernorTier, int32(Tier));
+    SET_FLOAT_STAT(STAT_GravityGovernorLoad, SmoothedLoad);
+    CSV_CUSTOM_STAT(Gravity, GovernorTier, int32(Tier), ECsvCustomStatOp::Set);
+    CSV_CUSTOM_STAT(Gravity, GovernorLoad, SmoothedLoad, ECsvCustomStatOp::Set);
+}
+
+TStatId UPerformanceGovernorSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UPerformanceGovernorSubsystem, STATGROUP_Tickables);
+}
+
+const FPerformanceTierSettings& UPerformanceGovernorSubsystem::GetTierSettings() const
+{
+    return KTierSettings[int32(Tier)];
+}
+
+void UPerformanceGovernorSubsystem::SetTier(EPerformanceTier NewTier)
+{
+    OverBudgetTime = 0.f;
+    UnderBudgetTime = 0.f;
+
+    if (NewTier == Tier)
+    {
+        return;
+    }
+
+    UE_LOG(LogGravity_test, Log, TEXT("Performance governor: tier %d -> %d at load %.2f."), int32(Tier), int32(NewTier), SmoothedLoad);
+
+    Tier = NewTier;
+    ApplyTier();
+}
+
+void UPerformanceGovernorSubsystem::ApplyTier()
+{
+    const FPerformanceTierSettings& Settings = GetTierSettings();
+    UWorld* World = GetWorld();
+
+    if (const UGravityWellSubsystem* Wells = World->GetSubsystem<UGravityWellSubsystem>())
+    {
+        for (const TWeakObjectPtr<AGravityWellActor>& WellPtr : Wells->GetWells())
+        {
+            if (AGravityWellActor* Well = WellPtr.Get())
+            {
+                Well->SetPerformanceBudget(Settings.WellTickIntervalScale, Settings.MaxBodiesPerWell);
+            }
+        }
+    }
+
+    for (TActorIterator<AShooterAIController> It(World); It; ++It)
+    {
+        It->SetLogicTickInterval(Settings.AITickInterval);
+    }
+
+    if (UShooterRagdollSubsystem* Ragdolls = World->GetSubsystem<UShooterRagdollSubsystem>())
+    {
+        Ragdolls->SetMaxSimulatingCap(Settings.MaxRagdolls);
+    }
+
+    DistributeVfxBudget();
+}
+
+void UPerformanceGovernorSubsystem::DistributeVfxBudget()
+{
+    const UGravityWellSubsystem* Wells = GetWorld()->GetSubsystem<UGravityWellSubsystem>();
+    if (!Wells || Wells->GetWells().IsEmpty())
+    {
+        return;
+    }
+
+    const int32 MaxVfx = GetTierSettings().MaxAccretionVfx;
+
+    FVector ViewLocation = FVector::ZeroVector;
+    if (const APlayerController* PC = GetWorld()->GetFirstPlayerController())
+    {
+        if (PC->PlayerCameraManager)
+        {
+            ViewLocation = PC->PlayerCameraManager->GetCameraLocation();
+        }
+    }
+
+    FFrameScratchScope ScratchScope;
+    TFrameScratchArray<TPair<float, AGravityWellActor*>> SortedWells;
+    SortedWells.Reserve(Wells->GetWells().Num());
+
+    for (const TWeakObjectPtr<AGravityWellActor>& WellPtr : Wells->GetWells())
+    {
+        if (AGravityWellActor* Well = WellPtr.Get())
+        {
+            SortedWells.Emplace(FVector::DistSquared(Well->GetWellLocation(), ViewLocation), Well);
+        }
+    }
+
+    if (MaxVfx < SortedWells.Num())
+    {
+        SortedWells.Sort([](const TPair<float, AGravityWellActor*>& A, const TPair<float, AGravityWellActor*>& B) { return A.Key < B.Key; });
+    }
+
+    for (int32 Index = 0; Index < SortedWells.Num(); ++Index)
+    {
+        SortedWells[Index].Value->SetAccretionVfxAllowed(Index < MaxVfx);
+    }
+}
+
+void UPerformanceGovernorSubsystem::OnWorldTickStart(UWorld* InWorld, ELevelTick TickType, float DeltaTime)
+{
+    if (InWorld == GetWorld())
+    {
+        TickStartCycle = FPlatformTime::Cycles64();
+        PhysicsCycles = 0;
+    }
+}
+
+void UPerformanceGovernorSubsystem::OnWorldPostActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaTime)
+{
+    if (InWorld == GetWorld() && TickStartCycle != 0)
+    {
+        WorldTickCycles = FPlatformTime::Cycles64() - TickStartCycle;
+    }
+}
+
+void UPerformanceGovernorSubsystem::OnPhysicsPreTick(FPhysScene_Chaos* PhysScene, float DeltaTime)
+{
+    PhysicsStartCycle = FPlatformTime::Cycles64();
+}
+
+void UPerformanceGovernorSubsystem::OnPhysicsPostTick(FPhysScene_Chaos* PhysScene)
+{
+    if (PhysicsStartCycle != 0)
+    {
+        PhysicsCycles += FPlatformTime::Cycles64() - PhysicsStartCycle;
+        PhysicsStartCycle = 0;
+    }
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "PerformanceGovernorSubsystem.generated.h"
+
+class FPhysScene_Chaos;
+
+/** Quality tiers the governor steps through, from full quality to the cheapest the game still plays with. */
+enum class EPerformanceTier : uint8
+{
+    Full,
+    Reduced,
+    Low,
+    Minimal,
+
+    Num
+};
+
+/** What each system may spend at a given tier. */
+struct FPerformanceTierSettings
+{
+    /** Multiplier on every well's TickInterval. */
+    float WellTickIntervalScale = 1.f;
+
+    /** Rigid bodies a well pushes per step. Characters are always pulled, so none is left stuck flying. */
+    int32 MaxBodiesPerWell = MAX_int32;
+
+    /** Wells running their accretion VFX, closest to the view first. */
+    int32 MaxAccretionVfx = MAX_int32;
+
+    /** Seconds between StateTree updates of each NPC. 0 updates every frame. */
+    float AITickInterval = 0.f;
+
+    /** Cap on simultaneously simulating death ragdolls, on top of Shooter.Ragdoll.MaxSimulating. */
+    int32 MaxRagdolls = MAX_int32;
+};
+
+/**
+ * Keeps the frame rate up under load by trading gravity, VFX and AI quality for time.
+ *
+ * Watches the world tick (game thread), physics step and render/RHI thread times against the frame budget
+ * and moves one tier down after a sustained overrun, or one tier up after a sustained stretch of headroom.
+ * The band between the two thresholds holds the current tier, so the governor doesn't oscillate.
+ * The current tier and load show up in stat Gravity and the Gravity CSV category.
+ */
+UCLASS()
+class GRAVITY_TEST_API UPerformanceGovernorSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+    virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+    virtual void Deinitialize() override;
+
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+    EPerformanceTier GetTier() const { return Tier; }
+
+    /** Returns the budgets of the current tier. Systems spawned mid-game read these to start at the right quality. */
+    const FPerformanceTierSettings& GetTierSettings() const;
+
+    /** Smoothed frame cost relative to the budget. Above 1 the frame is over budget. */
+    float GetLoad() const { return SmoothedLoad; }
+
+private:
+    void SetTier(EPerformanceTier NewTier);
+
+    /** Pushes the current tier's budgets to every affected system. */
+    void ApplyTier();
+
+    /** Hands the accretion VFX budget to the wells closest to the view. */
+    void DistributeVfxBudget();
+
+    void OnWorldTickStart(UWorld* InWorld, ELevelTick TickType, float DeltaTime);
+    void OnWorldPostActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaTime);
+    void OnPhysicsPreTick(FPhysScene_Chaos* PhysScene, float DeltaTime);
+    void OnPhysicsPostTick(FPhysScene_Chaos* PhysScene);
+
+    EPerformanceTier Tier = EPerformanceTier::Full;
+
+    float SmoothedLoad = 0.f;
+
+    /** Time the load has stayed above the budget, or below the upgrade threshold. */
+    float OverBudgetTime = 0.f;
+    float UnderBudgetTime = 0.f;
+
+    float TimeSinceVfxUpdate = 0.f;
+
+    /** Timings of the last frame. */
+    uint64 TickStartCycle = 0;
+    uint64 WorldTickCycles = 0;
+    uint64 PhysicsStartCycle = 0;
+    uint64 PhysicsCycles = 0;
+
+    FDelegateHandle TickStartHandle;
+    FDelegateHandle PostActorTickHandle;
+    FDelegateHandle PhysicsPreTickHandle;
+    FDelegateHandle PhysicsPostTickHandle;
+};
@@ -3,6 +3,8 @@
 
 #include "HorrorUI.h"
 #include "HorrorCharacter.h"
+#include "HUDModelSubsystem.h"
+#include "Engine/LocalPlayer.h"
 
 void UHorrorUI::SetupCharacter(AHorrorCharacter* HorrorCharacter)
 {
@@ -12,12 +14,61 @@ void UHorrorUI::SetupCharacter(AHorrorCharacter* HorrorCharacter)
 
 void UHorrorUI::OnSprintMeterUpdated(float Percent)
 {
-	// call the BP handler
-	BP_SprintMeterUpdated(Percent);
+	// update the HUD model. The BP handler is called when it flushes
+	if (HUDModel.IsValid())
+	{
+		HUDModel->SetSprintPercent(Percent);
+	}
 }
 
 void UHorrorUI::OnSprintStateChanged(bool bSprinting)
 {
-	// call the BP handler
-	BP_SprintStateChanged(bSprinting);
+	// update the HUD model. The BP handler is called when it flushes
+	if (HUDModel.IsValid())
+	{
+		HUDModel->SetSprinting(bSprinting);
+	}
+}
+
+void UHorrorUI::NativeConstruct()
+{
+	Super::NativeConstruct();
+
+	// subscribe to the HUD model
+	if (ULocalPlayer* LocalPlayer = GetOwningLocalPlayer())
+	{
+		HUDModel = LocalPlayer->GetSubsystem<UHUDModelSubsystem>();
+
+		if (HUDModel.IsValid())
+		{
+			HUDModel->OnFlushed.AddUObject(this, &UHorrorUI::OnHUDModelFlushed);
+
+			// the model may already hold values that won't change again, e.g. after a level travel
+			HUDModel->RefreshAll();
+		}
+	}
+}
+
+void UHorrorUI::NativeDestruct()
+{
+	// unsubscribe from the HUD model
+	if (HUDModel.IsValid())
+	{
+		HUDModel->OnFlushed.RemoveAll(this);
+	}
+
+	Super::NativeDestruct();
+}
+
+void UHorrorUI::OnHUDModelFlushed(EHUDModelField ChangedFields)
+{
+	if (EnumHasAnyFlags(ChangedFields, EHUDModelField::Sprint))
+	{
+		BP_SprintMeterUpdated(HUDModel->GetSprintPercent());
+	}
+
+	if (EnumHasAnyFlags(ChangedFields, EHUDModelField::SprintState))
+	{
+		BP_SprintStateChanged(HUDModel->IsSprinting());
+	}
 }
@@ -7,12 +7,15 @@
 #include "HorrorUI.generated.h"
 
 class AHorrorCharacter;
+class UHUDModelSubsystem;
+enum class EHUDModelField : uint8;
 
 /**
  *  Simple UI for a first person horror game
  *  Manages character sprint meter display
+ *  Sprint updates go through the owning player's HUD model, so the meter redraws at most once per frame and only when it moves
  */
-UCLASS(abstract)
+UCLASS(abstract, meta = (DisableNativeTick))
 class GRAVITY_TEST_API UHorrorUI : public UUserWidget
 {
 	GENERATED_BODY()
@@ -32,6 +35,18 @@ public:
 
 protected:
 
+	/** Subscribes to the HUD model */
+	virtual void NativeConstruct() override;
+
+	/** Unsubscribes from the HUD model */
+	virtual void NativeDestruct() override;
+
+	/** Passes the changed sprint values to Blueprint */
+	void OnHUDModelFlushed(EHUDModelField ChangedFields);
+
+	/** HUD model this widget is subscribed to */
+	TWeakObjectPtr<UHUDModelSubsystem> HUDModel;
+
 	/** Passes control to Blueprint to update the sprint meter widgets */
 	UFUNCTION(BlueprintImplementableEvent, Category="Horror", meta = (DisplayName = "Sprint Meter Updated"))
 	void BP_SprintMeterUpdated(float Percent);
@@ -0,0 +1,111 @@
+#include "EnvQueryGenerator_CoverPoints.h"
+#include "EnvironmentQuery/Contexts/EnvQueryContext_Querier.h"
+#include "EnvQueryContext_Target.h"
+#include "ShooterCoverPointDatabase.h"
+#include "ShooterCoverPointSubsystem.h"
+#include "Engine/World.h"
+#include "Algo/AllOf.h"
+
+UEnvQueryGenerator_CoverPoints::UEnvQueryGenerator_CoverPoints(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	GenerateAround = UEnvQueryContext_Querier::StaticClass();
+	ThreatContext = UEnvQueryContext_Target::StaticClass();
+	SearchRadius.DefaultValue = 1500.0f;
+
+	// baked points are already on the navmesh
+	ProjectionData.TraceMode = EEnvQueryTrace::None;
+}
+
+void UEnvQueryGenerator_CoverPoints::GenerateItems(FEnvQueryInstance& QueryInstance) const
+{
+	const UShooterCoverPointSubsystem* CoverSubsystem = QueryInstance.World ? QueryInstance.World->GetSubsystem<UShooterCoverPointSubsystem>() : nullptr;
+
+	if (!CoverSubsystem || !CoverSubsystem->HasCoverData())
+	{
+		return;
+	}
+
+	UObject* BindOwner = QueryInstance.Owner.Get();
+	SearchRadius.BindData(BindOwner, QueryInstance.QueryID);
+	const float RadiusValue = SearchRadius.GetValue();
+
+	TArray<FVector> ContextLocations;
+	QueryInstance.PrepareContext(GenerateAround, ContextLocations);
+
+	TArray<FVector> ThreatLocations;
+	if (bRequireProtection)
+	{
+		QueryInstance.PrepareContext(ThreatContext, ThreatLocations);
+
+		// no known threat means nothing to take cover from, so fail the query rather than pass every point
+		if (ThreatLocations.IsEmpty())
+		{
+			return;
+		}
+	}
+
+	TArray<FShooterCoverPoint> CoverPoints;
+	for (const FVector& ContextLocation : ContextLocations)
+	{
+		CoverSubsystem->GatherPoints(ContextLocation, RadiusValue, CoverPoints);
+	}
+
+	// overlapping contexts gather the same points more than once
+	TSet<FVector3f> SeenLocations;
+	if (ContextLocations.Num() > 1)
+	{
+		SeenLocations.Reserve(CoverPoints.Num());
+	}
+
+	TArray<FNavLocation> NavPoints;
+	NavPoints.Reserve(CoverPoints.Num());
+
+	for (const FShooterCoverPoint& Point : CoverPoints)
+	{
+		if (ContextLocations.Num() > 1)
+		{
+			bool bAlreadySeen = false;
+			SeenLocations.Add(Point.Location, &bAlreadySeen);
+
+			if (bAlreadySeen)
+			{
+				continue;
+			}
+		}
+
+		// the point needs to be protected from every threat
+		const bool bProtected = Algo::AllOf(ThreatLocations, [&Point](const FVector& ThreatLocation)
+		{
+			return Point.IsProtectedFrom(ThreatLocation);
+		});
+
+		if (bProtected)
+		{
+			NavPoints.Add(FNavLocation(FVector(Point.Location)));
+		}
+	}
+
+	// only project if the query asks for it, e.g. to catch navmesh changes since the bake
+	if (ProjectionData.TraceMode != EEnvQueryTrace::None)
+	{
+		ProjectAndFilterNavPoints(NavPoints, QueryInstance);
+	}
+
+	StoreNavPoints(NavPoints, QueryInstance);
+}
+
+FText UEnvQueryGenerator_CoverPoints::GetDescriptionTitle() const
+{
+	return FText::Format(FText::FromString(TEXT("Baked Cover around {0}")), UEnvQueryTypes::DescribeContext(GenerateAround));
+}
+
+FText UEnvQueryGenerator_CoverPoints::GetDescriptionDetails() const
+{
+	if (bRequireProtection)
+	{
+		return FText::Format(FText::FromString(TEXT("radius: {0}, protected from {1}")), FText::FromString(SearchRadius.ToString()), UEnvQueryTypes::DescribeContext(ThreatContext));
+	}
+
+	return FText::Format(FText::FromString(TEXT("radius: {0}")), FText::FromString(SearchRadius.ToString()));
+}
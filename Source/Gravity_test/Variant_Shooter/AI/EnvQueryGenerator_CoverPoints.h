@@ -0,0 +1,46 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DataProviders/AIDataProvider.h"
+#include "EnvironmentQuery/Generators/EnvQueryGenerator_ProjectedPoints.h"
+#include "EnvQueryGenerator_CoverPoints.generated.h"
+
+/**
+ *  EnvQuery Generator that returns baked cover points around a context
+ *  Points are read from the cover point databases loaded with the level, so no traces are run at query time
+ */
+UCLASS(meta = (DisplayName = "Points: Baked Cover"))
+class GRAVITY_TEST_API UEnvQueryGenerator_CoverPoints : public UEnvQueryGenerator_ProjectedPoints
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Context to search around */
+	UPROPERTY(EditDefaultsOnly, Category="Generator")
+	TSubclassOf<UEnvQueryContext> GenerateAround;
+
+	/** Search radius around the context */
+	UPROPERTY(EditDefaultsOnly, Category="Generator")
+	FAIDataProviderFloatValue SearchRadius;
+
+	/** Context the cover points need to be protected from */
+	UPROPERTY(EditDefaultsOnly, Category="Generator")
+	TSubclassOf<UEnvQueryContext> ThreatContext;
+
+	/** If true, only points protected from every threat location are returned, and nothing is returned without a threat */
+	UPROPERTY(EditDefaultsOnly, Category="Generator")
+	bool bRequireProtection = true;
+
+public:
+
+	/** Constructor */
+	UEnvQueryGenerator_CoverPoints(const FObjectInitializer& ObjectInitializer);
+
+	/** Generates the cover point items */
+	virtual void GenerateItems(FEnvQueryInstance& QueryInstance) const override;
+
+	/** Provides the description strings */
+	virtual FText GetDescriptionTitle() const override;
+	virtual FText GetDescriptionDetails() const override;
+};
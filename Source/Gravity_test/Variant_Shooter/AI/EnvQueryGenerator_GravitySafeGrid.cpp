@@ -0,0 +1,68 @@
+#include "EnvQueryGenerator_GravitySafeGrid.h"
+#include "EnvironmentQuery/Contexts/EnvQueryContext_Querier.h"
+#include "Engine/World.h"
+#include "GravityWellSubsystem.h"
+
+UEnvQueryGenerator_GravitySafeGrid::UEnvQueryGenerator_GravitySafeGrid(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	GenerateAround = UEnvQueryContext_Querier::StaticClass();
+}
+
+void UEnvQueryGenerator_GravitySafeGrid::GenerateItems(FEnvQueryInstance& QueryInstance) const
+{
+	UObject* BindOwner = QueryInstance.Owner.Get();
+	GridSize.BindData(BindOwner, QueryInstance.QueryID);
+	SpaceBetween.BindData(BindOwner, QueryInstance.QueryID);
+
+	const float RadiusValue = GridSize.GetValue();
+	const float DensityValue = SpaceBetween.GetValue();
+
+	if (DensityValue <= 0.0f)
+	{
+		return;
+	}
+
+	const int32 ItemCount = FPlatformMath::TruncToInt((RadiusValue * 2.0f / DensityValue) + 1);
+	const int32 ItemCountHalf = ItemCount / 2;
+
+	TArray<FVector> ContextLocations;
+	QueryInstance.PrepareContext(GenerateAround, ContextLocations);
+
+	TArray<FNavLocation> GridPoints;
+	GridPoints.Reserve(ItemCount * ItemCount * ContextLocations.Num());
+
+	for (const FVector& ContextLocation : ContextLocations)
+	{
+		for (int32 IndexX = 0; IndexX < ItemCount; ++IndexX)
+		{
+			for (int32 IndexY = 0; IndexY < ItemCount; ++IndexY)
+			{
+				GridPoints.Add(FNavLocation(ContextLocation - FVector(DensityValue * (IndexX - ItemCountHalf), DensityValue * (IndexY - ItemCountHalf), 0.0f)));
+			}
+		}
+	}
+
+	ProjectAndFilterNavPoints(GridPoints, QueryInstance);
+
+	// remove any points that landed inside a well core
+	if (UGravityWellSubsystem* GravitySubsystem = QueryInstance.World ? QueryInstance.World->GetSubsystem<UGravityWellSubsystem>() : nullptr)
+	{
+		const FGravityFieldGrid& Field = GravitySubsystem->GetFieldGrid();
+
+		if (!Field.Cores.IsEmpty())
+		{
+			GridPoints.RemoveAllSwap([&Field, this](const FNavLocation& Point)
+			{
+				return Field.IsInsideCore(Point.Location, CoreMargin);
+			}, EAllowShrinking::No);
+		}
+	}
+
+	StoreNavPoints(GridPoints, QueryInstance);
+}
+
+FText UEnvQueryGenerator_GravitySafeGrid::GetDescriptionTitle() const
+{
+	return FText::Format(FText::FromString(TEXT("Gravity Safe {0}")), Super::GetDescriptionTitle());
+}
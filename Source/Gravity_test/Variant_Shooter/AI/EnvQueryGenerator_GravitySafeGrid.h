@@ -0,0 +1,32 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EnvironmentQuery/Generators/EnvQueryGenerator_SimpleGrid.h"
+#include "EnvQueryGenerator_GravitySafeGrid.generated.h"
+
+/**
+ *  Simple grid EnvQuery Generator that leaves out any points inside the core of an active gravity well
+ *  Core checks read the cached coarse field of the gravity well subsystem
+ */
+UCLASS(meta = (DisplayName = "Points: Gravity Safe Grid"))
+class GRAVITY_TEST_API UEnvQueryGenerator_GravitySafeGrid : public UEnvQueryGenerator_SimpleGrid
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Extra distance around each well core to exclude */
+	UPROPERTY(EditDefaultsOnly, Category="Generator", meta = (ClampMin = 0, Units = "cm"))
+	float CoreMargin = 100.0f;
+
+public:
+
+	/** Constructor */
+	UEnvQueryGenerator_GravitySafeGrid(const FObjectInitializer& ObjectInitializer);
+
+	/** Generates the grid items */
+	virtual void GenerateItems(FEnvQueryInstance& QueryInstance) const override;
+
+	/** Provides the description strings */
+	virtual FText GetDescriptionTitle() const override;
+};
@@ -0,0 +1,62 @@
+#include "EnvQueryTest_GravityDanger.h"
+#include "EnvironmentQuery/Items/EnvQueryItemType_VectorBase.h"
+#include "Engine/World.h"
+#include "GravityWellSubsystem.h"
+
+UEnvQueryTest_GravityDanger::UEnvQueryTest_GravityDanger(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	// a single grid lookup per item
+	Cost = EEnvTestCost::Low;
+	ValidItemType = UEnvQueryItemType_VectorBase::StaticClass();
+	SetWorkOnFloatValues(true);
+
+	// prefer items away from the wells
+	ScoringFactor.DefaultValue = -1.0f;
+}
+
+void UEnvQueryTest_GravityDanger::RunTest(FEnvQueryInstance& QueryInstance) const
+{
+	UObject* QueryOwner = QueryInstance.Owner.Get();
+	if (!QueryOwner)
+	{
+		return;
+	}
+
+	FloatValueMin.BindData(QueryOwner, QueryInstance.QueryID);
+	const float MinThresholdValue = FloatValueMin.GetValue();
+
+	FloatValueMax.BindData(QueryOwner, QueryInstance.QueryID);
+	const float MaxThresholdValue = FloatValueMax.GetValue();
+
+	UGravityWellSubsystem* GravitySubsystem = QueryInstance.World ? QueryInstance.World->GetSubsystem<UGravityWellSubsystem>() : nullptr;
+
+	// without a gravity subsystem every item is considered safe
+	if (!GravitySubsystem)
+	{
+		for (FEnvQueryInstance::ItemIterator It(this, QueryInstance); It; ++It)
+		{
+			It.SetScore(TestPurpose, FilterType, 0.0f, MinThresholdValue, MaxThresholdValue);
+		}
+		return;
+	}
+
+	// the cached field is rebuilt when wells come and go, never during the query
+	const FGravityFieldGrid& Field = GravitySubsystem->GetFieldGrid();
+
+	for (FEnvQueryInstance::ItemIterator It(this, QueryInstance); It; ++It)
+	{
+		const FVector ItemLocation = GetItemLocation(QueryInstance, It.GetIndex());
+		It.SetScore(TestPurpose, FilterType, Field.SampleMagnitude(ItemLocation), MinThresholdValue, MaxThresholdValue);
+	}
+}
+
+FText UEnvQueryTest_GravityDanger::GetDescriptionTitle() const
+{
+	return FText::FromString(TEXT("Gravity Danger"));
+}
+
+FText UEnvQueryTest_GravityDanger::GetDescriptionDetails() const
+{
+	return DescribeFloatTestParams();
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EnvironmentQuery/EnvQueryTest.h"
+#include "EnvQueryTest_GravityDanger.generated.h"
+
+/**
+ *  EnvQuery Test that scores items by the gravity field magnitude at their location
+ *  Reads the cached coarse field of the gravity well subsystem, so its cost doesn't grow with the number of wells
+ *  Prefers low danger items by default
+ */
+UCLASS()
+class GRAVITY_TEST_API UEnvQueryTest_GravityDanger : public UEnvQueryTest
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Constructor */
+	UEnvQueryTest_GravityDanger(const FObjectInitializer& ObjectInitializer);
+
+protected:
+
+	/** Scores or filters the query items */
+	virtual void RunTest(FEnvQueryInstance& QueryInstance) const override;
+
+	/** Provides the description strings */
+	virtual FText GetDescriptionTitle() const override;
+	virtual FText GetDescriptionDetails() const override;
+};
@@ -7,6 +7,8 @@
 #include "Perception/AIPerceptionComponent.h"
 #include "Navigation/PathFollowingComponent.h"
 #include "AI/Navigation/PathFollowingAgentInterface.h"
+#include "Perception/AISenseConfig.h"
+#include "PerformanceGovernorSubsystem.h"
 
 AShooterAIController::AShooterAIController()
 {
@@ -29,15 +31,31 @@ void AShooterAIController::OnPossess(APawn* InPawn)
 	if (AShooterNPC* NPC = Cast<AShooterNPC>(InPawn))
 	{
 		// add the team tag to the pawn
-		NPC->Tags.Add(TeamTag);
+		NPC->Tags.AddUnique(TeamTag);
 
 		// subscribe to the pawn's OnDeath delegate
-		NPC->OnPawnDeath.AddDynamic(this, &AShooterAIController::OnPawnDeath);
+		NPC->OnPawnDeath.AddUniqueDynamic(this, &AShooterAIController::OnPawnDeath);
+	}
+
+	// start at the update rate the performance governor currently allows
+	if (const UPerformanceGovernorSubsystem* Governor = GetWorld()->GetSubsystem<UPerformanceGovernorSubsystem>())
+	{
+		SetLogicTickInterval(Governor->GetTierSettings().AITickInterval);
 	}
 }
 
 void AShooterAIController::OnPawnDeath()
 {
+	// pooled NPCs keep their controller so both can be reactivated together
+	if (const AShooterNPC* NPC = Cast<AShooterNPC>(GetPawn()))
+	{
+		if (NPC->IsPooled())
+		{
+			PauseForPool();
+			return;
+		}
+	}
+
 	// stop movement
 	GetPathFollowingComponent()->AbortMove(*this, FPathFollowingResultFlags::UserAbort);
 
@@ -51,6 +69,47 @@ void AShooterAIController::OnPawnDeath()
 	Destroy();
 }
 
+void AShooterAIController::PauseForPool()
+{
+	// stop movement
+	GetPathFollowingComponent()->AbortMove(*this, FPathFollowingResultFlags::UserAbort);
+
+	// stop StateTree logic
+	StateTreeAI->StopLogic(FString("Pooled"));
+
+	// stop sensing and drop anything we'd perceived
+	SetPerceptionEnabled(false);
+	AIPerception->ForgetAll();
+
+	ClearCurrentTarget();
+}
+
+void AShooterAIController::ResumeFromPool()
+{
+	// start sensing again
+	SetPerceptionEnabled(true);
+	AIPerception->RequestStimuliListenerUpdate();
+
+	// restart StateTree logic from its root state
+	StateTreeAI->StartLogic();
+}
+
+void AShooterAIController::SetLogicTickInterval(float Interval)
+{
+	StateTreeAI->SetComponentTickInterval(Interval);
+}
+
+void AShooterAIController::SetPerceptionEnabled(bool bEnabled)
+{
+	for (auto It = AIPerception->GetSensesConfigIterator(); It; ++It)
+	{
+		if (const UAISenseConfig* SenseConfig = *It)
+		{
+			AIPerception->SetSenseEnabled(SenseConfig->GetSenseImplementation(), bEnabled);
+		}
+	}
+}
+
 void AShooterAIController::SetCurrentTarget(AActor* Target)
 {
 	TargetEnemy = Target;
@@ -58,7 +58,7 @@ protected:
 
 protected:
 
-	/** Called when the possessed pawn dies */
+	/** Called when the possessed pawn dies. Pauses the controller if the NPC is pooled, otherwise unpossesses it and destroys the controller */
 	UFUNCTION()
 	void OnPawnDeath();
 
@@ -73,6 +73,20 @@ public:
 	/** Returns the targeted enemy */
 	AActor* GetCurrentTarget() const { return TargetEnemy; };
 
+	/** Stops the StateTree and perception while the possessed NPC is dormant in the pool */
+	void PauseForPool();
+
+	/** Restarts the StateTree and perception after the possessed NPC is reactivated from the pool */
+	void ResumeFromPool();
+
+	/** Sets the seconds between StateTree updates. 0 updates every frame. Set by the performance governor */
+	void SetLogicTickInterval(float Interval);
+
+protected:
+
+	/** Enables or disables every configured perception sense */
+	void SetPerceptionEnabled(bool bEnabled);
+
 protected:
 
 	/** Called when the AI perception component updates a perception on a given actor */
@@ -0,0 +1,47 @@
+#include "ShooterBakeWorld.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "UObject/Package.h"
+#include "Gravity_test.h"
+
+UWorld* ShooterBakeWorld::Load(const FString& MapName)
+{
+	UPackage* MapPackage = LoadPackage(nullptr, *MapName, LOAD_None);
+	UWorld* World = MapPackage ? UWorld::FindWorldInPackage(MapPackage) : nullptr;
+
+	if (!World)
+	{
+		UE_LOG(LogGravity_test, Error, TEXT("Could not load map %s for baking."), *MapName);
+		return nullptr;
+	}
+
+	World->AddToRoot();
+	World->WorldType = EWorldType::Editor;
+
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Editor);
+	WorldContext.SetCurrentWorld(World);
+
+	if (!World->bIsWorldInitialized)
+	{
+		World->InitWorld(UWorld::InitializationValues()
+			.ShouldSimulatePhysics(false)
+			.EnableTraceCollision(true)
+			.CreateNavigation(true)
+			.CreateAISystem(false)
+			.AllowAudioPlayback(false));
+	}
+
+	World->UpdateWorldComponents(true, false);
+
+	return World;
+}
+
+void ShooterBakeWorld::Release(UWorld* World)
+{
+	if (World)
+	{
+		GEngine->DestroyWorldContext(World);
+		World->DestroyWorld(false);
+		World->RemoveFromRoot();
+	}
+}
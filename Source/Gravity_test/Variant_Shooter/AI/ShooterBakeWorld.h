@@ -0,0 +1,17 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UWorld;
+
+/**
+ *  Helpers shared by the offline AI bake commandlets
+ */
+namespace ShooterBakeWorld
+{
+	/** Loads a map and initializes its world far enough for traces and navmesh queries. Returns nullptr on failure */
+	GRAVITY_TEST_API UWorld* Load(const FString& MapName);
+
+	/** Tears down a world returned by Load */
+	GRAVITY_TEST_API void Release(UWorld* World);
+}
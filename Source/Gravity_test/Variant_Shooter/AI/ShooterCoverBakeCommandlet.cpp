@@ -0,0 +1,73 @@
+#include "ShooterCoverBakeCommandlet.h"
+#include "ShooterCoverPointVolume.h"
+#include "ShooterCoverPointDatabase.h"
+#include "ShooterBakeWorld.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "Misc/PackageName.h"
+#include "UObject/Package.h"
+#include "UObject/SavePackage.h"
+#include "Gravity_test.h"
+
+UShooterCoverBakeCommandlet::UShooterCoverBakeCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UShooterCoverBakeCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+	FString MapName;
+	if (!FParse::Value(*Params, TEXT("Map="), MapName))
+	{
+		UE_LOG(LogGravity_test, Error, TEXT("ShooterCoverBake: missing -Map=<long package name>."));
+		return 1;
+	}
+
+	UWorld* World = ShooterBakeWorld::Load(MapName);
+	if (!World)
+	{
+		return 1;
+	}
+
+	int32 NumFailed = 0;
+	TSet<UShooterCoverPointDatabase*> BakedDatabases;
+
+	for (TActorIterator<AShooterCoverPointVolume> It(World); It; ++It)
+	{
+		It->BakeCoverPoints();
+
+		// save even when nothing was found, so an empty rebake clears the points baked before
+		if (UShooterCoverPointDatabase* Database = It->GetDatabase())
+		{
+			BakedDatabases.Add(Database);
+		}
+	}
+
+	for (UShooterCoverPointDatabase* Database : BakedDatabases)
+	{
+		UPackage* DatabasePackage = Database->GetPackage();
+		const FString Filename = FPackageName::LongPackageNameToFilename(DatabasePackage->GetName(), FPackageName::GetAssetPackageExtension());
+
+		FSavePackageArgs SaveArgs;
+		SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+
+		if (!UPackage::SavePackage(DatabasePackage, Database, *Filename, SaveArgs))
+		{
+			UE_LOG(LogGravity_test, Error, TEXT("ShooterCoverBake: failed to save %s."), *Filename);
+			++NumFailed;
+		}
+	}
+
+	UE_LOG(LogGravity_test, Display, TEXT("ShooterCoverBake: saved %d cover databases for %s."), BakedDatabases.Num() - NumFailed, *MapName);
+
+	ShooterBakeWorld::Release(World);
+
+	return NumFailed > 0 ? 1 : 0;
+#else
+	return 1;
+#endif
+}
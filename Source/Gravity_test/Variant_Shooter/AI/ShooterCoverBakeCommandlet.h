@@ -0,0 +1,23 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ShooterCoverBakeCommandlet.generated.h"
+
+/**
+ *  Bakes the cover points of every cover point volume in a level and saves their databases
+ *  Usage: -run=ShooterCoverBake -Map=/Game/Path/To/Level
+ */
+UCLASS()
+class GRAVITY_TEST_API UShooterCoverBakeCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Constructor */
+	UShooterCoverBakeCommandlet();
+
+	/** Runs the bake */
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,103 @@
+#include "ShooterCoverPointDatabase.h"
+#include "Algo/BinarySearch.h"
+
+int32 FShooterCoverPoint::GetSector(const FVector& Direction)
+{
+	const float SectorSize = 360.0f / NumSectors;
+	const float Yaw = FRotator::ClampAxis(FMath::RadiansToDegrees(FMath::Atan2(Direction.Y, Direction.X)) + SectorSize * 0.5f);
+
+	return FMath::Min(FMath::FloorToInt32(Yaw / SectorSize), NumSectors - 1);
+}
+
+bool FShooterCoverPoint::IsProtectedFrom(const FVector& ThreatLocation) const
+{
+	const FVector ToThreat = ThreatLocation - FVector(Location);
+	return (ProtectedSectors & (1 << GetSector(ToThreat))) != 0;
+}
+
+void UShooterCoverPointDatabase::SetPoints(TArray<FShooterCoverPoint>&& InPoints)
+{
+	Points = MoveTemp(InPoints);
+	RebuildIndex();
+}
+
+void UShooterCoverPointDatabase::PostLoad()
+{
+	Super::PostLoad();
+
+	RebuildIndex();
+}
+
+void UShooterCoverPointDatabase::RebuildIndex()
+{
+	Cells.Reset();
+
+	// sort the points so every cell is a contiguous range
+	Points.Sort([this](const FShooterCoverPoint& A, const FShooterCoverPoint& B)
+	{
+		return GetCellKey(A.Location) < GetCellKey(B.Location);
+	});
+
+	for (int32 Index = 0; Index < Points.Num(); ++Index)
+	{
+		const int64 Key = GetCellKey(Points[Index].Location);
+
+		if (Cells.IsEmpty() || Cells.Last().Key != Key)
+		{
+			FShooterCoverCell& Cell = Cells.AddDefaulted_GetRef();
+			Cell.Key = Key;
+			Cell.FirstPoint = Index;
+		}
+
+		++Cells.Last().NumPoints;
+	}
+
+	Points.Shrink();
+	Cells.Shrink();
+}
+
+void UShooterCoverPointDatabase::GatherPoints(const FVector& Center, float Radius, TArray<FShooterCoverPoint>& OutPoints) const
+{
+	if (Cells.IsEmpty())
+	{
+		return;
+	}
+
+	const int32 MinX = FMath::FloorToInt32((Center.X - Radius) / CellSize);
+	const int32 MaxX = FMath::FloorToInt32((Center.X + Radius) / CellSize);
+	const int32 MinY = FMath::FloorToInt32((Center.Y - Radius) / CellSize);
+	const int32 MaxY = FMath::FloorToInt32((Center.Y + Radius) / CellSize);
+	const int32 MinZ = FMath::FloorToInt32((Center.Z - Radius) / CellSize);
+	const int32 MaxZ = FMath::FloorToInt32((Center.Z + Radius) / CellSize);
+	const float RadiusSq = FMath::Square(Radius);
+
+	for (int32 X = MinX; X <= MaxX; ++X)
+	{
+		for (int32 Y = MinY; Y <= MaxY; ++Y)
+		{
+			// the cells of an XY column are adjacent in the sorted array
+			int32 CellIndex = Algo::LowerBoundBy(Cells, MakeCellKey(X, Y, MinZ), &FShooterCoverCell::Key);
+			const int64 LastKey = MakeCellKey(X, Y, MaxZ);
+
+			for (; CellIndex < Cells.Num() && Cells[CellIndex].Key <= LastKey; ++CellIndex)
+			{
+				const FShooterCoverCell& Cell = Cells[CellIndex];
+
+				for (int32 PointIndex = Cell.FirstPoint; PointIndex < Cell.FirstPoint + Cell.NumPoints; ++PointIndex)
+				{
+					const FShooterCoverPoint& Point = Points[PointIndex];
+
+					if (FVector::DistSquared(FVector(Point.Location), Center) <= RadiusSq)
+					{
+						OutPoints.Add(Point);
+					}
+				}
+			}
+		}
+	}
+}
+
+int64 UShooterCoverPointDatabase::GetCellKey(const FVector3f& Location) const
+{
+	return MakeCellKey(FMath::FloorToInt32(Location.X / CellSize), FMath::FloorToInt32(Location.Y / CellSize), FMath::FloorToInt32(Location.Z / CellSize));
+}
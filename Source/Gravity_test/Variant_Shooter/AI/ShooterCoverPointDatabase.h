@@ -0,0 +1,110 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "ShooterCoverPointDatabase.generated.h"
+
+/**
+ *  A single baked cover point
+ *  Protection is stored as a bitmask of horizontal yaw sectors that are blocked by geometry
+ */
+USTRUCT()
+struct FShooterCoverPoint
+{
+	GENERATED_BODY()
+
+	/** Number of yaw sectors covered by the protection mask */
+	static constexpr int32 NumSectors = 16;
+
+	/** Navmesh location of the cover point */
+	UPROPERTY()
+	FVector3f Location = FVector3f::ZeroVector;
+
+	/** One bit per yaw sector, set when the point is protected from that direction */
+	UPROPERTY()
+	uint16 ProtectedSectors = 0;
+
+	/** Returns the yaw sector a horizontal direction falls into */
+	static int32 GetSector(const FVector& Direction);
+
+	/** Returns true if this point is protected from a threat at the given location */
+	bool IsProtectedFrom(const FVector& ThreatLocation) const;
+};
+
+/**
+ *  A cell of the cover point spatial index
+ *  Points in a cell are stored contiguously in the database point array
+ */
+USTRUCT()
+struct FShooterCoverCell
+{
+	GENERATED_BODY()
+
+	/** Packed 3D cell coordinates. Cells are sorted by this key */
+	int64 Key = 0;
+
+	/** Index of the first point in the cell */
+	int32 FirstPoint = 0;
+
+	/** Number of points in the cell */
+	int32 NumPoints = 0;
+};
+
+/**
+ *  Baked cover points for a level, indexed on a sorted 3D grid so stacked floors land in separate cells
+ *  Built offline by AShooterCoverPointVolume and the ShooterCoverBake commandlet. The index isn't saved,
+ *  it's rebuilt from the sorted points on load
+ */
+UCLASS(BlueprintType)
+class GRAVITY_TEST_API UShooterCoverPointDatabase : public UDataAsset
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Edge length of the index cells. Fixed, the stored points are sorted by it */
+	UPROPERTY(VisibleAnywhere, Category="Cover", meta = (ClampMin = 100, Units = "cm"))
+	float CellSize = 1000.0f;
+
+	/** Cover points, sorted by cell */
+	UPROPERTY(VisibleAnywhere, Category="Cover")
+	TArray<FShooterCoverPoint> Points;
+
+	/** Non-empty index cells, sorted by key */
+	TArray<FShooterCoverCell> Cells;
+
+public:
+
+	/** Replaces the stored points and rebuilds the spatial index */
+	void SetPoints(TArray<FShooterCoverPoint>&& InPoints);
+
+	/** Adds every point within Radius of Center to the output array */
+	void GatherPoints(const FVector& Center, float Radius, TArray<FShooterCoverPoint>& OutPoints) const;
+
+	/** Returns the number of stored points */
+	int32 GetNumPoints() const { return Points.Num(); }
+
+	//~Begin UObject interface
+	virtual void PostLoad() override;
+	//~End UObject interface
+
+protected:
+
+	/** Sorts the points by cell and rebuilds the index cells */
+	void RebuildIndex();
+
+	/** Bits per coordinate of a packed cell key */
+	static constexpr int32 CellKeyBits = 21;
+
+	/** Packs 3D cell coordinates into a key that sorts by X, then Y, then Z, so the cells of an XY column are adjacent.
+	 *  Coordinates are biased so negative ones sort first */
+	static int64 MakeCellKey(int32 X, int32 Y, int32 Z)
+	{
+		constexpr int32 Bias = 1 << (CellKeyBits - 1);
+		const auto Pack = [](int32 Coord) { return int64(FMath::Clamp(Coord, -Bias, Bias - 1) + Bias); };
+		return (Pack(X) << (CellKeyBits * 2)) | (Pack(Y) << CellKeyBits) | Pack(Z);
+	}
+
+	/** Returns the key of the cell containing a location */
+	int64 GetCellKey(const FVector3f& Location) const;
+};
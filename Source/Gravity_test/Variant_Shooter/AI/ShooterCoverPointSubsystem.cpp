@@ -0,0 +1,28 @@
+#include "ShooterCoverPointSubsystem.h"
+#include "ShooterCoverPointDatabase.h"
+
+void UShooterCoverPointSubsystem::RegisterDatabase(const UShooterCoverPointDatabase* Database)
+{
+	if (Database)
+	{
+		Databases.AddUnique(Database);
+	}
+}
+
+void UShooterCoverPointSubsystem::UnregisterDatabase(const UShooterCoverPointDatabase* Database)
+{
+	Databases.RemoveSingleSwap(Database);
+}
+
+void UShooterCoverPointSubsystem::GatherPoints(const FVector& Center, float Radius, TArray<FShooterCoverPoint>& OutPoints) const
+{
+	for (const UShooterCoverPointDatabase* Database : Databases)
+	{
+		Database->GatherPoints(Center, Radius, OutPoints);
+	}
+}
+
+bool UShooterCoverPointSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
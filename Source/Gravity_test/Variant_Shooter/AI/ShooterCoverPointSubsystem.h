@@ -0,0 +1,42 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShooterCoverPointSubsystem.generated.h"
+
+class UShooterCoverPointDatabase;
+struct FShooterCoverPoint;
+
+/**
+ *  Tracks the baked cover point databases loaded with the current level
+ *  Databases are registered by the cover point volumes placed in the level
+ */
+UCLASS()
+class GRAVITY_TEST_API UShooterCoverPointSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** Databases of the loaded cover point volumes */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<const UShooterCoverPointDatabase>> Databases;
+
+public:
+
+	/** Registers a cover point database */
+	void RegisterDatabase(const UShooterCoverPointDatabase* Database);
+
+	/** Unregisters a cover point database */
+	void UnregisterDatabase(const UShooterCoverPointDatabase* Database);
+
+	/** Adds every registered cover point within Radius of Center to the output array */
+	void GatherPoints(const FVector& Center, float Radius, TArray<FShooterCoverPoint>& OutPoints) const;
+
+	/** Returns true if any cover data is loaded */
+	bool HasCoverData() const { return !Databases.IsEmpty(); }
+
+protected:
+
+	//~Begin UWorldSubsystem interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~End UWorldSubsystem interface
+};
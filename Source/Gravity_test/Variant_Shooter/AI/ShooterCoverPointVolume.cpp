@@ -0,0 +1,136 @@
+#include "ShooterCoverPointVolume.h"
+#include "ShooterCoverPointDatabase.h"
+#include "ShooterCoverPointSubsystem.h"
+#include "Components/BoxComponent.h"
+#include "Engine/World.h"
+#include "NavigationSystem.h"
+#include "Gravity_test.h"
+
+AShooterCoverPointVolume::AShooterCoverPointVolume()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	BakeBounds = CreateDefaultSubobject<UBoxComponent>(TEXT("Bake Bounds"));
+	SetRootComponent(BakeBounds);
+
+	BakeBounds->SetBoxExtent(FVector(2000.0f, 2000.0f, 500.0f));
+	BakeBounds->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	BakeBounds->SetCanEverAffectNavigation(false);
+	BakeBounds->bHiddenInGame = true;
+}
+
+void AShooterCoverPointVolume::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (UShooterCoverPointSubsystem* CoverSubsystem = GetWorld()->GetSubsystem<UShooterCoverPointSubsystem>())
+	{
+		CoverSubsystem->RegisterDatabase(Database);
+	}
+}
+
+void AShooterCoverPointVolume::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UShooterCoverPointSubsystem* CoverSubsystem = GetWorld()->GetSubsystem<UShooterCoverPointSubsystem>())
+	{
+		CoverSubsystem->UnregisterDatabase(Database);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+#if WITH_EDITOR
+
+int32 AShooterCoverPointVolume::BakeCoverPoints()
+{
+	UWorld* World = GetWorld();
+	UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(World);
+
+	if (!Database || !NavSys)
+	{
+		UE_LOG(LogGravity_test, Warning, TEXT("%s: cover bake needs a database asset and a navigation system."), *GetName());
+		return 0;
+	}
+
+	const FBox Bounds = BakeBounds->Bounds.GetBox();
+	const FVector ProjectionExtent(SampleSpacing * 0.5f, SampleSpacing * 0.5f, FloorSpacing * 0.5f);
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ShooterCoverBake), false);
+	QueryParams.bIgnoreTouches = true;
+
+	// sample candidates on the navmesh slice by slice so every floor of a column gets its own points,
+	// keeping at most one per sample cell
+	TSet<FIntVector> SampledCells;
+	TArray<FShooterCoverPoint> BakedPoints;
+
+	for (float X = Bounds.Min.X; X <= Bounds.Max.X; X += SampleSpacing)
+	{
+		for (float Y = Bounds.Min.Y; Y <= Bounds.Max.Y; Y += SampleSpacing)
+		{
+			for (float Z = Bounds.Min.Z + FloorSpacing * 0.5f; Z - FloorSpacing * 0.5f <= Bounds.Max.Z; Z += FloorSpacing)
+			{
+				FNavLocation NavLocation;
+				if (!NavSys->ProjectPointToNavigation(FVector(X, Y, Z), NavLocation, ProjectionExtent))
+				{
+					continue;
+				}
+
+				const FIntVector SampleCell(
+					FMath::FloorToInt32(NavLocation.Location.X / SampleSpacing),
+					FMath::FloorToInt32(NavLocation.Location.Y / SampleSpacing),
+					FMath::FloorToInt32(NavLocation.Location.Z / FloorSpacing));
+
+				bool bAlreadySampled = false;
+				SampledCells.Add(SampleCell, &bAlreadySampled);
+
+				if (bAlreadySampled)
+				{
+					continue;
+				}
+
+				// probe each yaw sector for nearby blocking geometry
+				const FVector ProbeStart = NavLocation.Location + FVector::UpVector * ProbeHeight;
+				uint16 ProtectedSectors = 0;
+
+				for (int32 Sector = 0; Sector < FShooterCoverPoint::NumSectors; ++Sector)
+				{
+					const float Yaw = Sector * (360.0f / FShooterCoverPoint::NumSectors);
+					const FVector ProbeEnd = ProbeStart + FRotator(0.0f, Yaw, 0.0f).Vector() * ProbeDistance;
+
+					if (World->LineTraceTestByChannel(ProbeStart, ProbeEnd, ECC_Visibility, QueryParams))
+					{
+						ProtectedSectors |= 1 << Sector;
+					}
+				}
+
+				// skip open ground and fully enclosed spots
+				const int32 NumProtected = FMath::CountBits(ProtectedSectors);
+
+				if (NumProtected < MinProtectedSectors || NumProtected == FShooterCoverPoint::NumSectors)
+				{
+					continue;
+				}
+
+				FShooterCoverPoint& Point = BakedPoints.AddDefaulted_GetRef();
+				Point.Location = FVector3f(NavLocation.Location);
+				Point.ProtectedSectors = ProtectedSectors;
+			}
+		}
+	}
+
+	const int32 NumBaked = BakedPoints.Num();
+
+	Database->Modify();
+	Database->SetPoints(MoveTemp(BakedPoints));
+
+	UE_LOG(LogGravity_test, Log, TEXT("%s: baked %d cover points into %s."), *GetName(), NumBaked, *GetNameSafe(Database));
+
+	return NumBaked;
+}
+
+void AShooterCoverPointVolume::BakeCoverPointsInEditor()
+{
+	BakeCoverPoints();
+}
+
+#endif
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "ShooterCoverPointVolume.generated.h"
+
+class UBoxComponent;
+class UShooterCoverPointDatabase;
+
+/**
+ *  Placed in a level to bake cover points inside its bounds and load them with the map
+ *  Bake from the details panel or through the ShooterCoverBake commandlet
+ */
+UCLASS()
+class GRAVITY_TEST_API AShooterCoverPointVolume : public AActor
+{
+	GENERATED_BODY()
+
+	/** Area to bake cover points in */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Components", meta = (AllowPrivateAccess = "true"))
+	TObjectPtr<UBoxComponent> BakeBounds;
+
+protected:
+
+	/** Baked cover points. Loaded together with the level */
+	UPROPERTY(EditAnywhere, Category="Cover")
+	TObjectPtr<UShooterCoverPointDatabase> Database;
+
+	/** Distance between sampled candidate points */
+	UPROPERTY(EditAnywhere, Category="Cover|Bake", meta = (ClampMin = 25, Units = "cm"))
+	float SampleSpacing = 100.0f;
+
+	/** Height of the slices the volume is sampled in. Every slice finds its own floor, so keep it below the storey height */
+	UPROPERTY(EditAnywhere, Category="Cover|Bake", meta = (ClampMin = 50, Units = "cm"))
+	float FloorSpacing = 200.0f;
+
+	/** Height above the navmesh of the protection probes */
+	UPROPERTY(EditAnywhere, Category="Cover|Bake", meta = (ClampMin = 0, Units = "cm"))
+	float ProbeHeight = 60.0f;
+
+	/** Max distance from the point to geometry that still counts as cover */
+	UPROPERTY(EditAnywhere, Category="Cover|Bake", meta = (ClampMin = 10, Units = "cm"))
+	float ProbeDistance = 120.0f;
+
+	/** Candidates protected from fewer sectors than this are discarded */
+	UPROPERTY(EditAnywhere, Category="Cover|Bake", meta = (ClampMin = 1, ClampMax = 15))
+	int32 MinProtectedSectors = 2;
+
+public:
+
+	/** Constructor */
+	AShooterCoverPointVolume();
+
+	/** Returns the cover database */
+	UShooterCoverPointDatabase* GetDatabase() const { return Database; }
+
+#if WITH_EDITOR
+	/** Bakes the cover points inside the volume into the database. Returns the number of baked points */
+	int32 BakeCoverPoints();
+
+	/** Editor button to bake the cover points */
+	UFUNCTION(CallInEditor, Category="Cover|Bake", meta = (DisplayName = "Bake Cover Points"))
+	void BakeCoverPointsInEditor();
+#endif
+
+protected:
+
+	/** Registers the database with the cover subsystem */
+	virtual void BeginPlay() override;
+
+	/** Unregisters the database from the cover subsystem */
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+};
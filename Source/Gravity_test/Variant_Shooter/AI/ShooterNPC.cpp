@@ -5,18 +5,61 @@
 #include "ShooterWeapon.h"
 #include "Components/SkeletalMeshComponent.h"
 #include "Camera/CameraComponent.h"
-#include "Kismet/KismetMathLibrary.h"
 #include "Engine/World.h"
 #include "ShooterGameMode.h"
 #include "Components/CapsuleComponent.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "TimerManager.h"
+#include "ShooterAIController.h"
+#include "ShooterNPCPoolSubsystem.h"
+#include "ShooterRagdollSubsystem.h"
+#include "Perception/AIPerceptionSystem.h"
+#include "Perception/AISense_Sight.h"
+#include "SkeletalMeshComponentBudgeted.h"
+#include "Gravity_test.h"
+#include "GravityFlightRecorder.h"
+#include "ShooterRandomSubsystem.h"
+#include "ShooterReplaySubsystem.h"
+
+AShooterNPC::AShooterNPC(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer.SetDefaultSubobjectClass<USkeletalMeshComponentBudgeted>(ACharacter::MeshComponentName))
+{
+	// let the animation budget allocator decide how often the body mesh evaluates, based on its significance
+	USkeletalMeshComponentBudgeted* BudgetedMesh = CastChecked<USkeletalMeshComponentBudgeted>(GetMesh());
+	BudgetedMesh->SetAutoRegisterWithBudgetAllocator(true);
+	BudgetedMesh->SetAutoCalculateSignificance(true);
+	BudgetedMesh->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::OnlyTickMontagesWhenNotRendered;
+
+	// nobody ever looks through an NPC's eyes, so the first person meshes never tick or render
+	for (USkeletalMeshComponent* FirstPersonOnlyMesh : { GetFirstPersonMesh(), GetFirstPersonPistolMesh() })
+	{
+		FirstPersonOnlyMesh->PrimaryComponentTick.bCanEverTick = false;
+		FirstPersonOnlyMesh->SetHiddenInGame(true);
+	}
+
+	// the third person pistol only follows its hand socket
+	GetThirdPersonPistolMesh()->PrimaryComponentTick.bCanEverTick = false;
+}
 
 void AShooterNPC::BeginPlay()
 {
+	LLM_SCOPE_BYTAG(Shooter_AI);
+
 	Super::BeginPlay();
 
+	SightQueryParams = FCollisionQueryParams(SCENE_QUERY_STAT(ShooterNPCSight), false, this);
+
+	// a dedicated server never renders the body, so it would never refresh the hand bones the weapon muzzle follows
+	// and every shot would spawn from a stale pose. Clients and listen servers only see that while the NPC is off screen,
+	// where the mesh still moves and turns with the capsule
+	if (GetNetMode() == NM_DedicatedServer)
+	{
+		GetMesh()->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones;
+	}
+
 	// spawn the weapon
+	LLM_SCOPE_BYTAG(Shooter_Weapons);
+
 	FActorSpawnParameters SpawnParams;
 	SpawnParams.Owner = this;
 	SpawnParams.Instigator = this;
@@ -29,6 +72,12 @@ void AShooterNPC::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
 	Super::EndPlay(EndPlayReason);
 
+	// stop tracking our ragdoll
+	if (UShooterRagdollSubsystem* Ragdolls = GetWorld()->GetSubsystem<UShooterRagdollSubsystem>())
+	{
+		Ragdolls->ReleaseRagdoll(GetMesh());
+	}
+
 	// clear the death timer
 	GetWorld()->GetTimerManager().ClearTimer(DeathTimer);
 }
@@ -43,6 +92,7 @@ float AShooterNPC::TakeDamage(float Damage, struct FDamageEvent const& DamageEve
 
 	// Reduce HP
 	CurrentHP -= Damage;
+	GravityFlightRecorder::Record(GravityFlightRecorder::EEvent::Damage, this, DamageCauser, Damage, CurrentHP);
 
 	// Have we depleted HP?
 	if (CurrentHP <= 0.0f)
@@ -63,6 +113,9 @@ void AShooterNPC::AttachWeaponMeshes(AShooterWeapon* WeaponToAttach)
 	// attach the weapon meshes
 	WeaponToAttach->GetFirstPersonMesh()->AttachToComponent(GetFirstPersonMesh(), AttachmentRule, FirstPersonWeaponSocket);
 	WeaponToAttach->GetThirdPersonMesh()->AttachToComponent(GetMesh(), AttachmentRule, FirstPersonWeaponSocket);
+
+	// the weapon meshes only need to follow our hand socket
+	WeaponToAttach->SetMeshAnimationEnabled(false);
 }
 
 void AShooterNPC::PlayFiringMontage(UAnimMontage* Montage)
@@ -81,12 +134,40 @@ void AShooterNPC::UpdateWeaponHUD(int32 CurrentAmmo, int32 MagazineSize)
 }
 
 FVector AShooterNPC::GetWeaponTargetLocation()
+{
+	// calculate the unobstructed aim segment
+	FVector AimSource, AimTarget;
+	CalculateAimTrace(AimSource, AimTarget);
+
+	// run a visibility trace to see if there's obstructions
+	FHitResult OutHit;
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ShooterNPCAim), false, this);
+
+	GetWorld()->LineTraceSingleByChannel(OutHit, AimSource, AimTarget, ECC_Visibility, QueryParams);
+
+	// return either the impact point or the trace end
+	return OutHit.bBlockingHit ? OutHit.ImpactPoint : OutHit.TraceEnd;
+}
+
+bool AShooterNPC::GetDeferredAimTrace(FVector& OutStart, FVector& OutEnd)
+{
+	// NPC shots can always wait for the batched trace
+	CalculateAimTrace(OutStart, OutEnd);
+	return true;
+}
+
+void AShooterNPC::CalculateAimTrace(FVector& OutStart, FVector& OutEnd) const
 {
 	// start aiming from the camera location
 	const FVector AimSource = GetFirstPersonCameraComponent()->GetComponentLocation();
 
 	FVector AimDir, AimTarget = FVector::ZeroVector;
 
+	// draw aim randomness from this NPC's own stream so the same seed reproduces the same shots
+	FRandomStream& Random = UShooterRandomSubsystem::GetStream(this);
+	const float AimVarianceHalfAngleRad = FMath::DegreesToRadians(AimVarianceHalfAngle);
+
 	// do we have an aim target?
 	if (CurrentAimTarget)
 	{
@@ -94,33 +175,23 @@ FVector AShooterNPC::GetWeaponTargetLocation()
 		AimTarget = CurrentAimTarget->GetActorLocation();
 
 		// apply a vertical offset to target head/feet
-		AimTarget.Z += FMath::RandRange(MinAimOffsetZ, MaxAimOffsetZ);
+		AimTarget.Z += Random.FRandRange(MinAimOffsetZ, MaxAimOffsetZ);
 
 		// get the aim direction and apply randomness in a cone
 		AimDir = (AimTarget - AimSource).GetSafeNormal();
-		AimDir = UKismetMathLibrary::RandomUnitVectorInConeInDegrees(AimDir, AimVarianceHalfAngle);
+		AimDir = Random.VRandCone(AimDir, AimVarianceHalfAngleRad);
 
 		
 	} else {
 
 		// no aim target, so just use the camera facing
-		AimDir = UKismetMathLibrary::RandomUnitVectorInConeInDegrees(GetFirstPersonCameraComponent()->GetForwardVector(), AimVarianceHalfAngle);
+		AimDir = Random.VRandCone(GetFirstPersonCameraComponent()->GetForwardVector(), AimVarianceHalfAngleRad);
 
 	}
 
 	// calculate the unobstructed aim target location
-	AimTarget = AimSource + (AimDir * AimRange);
-
-	// run a visibility trace to see if there's obstructions
-	FHitResult OutHit;
-
-	FCollisionQueryParams QueryParams;
-	QueryParams.AddIgnoredActor(this);
-
-	GetWorld()->LineTraceSingleByChannel(OutHit, AimSource, AimTarget, ECC_Visibility, QueryParams);
-
-	// return either the impact point or the trace end
-	return OutHit.bBlockingHit ? OutHit.ImpactPoint : OutHit.TraceEnd;
+	OutStart = AimSource;
+	OutEnd = AimSource + (AimDir * AimRange);
 }
 
 void AShooterNPC::AddWeaponClass(const TSubclassOf<AShooterWeapon>& InWeaponClass)
@@ -158,6 +229,19 @@ void AShooterNPC::Die()
 
 	// raise the dead flag
 	bIsDead = true;
+	GravityFlightRecorder::Record(GravityFlightRecorder::EEvent::Death, this, nullptr, GetActorLocation());
+
+	// stop the trigger and drop any shot still waiting on its aim trace, the weapon stays in the corpse's hands
+	bIsShooting = false;
+
+	if (Weapon)
+	{
+		Weapon->StopFiring();
+		Weapon->CancelPendingShots();
+	}
+
+	// notify the controller. Controllers of pooled NPCs pause, all others unpossess and destroy themselves
+	OnPawnDeath.Broadcast();
 
 	// increment the team score
 	if (AShooterGameMode* GM = Cast<AShooterGameMode>(GetWorld()->GetAuthGameMode()))
@@ -172,10 +256,17 @@ void AShooterNPC::Die()
 	GetCharacterMovement()->StopMovementImmediately();
 	GetCharacterMovement()->StopActiveMovement();
 
-	// enable ragdoll physics on the third person mesh
-	GetMesh()->SetCollisionProfileName(RagdollCollisionProfile);
-	GetMesh()->SetSimulatePhysics(true);
-	GetMesh()->SetPhysicsBlendWeight(1.0f);
+	// enable ragdoll physics on the third person mesh. The ragdoll subsystem keeps the number of simulating corpses bounded
+	if (UShooterRagdollSubsystem* Ragdolls = GetWorld()->GetSubsystem<UShooterRagdollSubsystem>())
+	{
+		Ragdolls->RequestRagdoll(GetMesh(), RagdollCollisionProfile);
+
+	} else {
+
+		GetMesh()->SetCollisionProfileName(RagdollCollisionProfile);
+		GetMesh()->SetSimulatePhysics(true);
+		GetMesh()->SetPhysicsBlendWeight(1.0f);
+	}
 
 	// schedule actor destruction
 	GetWorld()->GetTimerManager().SetTimer(DeathTimer, this, &AShooterNPC::DeferredDestruction, DeferredDestructionTime, false);
@@ -183,14 +274,132 @@ void AShooterNPC::Die()
 
 void AShooterNPC::DeferredDestruction()
 {
+	// return pooled NPCs to the pool instead of destroying them
+	if (UShooterNPCPoolSubsystem* Pool = GetWorld()->GetSubsystem<UShooterNPCPoolSubsystem>())
+	{
+		if (Pool->ReleaseNPC(this))
+		{
+			return;
+		}
+	}
+
 	Destroy();
 }
 
+void AShooterNPC::EnterPoolDormancy()
+{
+	// ignore if already dormant
+	if (bIsDormant)
+	{
+		return;
+	}
+
+	bIsDormant = true;
+
+	// stop shooting and deactivate the weapon
+	bIsShooting = false;
+	CurrentAimTarget = nullptr;
+
+	if (Weapon)
+	{
+		Weapon->DeactivateWeapon();
+	}
+
+	GetWorld()->GetTimerManager().ClearTimer(DeathTimer);
+
+	// pause the AI. Dead NPCs already paused it from OnPawnDeath, so only prewarmed ones still need it
+	if (!bIsDead)
+	{
+		if (AShooterAIController* AIController = Cast<AShooterAIController>(GetController()))
+		{
+			AIController->PauseForPool();
+		}
+	}
+
+	// stop being seen by other AI
+	if (UAIPerceptionSystem* PerceptionSystem = UAIPerceptionSystem::GetCurrent(GetWorld()))
+	{
+		PerceptionSystem->UnregisterSource(*this);
+	}
+
+	// stop any ragdoll and snap the mesh back onto the capsule
+	if (UShooterRagdollSubsystem* Ragdolls = GetWorld()->GetSubsystem<UShooterRagdollSubsystem>())
+	{
+		Ragdolls->ReleaseRagdoll(GetMesh());
+	}
+
+	GetMesh()->SetSimulatePhysics(false);
+	GetMesh()->SetPhysicsBlendWeight(0.0f);
+	GetMesh()->SetCollisionProfileName(GetClass()->GetDefaultObject<AShooterNPC>()->GetMesh()->GetCollisionProfileName());
+	GetMesh()->AttachToComponent(GetCapsuleComponent(), FAttachmentTransformRules::KeepRelativeTransform);
+	GetMesh()->SetRelativeLocationAndRotation(GetBaseTranslationOffset(), GetBaseRotationOffset());
+
+	// disable movement, collision and rendering
+	GetCharacterMovement()->StopMovementImmediately();
+	GetCharacterMovement()->DisableMovement();
+	GetCharacterMovement()->SetComponentTickEnabled(false);
+	GetCapsuleComponent()->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+	SetActorTickEnabled(false);
+}
+
+void AShooterNPC::ReactivateFromPool(const FTransform& SpawnTransform)
+{
+	// ignore if we're not dormant
+	if (!bIsDormant)
+	{
+		return;
+	}
+
+	bIsDormant = false;
+
+	// reset the gameplay state
+	bIsDead = false;
+	bIsShooting = false;
+	CurrentHP = GetClass()->GetDefaultObject<AShooterNPC>()->CurrentHP;
+
+	// move to the spawn point
+	SetActorTransform(SpawnTransform, false, nullptr, ETeleportType::ResetPhysics);
+
+	// re-enable rendering, collision and movement
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+	SetActorTickEnabled(true);
+
+	GetCapsuleComponent()->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
+	GetCharacterMovement()->SetComponentTickEnabled(true);
+	GetCharacterMovement()->SetDefaultMovementMode();
+
+	// reload and reactivate the weapon
+	if (Weapon)
+	{
+		Weapon->RefillAmmo();
+		Weapon->ActivateWeapon();
+	}
+
+	// let other AI see us again
+	UAIPerceptionSystem::RegisterPerceptionStimuliSource(this, UAISense_Sight::StaticClass(), this);
+
+	// restart the AI
+	if (AShooterAIController* AIController = Cast<AShooterAIController>(GetController()))
+	{
+		AIController->ResumeFromPool();
+	}
+}
+
 void AShooterNPC::StartShooting(AActor* ActorToShoot)
 {
 	// save the aim target
 	CurrentAimTarget = ActorToShoot;
 
+	// let replays check this decision against the recorded match
+	if (UShooterReplaySubsystem* Replay = UShooterReplaySubsystem::Get(this))
+	{
+		Replay->RecordNpcDecision(this, ActorToShoot);
+	}
+
 	// raise the flag
 	bIsShooting = true;
 
@@ -203,6 +412,11 @@ void AShooterNPC::StopShooting()
 	// lower the flag
 	bIsShooting = false;
 
+	if (UShooterReplaySubsystem* Replay = UShooterReplaySubsystem::Get(this))
+	{
+		Replay->RecordNpcDecision(this, nullptr);
+	}
+
 	// signal the weapon
 	Weapon->StopFiring();
 }
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "CollisionQueryParams.h"
 #include "Gravity_testCharacter.h"
 #include "ShooterWeaponHolder.h"
 #include "ShooterNPC.generated.h"
@@ -81,14 +82,28 @@ protected:
 	/** If true, this character has already died */
 	bool bIsDead = false;
 
+	/** If true, this character is owned by the NPC pool and goes dormant instead of being destroyed */
+	bool bPooled = false;
+
+	/** If true, this character is dormant in the NPC pool */
+	bool bIsDormant = false;
+
 	/** Deferred destruction on death timer */
 	FTimerHandle DeathTimer;
 
+	/** Line of sight trace params, built once since they only ever ignore this character */
+	FCollisionQueryParams SightQueryParams;
+
 public:
 
 	/** Delegate called when this NPC dies */
 	FPawnDeathDelegate OnPawnDeath;
 
+public:
+
+	/** Constructor */
+	AShooterNPC(const FObjectInitializer& ObjectInitializer);
+
 protected:
 
 	/** Gameplay initialization */
@@ -121,6 +136,9 @@ public:
 	/** Calculates and returns the aim location for the weapon */
 	virtual FVector GetWeaponTargetLocation() override;
 
+	/** Calculates the aim trace segment for the weapon */
+	virtual bool GetDeferredAimTrace(FVector& OutStart, FVector& OutEnd) override;
+
 	/** Gives a weapon of this class to the owner */
 	virtual void AddWeaponClass(const TSubclassOf<AShooterWeapon>& WeaponClass) override;
 
@@ -143,6 +161,29 @@ protected:
 	/** Called after death to destroy the actor */
 	void DeferredDestruction();
 
+	/** Calculates the start and end points of the aim trace, applying aim variance */
+	void CalculateAimTrace(FVector& OutStart, FVector& OutEnd) const;
+
+public:
+
+	/** Flags this character as owned by the NPC pool */
+	void SetPooled(bool bInPooled) { bPooled = bInPooled; }
+
+	/** Returns true if this character is owned by the NPC pool */
+	bool IsPooled() const { return bPooled; }
+
+	/** Returns true if this character is dormant in the NPC pool */
+	bool IsDormant() const { return bIsDormant; }
+
+	/** Returns the params for line of sight traces from this character. A trace that hits the target itself counts as visible */
+	const FCollisionQueryParams& GetSightQueryParams() const { return SightQueryParams; }
+
+	/** Hides and disables this character, its weapon and its AI Controller while it waits in the pool */
+	void EnterPoolDormancy();
+
+	/** Brings this character back from the pool at the given transform with full HP and a restarted AI */
+	void ReactivateFromPool(const FTransform& SpawnTransform);
+
 public:
 
 	/** Signals this character to start shooting at the passed actor */
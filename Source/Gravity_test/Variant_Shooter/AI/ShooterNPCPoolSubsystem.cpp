@@ -0,0 +1,100 @@
+#include "ShooterNPCPoolSubsystem.h"
+#include "ShooterNPC.h"
+#include "Engine/World.h"
+#include "Algo/Count.h"
+#include "Gravity_test.h"
+
+AShooterNPC* UShooterNPCPoolSubsystem::AcquireNPC(TSubclassOf<AShooterNPC> NPCClass, const FTransform& SpawnTransform)
+{
+	if (!NPCClass)
+	{
+		return nullptr;
+	}
+
+	// reuse a dormant NPC of the same class if we have one. Skip any that were destroyed behind our back
+	const int32 DormantIndex = DormantNPCs.IndexOfByPredicate([&NPCClass](const AShooterNPC* NPC)
+	{
+		return IsValid(NPC) && NPC->GetClass() == NPCClass;
+	});
+
+	if (DormantIndex != INDEX_NONE)
+	{
+		AShooterNPC* NPC = DormantNPCs[DormantIndex];
+		DormantNPCs.RemoveAtSwap(DormantIndex, EAllowShrinking::No);
+
+		NPC->ReactivateFromPool(SpawnTransform);
+		return NPC;
+	}
+
+	return SpawnPooledNPC(NPCClass, SpawnTransform);
+}
+
+void UShooterNPCPoolSubsystem::PrewarmNPCs(TSubclassOf<AShooterNPC> NPCClass, int32 Count, const FTransform& ParkingTransform)
+{
+	if (!NPCClass || Count <= 0)
+	{
+		return;
+	}
+
+	// reserve up front so releasing NPCs later never grows the arrays
+	PooledNPCs.Reserve(PooledNPCs.Num() + Count);
+	DormantNPCs.Reserve(PooledNPCs.Max());
+
+	for (int32 i = 0; i < Count; ++i)
+	{
+		if (AShooterNPC* NPC = SpawnPooledNPC(NPCClass, ParkingTransform))
+		{
+			NPC->EnterPoolDormancy();
+			DormantNPCs.Add(NPC);
+		}
+	}
+}
+
+bool UShooterNPCPoolSubsystem::ReleaseNPC(AShooterNPC* NPC)
+{
+	// the pooled flag is only ever set by this pool, so there's no need to search PooledNPCs
+	if (!NPC || !NPC->IsPooled())
+	{
+		return false;
+	}
+
+	// an NPC that's already dormant is already in the dormant list
+	if (NPC->IsDormant())
+	{
+		return true;
+	}
+
+	NPC->EnterPoolDormancy();
+	DormantNPCs.Add(NPC);
+
+	return true;
+}
+
+int32 UShooterNPCPoolSubsystem::GetNumDormantNPCs(TSubclassOf<AShooterNPC> NPCClass) const
+{
+	return Algo::CountIf(DormantNPCs, [&NPCClass](const AShooterNPC* NPC) { return IsValid(NPC) && NPC->GetClass() == NPCClass; });
+}
+
+bool UShooterNPCPoolSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+AShooterNPC* UShooterNPCPoolSubsystem::SpawnPooledNPC(TSubclassOf<AShooterNPC> NPCClass, const FTransform& SpawnTransform)
+{
+	LLM_SCOPE_BYTAG(Shooter_AI);
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+	AShooterNPC* NPC = GetWorld()->SpawnActor<AShooterNPC>(NPCClass, SpawnTransform, SpawnParams);
+
+	if (NPC)
+	{
+		NPC->SetPooled(true);
+		PooledNPCs.Add(NPC);
+		DormantNPCs.Reserve(PooledNPCs.Num());
+	}
+
+	return NPC;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShooterNPCPoolSubsystem.generated.h"
+
+class AShooterNPC;
+
+/**
+ *  Recycles dead NPCs together with their AI Controllers and weapons
+ *  Dead pooled NPCs go dormant instead of being destroyed, and are reactivated at a new spawn point on demand
+ */
+UCLASS()
+class GRAVITY_TEST_API UShooterNPCPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** Every NPC owned by the pool, active or dormant. Keeps them referenced, membership is checked with the NPC's pooled flag */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<AShooterNPC>> PooledNPCs;
+
+	/** Dormant NPCs ready to be reactivated */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<AShooterNPC>> DormantNPCs;
+
+public:
+
+	/** Returns a dormant NPC of the given class reactivated at the spawn transform, or spawns a new one if none are available */
+	UFUNCTION(BlueprintCallable, Category="Shooter|Pool")
+	AShooterNPC* AcquireNPC(TSubclassOf<AShooterNPC> NPCClass, const FTransform& SpawnTransform);
+
+	/** Spawns NPCs of the given class up front and leaves them dormant, so later waves don't spawn anything */
+	UFUNCTION(BlueprintCallable, Category="Shooter|Pool")
+	void PrewarmNPCs(TSubclassOf<AShooterNPC> NPCClass, int32 Count, const FTransform& ParkingTransform);
+
+	/** Returns a dead NPC to the pool. Returns false if the NPC isn't owned by the pool and should be destroyed instead */
+	bool ReleaseNPC(AShooterNPC* NPC);
+
+	/** Returns the number of dormant NPCs of the given class */
+	UFUNCTION(BlueprintPure, Category="Shooter|Pool")
+	int32 GetNumDormantNPCs(TSubclassOf<AShooterNPC> NPCClass) const;
+
+protected:
+
+	//~Begin UWorldSubsystem interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~End UWorldSubsystem interface
+
+	/** Spawns a new pooled NPC */
+	AShooterNPC* SpawnPooledNPC(TSubclassOf<AShooterNPC> NPCClass, const FTransform& SpawnTransform);
+};
@@ -0,0 +1,267 @@
+#include "ShooterRagdollSubsystem.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Camera/PlayerCameraManager.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "IAnimationBudgetAllocator.h"
+#include "SkeletalMeshComponentBudgeted.h"
+#include "Gravity_test.h"
+
+namespace
+{
+	TAutoConsoleVariable<int32> CVarRagdollMaxSimulating(
+		TEXT("Shooter.Ragdoll.MaxSimulating"),
+		8,
+		TEXT("Max number of death ragdolls simulating at the same time."),
+		ECVF_Default);
+
+	TAutoConsoleVariable<float> CVarRagdollSettleSpeed(
+		TEXT("Shooter.Ragdoll.SettleSpeed"),
+		10.0f,
+		TEXT("Root body speed in cm/s below which a ragdoll counts as settled."),
+		ECVF_Default);
+
+	TAutoConsoleVariable<float> CVarRagdollSettleTime(
+		TEXT("Shooter.Ragdoll.SettleTime"),
+		0.5f,
+		TEXT("Seconds a ragdoll needs to stay settled before its pose is frozen."),
+		ECVF_Default);
+
+	TAutoConsoleVariable<float> CVarRagdollMaxSimulationTime(
+		TEXT("Shooter.Ragdoll.MaxSimulationTime"),
+		4.0f,
+		TEXT("Seconds after which a ragdoll is frozen even if it hasn't settled."),
+		ECVF_Default);
+
+	TAutoConsoleVariable<float> CVarRagdollMaxWaitTime(
+		TEXT("Shooter.Ragdoll.MaxWaitTime"),
+		2.0f,
+		TEXT("Seconds a death beyond the budget holds its kinematic pose waiting for a slot before it's frozen as is."),
+		ECVF_Default);
+
+	/** Distance that weighs as much as one second of age when picking a ragdoll to evict */
+	constexpr float KEvictionDistancePerSecond = 1000.0f;
+
+	/** Turns the mesh tick on or off. Budgeted meshes have their tick owned by the animation budget allocator, so it's routed through it */
+	void SetMeshTickEnabled(USkeletalMeshComponent* Mesh, bool bEnabled)
+	{
+		USkeletalMeshComponentBudgeted* BudgetedMesh = Cast<USkeletalMeshComponentBudgeted>(Mesh);
+		IAnimationBudgetAllocator* BudgetAllocator = BudgetedMesh ? IAnimationBudgetAllocator::Get(Mesh->GetWorld()) : nullptr;
+
+		if (BudgetAllocator)
+		{
+			BudgetAllocator->SetComponentTickEnabled(BudgetedMesh, bEnabled);
+		}
+		else
+		{
+			Mesh->SetComponentTickEnabled(bEnabled);
+		}
+	}
+}
+
+void UShooterRagdollSubsystem::RequestRagdoll(USkeletalMeshComponent* Mesh, FName CollisionProfile)
+{
+	if (!Mesh)
+	{
+		return;
+	}
+
+	LLM_SCOPE_BYTAG(Shooter_AI);
+
+	ReleaseRagdoll(Mesh);
+
+	const double Now = GetWorld()->GetTimeSeconds();
+
+	FRagdollEntry NewEntry;
+	NewEntry.Mesh = Mesh;
+	NewEntry.CollisionProfile = CollisionProfile;
+	NewEntry.RequestTime = Now;
+
+	// make room by evicting the oldest or farthest ragdoll, as long as it's less relevant than the new one
+	if (SimulatingRagdolls.Num() >= GetMaxSimulating())
+	{
+		const FVector ViewLocation = GetViewLocation();
+		int32 EvictIndex = INDEX_NONE;
+		float EvictScore = GetEvictionScore(NewEntry, ViewLocation, Now);
+
+		for (int32 Index = 0; Index < SimulatingRagdolls.Num(); ++Index)
+		{
+			const float Score = GetEvictionScore(SimulatingRagdolls[Index], ViewLocation, Now);
+			if (Score > EvictScore)
+			{
+				EvictScore = Score;
+				EvictIndex = Index;
+			}
+		}
+
+		if (EvictIndex == INDEX_NONE)
+		{
+			// hold the death pose until a slot frees up
+			HoldKinematicPose(Mesh, CollisionProfile);
+			WaitingRagdolls.Add(MoveTemp(NewEntry));
+			return;
+		}
+
+		FreezePose(SimulatingRagdolls[EvictIndex].Mesh.Get());
+		SimulatingRagdolls.RemoveAtSwap(EvictIndex, EAllowShrinking::No);
+	}
+
+	StartSimulation(SimulatingRagdolls.Add_GetRef(MoveTemp(NewEntry)));
+}
+
+void UShooterRagdollSubsystem::ReleaseRagdoll(USkeletalMeshComponent* Mesh)
+{
+	const auto MatchesMesh = [Mesh](const FRagdollEntry& Entry) { return Entry.Mesh == Mesh; };
+	SimulatingRagdolls.RemoveAllSwap(MatchesMesh, EAllowShrinking::No);
+	WaitingRagdolls.RemoveAll(MatchesMesh);
+
+	if (Mesh)
+	{
+		// undo any freeze
+		Mesh->bNoSkeletonUpdate = false;
+		Mesh->bPauseAnims = false;
+		SetMeshTickEnabled(Mesh, true);
+	}
+}
+
+bool UShooterRagdollSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UShooterRagdollSubsystem::Tick(float DeltaTime)
+{
+	if (SimulatingRagdolls.IsEmpty() && WaitingRagdolls.IsEmpty())
+	{
+		return;
+	}
+
+	const double Now = GetWorld()->GetTimeSeconds();
+	const float SettleSpeedSq = FMath::Square(CVarRagdollSettleSpeed.GetValueOnGameThread());
+	const float SettleTime = CVarRagdollSettleTime.GetValueOnGameThread();
+	const float MaxSimulationTime = CVarRagdollMaxSimulationTime.GetValueOnGameThread();
+
+	// freeze ragdolls that have settled or simulated for too long
+	for (int32 Index = SimulatingRagdolls.Num() - 1; Index >= 0; --Index)
+	{
+		FRagdollEntry& Entry = SimulatingRagdolls[Index];
+		USkeletalMeshComponent* Mesh = Entry.Mesh.Get();
+
+		if (!IsValid(Mesh))
+		{
+			SimulatingRagdolls.RemoveAtSwap(Index, EAllowShrinking::No);
+			continue;
+		}
+
+		const bool bSlow = Mesh->GetPhysicsLinearVelocity().SizeSquared() <= SettleSpeedSq;
+		Entry.SettledTime = bSlow ? Entry.SettledTime + DeltaTime : 0.0f;
+
+		if (Entry.SettledTime >= SettleTime || Now - Entry.SimulationStartTime >= MaxSimulationTime)
+		{
+			FreezePose(Mesh);
+			SimulatingRagdolls.RemoveAtSwap(Index, EAllowShrinking::No);
+		}
+	}
+
+	// promote waiting ragdolls into free slots, oldest first. Give up on the ones that waited too long
+	const int32 MaxSimulating = GetMaxSimulating();
+	const float MaxWaitTime = CVarRagdollMaxWaitTime.GetValueOnGameThread();
+	int32 NumPromoted = 0;
+
+	for (FRagdollEntry& Entry : WaitingRagdolls)
+	{
+		USkeletalMeshComponent* Mesh = Entry.Mesh.Get();
+		++NumPromoted;
+
+		if (!IsValid(Mesh))
+		{
+			continue;
+		}
+
+		if (Now - Entry.RequestTime > MaxWaitTime)
+		{
+			FreezePose(Mesh);
+			continue;
+		}
+
+		if (SimulatingRagdolls.Num() >= MaxSimulating)
+		{
+			--NumPromoted;
+			break;
+		}
+
+		Mesh->bPauseAnims = false;
+		StartSimulation(SimulatingRagdolls.Add_GetRef(MoveTemp(Entry)));
+	}
+
+	WaitingRagdolls.RemoveAt(0, NumPromoted, EAllowShrinking::No);
+}
+
+TStatId UShooterRagdollSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterRagdollSubsystem, STATGROUP_Tickables);
+}
+
+void UShooterRagdollSubsystem::StartSimulation(FRagdollEntry& Entry)
+{
+	Entry.SimulationStartTime = GetWorld()->GetTimeSeconds();
+	Entry.SettledTime = 0.0f;
+
+	USkeletalMeshComponent* Mesh = Entry.Mesh.Get();
+	Mesh->SetCollisionProfileName(Entry.CollisionProfile);
+	Mesh->SetSimulatePhysics(true);
+	Mesh->SetPhysicsBlendWeight(1.0f);
+}
+
+void UShooterRagdollSubsystem::HoldKinematicPose(USkeletalMeshComponent* Mesh, FName CollisionProfile)
+{
+	// bodies of a mesh that isn't simulating are kinematic and follow the pose, which stops changing once the animation pauses
+	Mesh->bPauseAnims = true;
+	Mesh->SetSimulatePhysics(false);
+	Mesh->SetCollisionProfileName(CollisionProfile);
+}
+
+void UShooterRagdollSubsystem::FreezePose(USkeletalMeshComponent* Mesh)
+{
+	if (!IsValid(Mesh))
+	{
+		return;
+	}
+
+	// stop ticking the mesh before the next animation update, so it keeps the last simulated pose as a static snapshot
+	Mesh->SetSimulatePhysics(false);
+	Mesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	Mesh->bNoSkeletonUpdate = true;
+	SetMeshTickEnabled(Mesh, false);
+}
+
+float UShooterRagdollSubsystem::GetEvictionScore(const FRagdollEntry& Entry, const FVector& ViewLocation, double Now) const
+{
+	const USkeletalMeshComponent* Mesh = Entry.Mesh.Get();
+	if (!Mesh)
+	{
+		return UE_MAX_FLT;
+	}
+
+	const float Age = float(Now - Entry.RequestTime);
+	const float Distance = FVector::Dist(Mesh->GetComponentLocation(), ViewLocation);
+
+	return Age + Distance / KEvictionDistancePerSecond;
+}
+
+int32 UShooterRagdollSubsystem::GetMaxSimulating() const
+{
+	return FMath::Clamp(CVarRagdollMaxSimulating.GetValueOnGameThread(), 0, MaxSimulatingCap);
+}
+
+FVector UShooterRagdollSubsystem::GetViewLocation() const
+{
+	const APlayerController* PC = GetWorld()->GetFirstPlayerController();
+	if (PC && PC->PlayerCameraManager)
+	{
+		return PC->PlayerCameraManager->GetCameraLocation();
+	}
+
+	return FVector::ZeroVector;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShooterRagdollSubsystem.generated.h"
+
+class USkeletalMeshComponent;
+
+/**
+ *  Keeps the cost of death ragdolls bounded
+ *  Only a fixed number of ragdolls simulate at once. Settled ragdolls freeze into a static pose with no physics,
+ *  the oldest or farthest ragdoll is evicted to make room for new ones, and deaths beyond the budget hold their last
+ *  animated pose with kinematic bodies until a simulation slot frees up. They don't fall until they get a slot
+ */
+UCLASS()
+class GRAVITY_TEST_API UShooterRagdollSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** A ragdoll tracked by the subsystem */
+	struct FRagdollEntry
+	{
+		TWeakObjectPtr<USkeletalMeshComponent> Mesh;
+
+		/** Collision profile to simulate with */
+		FName CollisionProfile;
+
+		/** World time the death was requested */
+		double RequestTime = 0.0;
+
+		/** World time the simulation started */
+		double SimulationStartTime = 0.0;
+
+		/** Time the ragdoll has been below the settle speed */
+		float SettledTime = 0.0f;
+	};
+
+	/** Ragdolls currently simulating */
+	TArray<FRagdollEntry> SimulatingRagdolls;
+
+	/** Ragdolls holding their last animated pose kinematically, waiting for a simulation slot */
+	TArray<FRagdollEntry> WaitingRagdolls;
+
+	/** Simulation budget cap set by the performance governor */
+	int32 MaxSimulatingCap = MAX_int32;
+
+public:
+
+	/** Ragdolls the mesh, or holds it kinematic if the simulation budget is full and no ragdoll can be evicted */
+	void RequestRagdoll(USkeletalMeshComponent* Mesh, FName CollisionProfile);
+
+	/** Stops tracking the mesh and restores its animation updates. The caller is responsible for its collision and attachment */
+	void ReleaseRagdoll(USkeletalMeshComponent* Mesh);
+
+	/** Returns the number of ragdolls currently simulating */
+	int32 GetNumSimulating() const { return SimulatingRagdolls.Num(); }
+
+	/** Lowers the simulation budget below Shooter.Ragdoll.MaxSimulating. Set by the performance governor */
+	void SetMaxSimulatingCap(int32 Cap) { MaxSimulatingCap = Cap; }
+
+protected:
+
+	//~Begin UWorldSubsystem interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~End UWorldSubsystem interface
+
+	//~Begin FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	//~End FTickableGameObject interface
+
+	/** Starts simulating a ragdoll */
+	void StartSimulation(FRagdollEntry& Entry);
+
+	/**
+	 *  Holds a death beyond the budget in its last animated pose. Animation is paused and the physics bodies stay kinematic,
+	 *  following that pose without simulating, so the corpse keeps colliding under the ragdoll profile while it waits for a slot
+	 */
+	static void HoldKinematicPose(USkeletalMeshComponent* Mesh, FName CollisionProfile);
+
+	/** Stops simulating a ragdoll and freezes its current pose */
+	static void FreezePose(USkeletalMeshComponent* Mesh);
+
+	/** Returns how eligible a ragdoll is for eviction. Older and farther ragdolls score higher */
+	float GetEvictionScore(const FRagdollEntry& Entry, const FVector& ViewLocation, double Now) const;
+
+	/** Returns the location ragdoll distances are measured from */
+	FVector GetViewLocation() const;
+
+	/** Returns the number of ragdolls allowed to simulate at once */
+	int32 GetMaxSimulating() const;
+};
@@ -9,6 +9,8 @@
 #include "Perception/AIPerceptionComponent.h"
 #include "ShooterAIController.h"
 #include "StateTreeAsyncExecutionContext.h"
+#include "ShooterVisibilitySubsystem.h"
+#include "ShooterRandomSubsystem.h"
 
 bool FStateTreeLineOfSightToTargetCondition::TestCondition(FStateTreeExecutionContext& Context) const
 {
@@ -42,10 +44,16 @@ bool FStateTreeLineOfSightToTargetCondition::TestCondition(FStateTreeExecutionCo
 	// get the character's camera location as the source for the line checks
 	const FVector Start = InstanceData.Character->GetFirstPersonCameraComponent()->GetComponentLocation();
 
-	// ignore the character and target. We want to ensure there's an unobstructed trace not counting them
-	FCollisionQueryParams QueryParams;
-	QueryParams.AddIgnoredActor(InstanceData.Character);
-	QueryParams.AddIgnoredActor(InstanceData.Target);
+	// skip the traces if the baked visibility grid rules out line of sight
+	const UShooterVisibilitySubsystem* VisibilitySubsystem = InstanceData.Character->GetWorld()->GetSubsystem<UShooterVisibilitySubsystem>();
+
+	if (VisibilitySubsystem && !VisibilitySubsystem->IsPotentiallyVisible(InstanceData.Character, InstanceData.Target))
+	{
+		return !InstanceData.bMustHaveLineOfSight;
+	}
+
+	// the character's prebuilt params ignore only the character, so a trace stopped by the target is still unobstructed
+	const FCollisionQueryParams& QueryParams = InstanceData.Character->GetSightQueryParams();
 
 	FHitResult OutHit;
 
@@ -58,7 +66,7 @@ bool FStateTreeLineOfSightToTargetCondition::TestCondition(FStateTreeExecutionCo
 		InstanceData.Character->GetWorld()->LineTraceSingleByChannel(OutHit, Start, End, ECC_Visibility, QueryParams);
 
 		// is the trace unobstructed?
-		if (!OutHit.bBlockingHit)
+		if (!OutHit.bBlockingHit || OutHit.GetActor() == InstanceData.Target)
 		{
 			// we only need one unobstructed trace, so terminate early
 			return InstanceData.bMustHaveLineOfSight;
@@ -160,8 +168,8 @@ EStateTreeRunStatus FStateTreeSetRandomFloatTask::EnterState(FStateTreeExecution
 		// get the instance data
 		FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
 
-		// calculate the output value
-		InstanceData.OutValue = FMath::RandRange(InstanceData.MinValue, InstanceData.MaxValue);
+		// calculate the output value from the owner's stream so the same seed reproduces the same decisions
+		InstanceData.OutValue = UShooterRandomSubsystem::GetStream(Context.GetOwner()).FRandRange(InstanceData.MinValue, InstanceData.MaxValue);
 	}
 
 	return EStateTreeRunStatus::Running;
@@ -239,18 +247,19 @@ EStateTreeRunStatus FStateTreeSenseEnemiesTask::EnterState(FStateTreeExecutionCo
 						const float DirDot = FVector::DotProduct(StimulusDir, LambdaInstanceData->Character->GetActorForwardVector());
 						const float MaxDot = FMath::Cos(FMath::DegreesToRadians(LambdaInstanceData->DirectLineOfSightCone));
 
+						// skip the trace if the baked visibility grid rules out line of sight
+						const UShooterVisibilitySubsystem* VisibilitySubsystem = LambdaInstanceData->Character->GetWorld()->GetSubsystem<UShooterVisibilitySubsystem>();
+						const bool bPotentiallyVisible = !VisibilitySubsystem || VisibilitySubsystem->IsPotentiallyVisible(LambdaInstanceData->Character, SensedActor);
+
 						// is the direction within our perception cone?
-						if (DirDot >= MaxDot)
+						if (DirDot >= MaxDot && bPotentiallyVisible)
 						{
 							// run a line trace between the character and the sensed actor
-							FCollisionQueryParams QueryParams;
-							QueryParams.AddIgnoredActor(LambdaInstanceData->Character);
-							QueryParams.AddIgnoredActor(SensedActor);
-
 							FHitResult OutHit;
 
-							// we have direct line of sight if this trace is unobstructed
-							bDirectLOS = !LambdaInstanceData->Character->GetWorld()->LineTraceSingleByChannel(OutHit, LambdaInstanceData->Character->GetActorLocation(), SensedActor->GetActorLocation(), ECC_Visibility, QueryParams);
+							// we have direct line of sight if this trace is unobstructed or only stopped by the sensed actor
+							bDirectLOS = !LambdaInstanceData->Character->GetWorld()->LineTraceSingleByChannel(OutHit, LambdaInstanceData->Character->GetActorLocation(), SensedActor->GetActorLocation(), ECC_Visibility, LambdaInstanceData->Character->GetSightQueryParams())
+								|| OutHit.GetActor() == SensedActor;
 
 						}
 
@@ -0,0 +1,257 @@
+#include "ShooterVisibilityBakeCommandlet.h"
+#include "ShooterVisibilityGrid.h"
+#include "ShooterBakeWorld.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "NavMesh/NavMeshBoundsVolume.h"
+#include "Async/ParallelFor.h"
+#include "HAL/FileManager.h"
+#include "Misc/PackageName.h"
+#include "Gravity_test.h"
+
+namespace
+{
+	/** Radius of the probe that detects samples inside solid geometry */
+	constexpr float KSampleClearance = 5.0f;
+
+	/** Fraction of the way to the cell center a sample inside geometry is pulled per attempt */
+	constexpr float KSamplePullStep = 0.25f;
+}
+
+UShooterVisibilityBakeCommandlet::UShooterVisibilityBakeCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UShooterVisibilityBakeCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+	FString MapName;
+	if (!FParse::Value(*Params, TEXT("Map="), MapName))
+	{
+		UE_LOG(LogGravity_test, Error, TEXT("ShooterVisibilityBake: missing -Map=<long package name>."));
+		return 1;
+	}
+
+	float CellSize = 400.0f;
+	FParse::Value(*Params, TEXT("CellSize="), CellSize);
+	CellSize = FMath::Max(CellSize, 50.0f);
+
+	int32 NumSamples = 4;
+	FParse::Value(*Params, TEXT("Samples="), NumSamples);
+	NumSamples = FMath::Clamp(NumSamples, 0, 8);
+
+	UWorld* World = ShooterBakeWorld::Load(MapName);
+	if (!World)
+	{
+		return 1;
+	}
+
+	// the grid covers the navigable space of the level
+	FBox Bounds(ForceInit);
+	for (TActorIterator<ANavMeshBoundsVolume> It(World); It; ++It)
+	{
+		Bounds += It->GetComponentsBoundingBox(true);
+	}
+
+	if (!Bounds.IsValid)
+	{
+		UE_LOG(LogGravity_test, Error, TEXT("ShooterVisibilityBake: %s has no navmesh bounds volumes."), *MapName);
+		ShooterBakeWorld::Release(World);
+		return 1;
+	}
+
+	FShooterVisibilityGridHeader Header;
+	Header.Origin = FVector3f(Bounds.Min);
+	Header.CellSize = CellSize;
+	Header.Dims = FIntVector(
+		FMath::Max(1, FMath::CeilToInt32(Bounds.GetSize().X / CellSize)),
+		FMath::Max(1, FMath::CeilToInt32(Bounds.GetSize().Y / CellSize)),
+		FMath::Max(1, FMath::CeilToInt32(Bounds.GetSize().Z / CellSize)));
+
+	const int32 NumCells = Header.GetNumCells();
+	const int32 RowBytes = (NumCells + 7) / 8;
+
+	UE_LOG(LogGravity_test, Display, TEXT("ShooterVisibilityBake: %s, %dx%dx%d cells, %d interior samples per cell."), *MapName, Header.Dims.X, Header.Dims.Y, Header.Dims.Z, NumSamples);
+
+	// the grid is a hard reject in front of the real line of sight traces, so every step below errs towards visible.
+	// Rays leave from the corners, face centers and center of each cell, plus interior samples at the corners of a box half the cell size
+	TArray<FVector> SampleOffsets;
+	for (int32 Corner = 0; Corner < 8; ++Corner)
+	{
+		SampleOffsets.Add(FVector((Corner & 1) ? 1.0f : 0.0f, (Corner & 2) ? 1.0f : 0.0f, (Corner & 4) ? 1.0f : 0.0f));
+	}
+
+	for (int32 Axis = 0; Axis < 3; ++Axis)
+	{
+		FVector Face(0.5f);
+		Face[Axis] = 0.0f;
+		SampleOffsets.Add(Face);
+		Face[Axis] = 1.0f;
+		SampleOffsets.Add(Face);
+	}
+
+	SampleOffsets.Add(FVector(0.5f));
+
+	// the first four interior samples form a tetrahedron
+	static constexpr int32 CornerOrder[] = { 0, 3, 5, 6, 1, 2, 4, 7 };
+
+	for (int32 Sample = 0; Sample < NumSamples; ++Sample)
+	{
+		const int32 Corner = CornerOrder[Sample];
+		SampleOffsets.Add(FVector((Corner & 1) ? 0.75f : 0.25f, (Corner & 2) ? 0.75f : 0.25f, (Corner & 4) ? 0.75f : 0.25f));
+	}
+
+	// samples inside solid geometry are pulled towards the cell center until they're clear, and dropped if they never are
+	TArray<TArray<FVector>> CellSamples;
+	CellSamples.SetNum(NumCells);
+
+	ParallelFor(NumCells, [&](int32 Cell)
+	{
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ShooterVisibilityBake), false);
+		const FVector CellMin = Header.GetCellMin(Cell);
+		const FVector CellCenter = CellMin + FVector(0.5f * CellSize);
+		const FCollisionShape Probe = FCollisionShape::MakeSphere(KSampleClearance);
+
+		for (const FVector& Offset : SampleOffsets)
+		{
+			const FVector Sample = CellMin + Offset * CellSize;
+
+			for (float Pull = 0.0f; Pull < 1.0f; Pull += KSamplePullStep)
+			{
+				const FVector Candidate = FMath::Lerp(Sample, CellCenter, Pull);
+
+				if (!World->OverlapBlockingTestByChannel(Candidate, FQuat::Identity, ECC_Visibility, Probe, QueryParams))
+				{
+					CellSamples[Cell].Add(Candidate);
+					break;
+				}
+			}
+		}
+	});
+
+	// each row is only written by the task that owns it, so the upper triangle is baked without locking
+	TArray<uint8> Rows;
+	Rows.SetNumZeroed(IntCastChecked<int32>(int64(RowBytes) * NumCells));
+
+	ParallelFor(NumCells, [&](int32 FromCell)
+	{
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ShooterVisibilityBake), false);
+		uint8* Row = Rows.GetData() + int64(RowBytes) * FromCell;
+		const TArray<FVector>& FromSamples = CellSamples[FromCell];
+
+		// a cell always sees itself
+		Row[FromCell >> 3] |= 1 << (FromCell & 7);
+
+		for (int32 ToCell = FromCell + 1; ToCell < NumCells; ++ToCell)
+		{
+			const TArray<FVector>& ToSamples = CellSamples[ToCell];
+
+			// a fully solid cell can't be sampled, but a query point can still land in it, so it sees everything
+			bool bVisible = FromSamples.IsEmpty() || ToSamples.IsEmpty();
+
+			for (int32 FromSample = 0; FromSample < FromSamples.Num() && !bVisible; ++FromSample)
+			{
+				for (int32 ToSample = 0; ToSample < ToSamples.Num() && !bVisible; ++ToSample)
+				{
+					bVisible = !World->LineTraceTestByChannel(FromSamples[FromSample], ToSamples[ToSample], ECC_Visibility, QueryParams);
+				}
+			}
+
+			if (bVisible)
+			{
+				Row[ToCell >> 3] |= 1 << (ToCell & 7);
+			}
+		}
+	});
+
+	// mirror the upper triangle into full rows
+	for (int32 FromCell = 0; FromCell < NumCells; ++FromCell)
+	{
+		for (int32 ToCell = FromCell + 1; ToCell < NumCells; ++ToCell)
+		{
+			if (Rows[int64(RowBytes) * FromCell + (ToCell >> 3)] & (1 << (ToCell & 7)))
+			{
+				Rows[int64(RowBytes) * ToCell + (FromCell >> 3)] |= 1 << (FromCell & 7);
+			}
+		}
+	}
+
+	// dilate every visible set by one neighbouring cell, covering sightlines that slip between the samples
+	TArray<uint8> DilatedRows;
+	DilatedRows.SetNumZeroed(Rows.Num());
+
+	ParallelFor(NumCells, [&](int32 FromCell)
+	{
+		const uint8* Row = Rows.GetData() + int64(RowBytes) * FromCell;
+		uint8* DilatedRow = DilatedRows.GetData() + int64(RowBytes) * FromCell;
+
+		for (int32 ToCell = 0; ToCell < NumCells; ++ToCell)
+		{
+			if (!(Row[ToCell >> 3] & (1 << (ToCell & 7))))
+			{
+				continue;
+			}
+
+			const FIntVector Coords(ToCell % Header.Dims.X, (ToCell / Header.Dims.X) % Header.Dims.Y, ToCell / (Header.Dims.X * Header.Dims.Y));
+
+			for (int32 Z = FMath::Max(Coords.Z - 1, 0); Z <= FMath::Min(Coords.Z + 1, Header.Dims.Z - 1); ++Z)
+			{
+				for (int32 Y = FMath::Max(Coords.Y - 1, 0); Y <= FMath::Min(Coords.Y + 1, Header.Dims.Y - 1); ++Y)
+				{
+					for (int32 X = FMath::Max(Coords.X - 1, 0); X <= FMath::Min(Coords.X + 1, Header.Dims.X - 1); ++X)
+					{
+						const int32 Neighbour = X + Y * Header.Dims.X + Z * Header.Dims.X * Header.Dims.Y;
+						DilatedRow[Neighbour >> 3] |= 1 << (Neighbour & 7);
+					}
+				}
+			}
+		}
+	});
+
+	// dilating the rows only grows the target side, so mirror again to keep the matrix symmetric, then pack it
+	TArray<uint8> Matrix;
+	Matrix.SetNumZeroed(IntCastChecked<int32>(Header.GetMatrixSize()));
+
+	int32 NumVisiblePairs = 0;
+	for (int32 FromCell = 0; FromCell < NumCells; ++FromCell)
+	{
+		for (int32 ToCell = FromCell; ToCell < NumCells; ++ToCell)
+		{
+			if ((DilatedRows[int64(RowBytes) * FromCell + (ToCell >> 3)] & (1 << (ToCell & 7)))
+				|| (DilatedRows[int64(RowBytes) * ToCell + (FromCell >> 3)] & (1 << (FromCell & 7))))
+			{
+				const int64 Bit = Header.GetPairBit(FromCell, ToCell);
+				const int64 MirrorBit = Header.GetPairBit(ToCell, FromCell);
+				Matrix[Bit >> 3] |= 1 << (Bit & 7);
+				Matrix[MirrorBit >> 3] |= 1 << (MirrorBit & 7);
+				++NumVisiblePairs;
+			}
+		}
+	}
+
+	ShooterBakeWorld::Release(World);
+
+	const FString FilePath = ShooterVisibilityGrid::GetFilePath(FPackageName::GetShortName(MapName));
+	TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*FilePath));
+
+	if (!Writer)
+	{
+		UE_LOG(LogGravity_test, Error, TEXT("ShooterVisibilityBake: could not write %s."), *FilePath);
+		return 1;
+	}
+
+	Writer->Serialize(&Header, sizeof(Header));
+	Writer->Serialize(Matrix.GetData(), Matrix.Num());
+
+	const int64 NumPairs = int64(NumCells) * (NumCells + 1) / 2;
+	UE_LOG(LogGravity_test, Display, TEXT("ShooterVisibilityBake: wrote %s, %d of %lld cell pairs potentially visible."), *FilePath, NumVisiblePairs, NumPairs);
+
+	return Writer->Close() ? 0 : 1;
+#else
+	return 1;
+#endif
+}
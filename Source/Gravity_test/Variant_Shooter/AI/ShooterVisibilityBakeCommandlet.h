@@ -0,0 +1,25 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ShooterVisibilityBakeCommandlet.generated.h"
+
+/**
+ *  Bakes the cell to cell potential visibility grid of a level, covering its navmesh bounds
+ *  The bake is conservative: rays leave from each cell's corners, faces, center and -Samples interior points,
+ *  and every visible set is dilated by one neighbouring cell, so a pair is only culled when no sightline can exist
+ *  Usage: -run=ShooterVisibilityBake -Map=/Game/Path/To/Level [-CellSize=400] [-Samples=4]
+ */
+UCLASS()
+class GRAVITY_TEST_API UShooterVisibilityBakeCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Constructor */
+	UShooterVisibilityBakeCommandlet();
+
+	/** Runs the bake */
+	virtual int32 Main(const FString& Params) override;
+};
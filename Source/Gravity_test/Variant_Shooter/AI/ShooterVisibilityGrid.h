@@ -0,0 +1,71 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/Paths.h"
+
+/**
+ *  Header of a baked visibility grid file
+ *  The header is followed by a NumCells x NumCells bit matrix, one row per source cell,
+ *  with a bit set for every cell potentially visible from it
+ */
+struct FShooterVisibilityGridHeader
+{
+	static constexpr uint32 ExpectedMagic = 0x53495647;
+	static constexpr uint32 ExpectedVersion = 2;
+
+	uint32 Magic = ExpectedMagic;
+	uint32 Version = ExpectedVersion;
+
+	/** Min corner of the grid */
+	FVector3f Origin = FVector3f::ZeroVector;
+
+	/** Edge length of a cell */
+	float CellSize = 400.0f;
+
+	/** Number of cells along each axis */
+	FIntVector Dims = FIntVector::ZeroValue;
+
+	/** Returns the total number of cells */
+	int32 GetNumCells() const { return Dims.X * Dims.Y * Dims.Z; }
+
+	/** Returns the size in bytes of the bit matrix following the header */
+	int64 GetMatrixSize() const { return (int64(GetNumCells()) * GetNumCells() + 7) / 8; }
+
+	/** Returns the cell containing a location, or INDEX_NONE if it's outside the grid */
+	int32 GetCellIndex(const FVector& Location) const
+	{
+		const FVector Local = (Location - FVector(Origin)) / CellSize;
+		const FIntVector Cell(FMath::FloorToInt32(Local.X), FMath::FloorToInt32(Local.Y), FMath::FloorToInt32(Local.Z));
+
+		if (Cell.X < 0 || Cell.Y < 0 || Cell.Z < 0 || Cell.X >= Dims.X || Cell.Y >= Dims.Y || Cell.Z >= Dims.Z)
+		{
+			return INDEX_NONE;
+		}
+
+		return Cell.X + Cell.Y * Dims.X + Cell.Z * Dims.X * Dims.Y;
+	}
+
+	/** Returns the min corner of a cell */
+	FVector GetCellMin(int32 CellIndex) const
+	{
+		const int32 X = CellIndex % Dims.X;
+		const int32 Y = (CellIndex / Dims.X) % Dims.Y;
+		const int32 Z = CellIndex / (Dims.X * Dims.Y);
+
+		return FVector(Origin) + FVector(X, Y, Z) * CellSize;
+	}
+
+	/** Returns the bit index of a cell pair in the matrix */
+	int64 GetPairBit(int32 FromCell, int32 ToCell) const { return int64(FromCell) * GetNumCells() + ToCell; }
+};
+
+static_assert(sizeof(FShooterVisibilityGridHeader) == 36, "Visibility grid header layout is part of the file format");
+
+namespace ShooterVisibilityGrid
+{
+	/** Returns the path of the visibility grid file baked for a map */
+	inline FString GetFilePath(const FString& MapShortName)
+	{
+		return FPaths::ProjectContentDir() / TEXT("VisibilityGrids") / (MapShortName + TEXT(".vgrid"));
+	}
+}
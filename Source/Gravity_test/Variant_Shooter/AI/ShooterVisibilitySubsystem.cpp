@@ -0,0 +1,126 @@
+#include "ShooterVisibilitySubsystem.h"
+#include "ShooterNPC.h"
+#include "Camera/CameraComponent.h"
+#include "Engine/World.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/PackageName.h"
+#include "Gravity_test.h"
+
+bool UShooterVisibilitySubsystem::IsPotentiallyVisible(const FVector& From, const FVector& To) const
+{
+	if (!Matrix)
+	{
+		return true;
+	}
+
+	const int32 FromCell = Header.GetCellIndex(From);
+	const int32 ToCell = Header.GetCellIndex(To);
+
+	// stay conservative outside of the baked area
+	if (FromCell == INDEX_NONE || ToCell == INDEX_NONE)
+	{
+		return true;
+	}
+
+	const int64 Bit = Header.GetPairBit(FromCell, ToCell);
+	return (Matrix[Bit >> 3] & (1 << (Bit & 7))) != 0;
+}
+
+bool UShooterVisibilitySubsystem::IsPotentiallyVisible(const AShooterNPC* Viewer, const AActor* Target) const
+{
+	if (!Matrix || !Viewer || !Target)
+	{
+		return true;
+	}
+
+	return IsPotentiallyVisible(Viewer->GetFirstPersonCameraComponent()->GetComponentLocation(), Target->GetActorLocation());
+}
+
+void UShooterVisibilitySubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	const FString MapShortName = UWorld::RemovePIEPrefix(FPackageName::GetShortName(InWorld.GetOutermost()->GetName()));
+	MapGridFile(MapShortName);
+}
+
+void UShooterVisibilitySubsystem::Deinitialize()
+{
+	UnmapGridFile();
+
+	Super::Deinitialize();
+}
+
+bool UShooterVisibilitySubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+bool UShooterVisibilitySubsystem::MapGridFile(const FString& MapShortName)
+{
+	UnmapGridFile();
+
+	const FString FilePath = ShooterVisibilityGrid::GetFilePath(MapShortName);
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+
+	if (!PlatformFile.FileExists(*FilePath))
+	{
+		return false;
+	}
+
+	FOpenMappedResult OpenResult = PlatformFile.OpenMappedEx(*FilePath);
+	if (OpenResult.HasError())
+	{
+		UE_LOG(LogGravity_test, Warning, TEXT("Could not memory map visibility grid %s: %s"), *FilePath, *OpenResult.GetError().GetMessage());
+		return false;
+	}
+
+	MappedFile = OpenResult.StealValue();
+
+	const int64 FileSize = MappedFile->GetFileSize();
+	if (FileSize < int64(sizeof(FShooterVisibilityGridHeader)))
+	{
+		UE_LOG(LogGravity_test, Warning, TEXT("Visibility grid %s is truncated."), *FilePath);
+		UnmapGridFile();
+		return false;
+	}
+
+	MappedRegion.Reset(MappedFile->MapRegion(0, FileSize));
+	if (!MappedRegion)
+	{
+		UE_LOG(LogGravity_test, Warning, TEXT("Could not map region of visibility grid %s."), *FilePath);
+		UnmapGridFile();
+		return false;
+	}
+
+	FMemory::Memcpy(&Header, MappedRegion->GetMappedPtr(), sizeof(FShooterVisibilityGridHeader));
+
+	// validate the header before trusting the matrix
+	const bool bValidHeader = Header.Magic == FShooterVisibilityGridHeader::ExpectedMagic
+		&& Header.Version == FShooterVisibilityGridHeader::ExpectedVersion
+		&& Header.CellSize > 0.0f
+		&& Header.Dims.X > 0 && Header.Dims.Y > 0 && Header.Dims.Z > 0
+		&& FileSize >= int64(sizeof(FShooterVisibilityGridHeader)) + Header.GetMatrixSize();
+
+	if (!bValidHeader)
+	{
+		UE_LOG(LogGravity_test, Warning, TEXT("Visibility grid %s is invalid or out of date. Rebake it with -run=ShooterVisibilityBake."), *FilePath);
+		UnmapGridFile();
+		return false;
+	}
+
+	Matrix = MappedRegion->GetMappedPtr() + sizeof(FShooterVisibilityGridHeader);
+
+	UE_LOG(LogGravity_test, Log, TEXT("Mapped visibility grid %s (%d cells)."), *FilePath, Header.GetNumCells());
+
+	return true;
+}
+
+void UShooterVisibilitySubsystem::UnmapGridFile()
+{
+	Matrix = nullptr;
+
+	// the region needs to be released before its file
+	MappedRegion.Reset();
+	MappedFile.Reset();
+}
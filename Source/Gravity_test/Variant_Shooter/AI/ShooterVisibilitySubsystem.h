@@ -0,0 +1,62 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Async/MappedFileHandle.h"
+#include "ShooterVisibilityGrid.h"
+#include "ShooterVisibilitySubsystem.generated.h"
+
+class AShooterNPC;
+
+/**
+ *  Memory maps the baked visibility grid of the current level
+ *  AI checks it before running line of sight traces, and skips pairs of points that can never see each other
+ */
+UCLASS()
+class GRAVITY_TEST_API UShooterVisibilitySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** Mapped grid file */
+	TUniquePtr<IMappedFileHandle> MappedFile;
+
+	/** Mapped region covering the whole file */
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+
+	/** Header of the mapped grid. Only valid if Matrix is set */
+	FShooterVisibilityGridHeader Header;
+
+	/** Visibility bit matrix inside the mapped region */
+	const uint8* Matrix = nullptr;
+
+public:
+
+	/**
+	 *  Returns false only if the baked grid proves the two points can't see each other
+	 *  Returns true if there's no grid for the level or either point is outside of it
+	 */
+	bool IsPotentiallyVisible(const FVector& From, const FVector& To) const;
+
+	/**
+	 *  Checks the grid from the NPC's eye point to the target's location
+	 *  Every AI sight check goes through this, so they all query the same pair of cells for the same NPC and target
+	 */
+	bool IsPotentiallyVisible(const AShooterNPC* Viewer, const AActor* Target) const;
+
+	/** Returns true if a visibility grid is loaded */
+	bool HasVisibilityData() const { return Matrix != nullptr; }
+
+protected:
+
+	//~Begin UWorldSubsystem interface
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~End UWorldSubsystem interface
+
+	/** Maps the grid file for the given map. Returns true on success */
+	bool MapGridFile(const FString& MapShortName);
+
+	/** Releases the mapped file */
+	void UnmapGridFile();
+};
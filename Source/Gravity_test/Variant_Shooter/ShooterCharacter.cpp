@@ -12,6 +12,12 @@
 #include "Camera/CameraComponent.h"
 #include "TimerManager.h"
 #include "ShooterGameMode.h"
+#include "ShooterWeaponPoolSubsystem.h"
+#include "Animation/AnimInstance.h"
+#include "GravityFlightRecorder.h"
+#include "ShooterLatencySubsystem.h"
+#include "ShooterReplaySubsystem.h"
+#include "ShooterSpawnPointSubsystem.h"
 
 AShooterCharacter::AShooterCharacter()
 {
@@ -69,6 +75,7 @@ float AShooterCharacter::TakeDamage(float Damage, struct FDamageEvent const& Dam
 
 	// Reduce HP
 	CurrentHP -= Damage;
+	GravityFlightRecorder::Record(GravityFlightRecorder::EEvent::Damage, this, DamageCauser, Damage, CurrentHP);
 
 	// Have we depleted HP?
 	if (CurrentHP <= 0.0f)
@@ -84,15 +91,31 @@ float AShooterCharacter::TakeDamage(float Damage, struct FDamageEvent const& Dam
 
 void AShooterCharacter::DoStartFiring()
 {
+	if (UShooterReplaySubsystem* Replay = UShooterReplaySubsystem::Get(this))
+	{
+		Replay->RecordPlayerAction(this, EShooterReplayRecord::FireStart);
+	}
+
 	// fire the current weapon
 	if (CurrentWeapon)
 	{
+		// timestamp the input so the latency to the shot and its effects can be measured
+		if (UShooterLatencySubsystem* Latency = GetWorld()->GetSubsystem<UShooterLatencySubsystem>())
+		{
+			Latency->MarkInput(CurrentWeapon);
+		}
+
 		CurrentWeapon->StartFiring();
 	}
 }
 
 void AShooterCharacter::DoStopFiring()
 {
+	if (UShooterReplaySubsystem* Replay = UShooterReplaySubsystem::Get(this))
+	{
+		Replay->RecordPlayerAction(this, EShooterReplayRecord::FireStop);
+	}
+
 	// stop firing the current weapon
 	if (CurrentWeapon)
 	{
@@ -102,6 +125,11 @@ void AShooterCharacter::DoStopFiring()
 
 void AShooterCharacter::DoSwitchWeapon()
 {
+	if (UShooterReplaySubsystem* Replay = UShooterReplaySubsystem::Get(this))
+	{
+		Replay->RecordPlayerAction(this, EShooterReplayRecord::SwitchWeapon);
+	}
+
 	// ensure we have at least two weapons two switch between
 	if (OwnedWeapons.Num() > 1)
 	{
@@ -164,11 +192,10 @@ FVector AShooterCharacter::GetWeaponTargetLocation()
 	// trace ahead from the camera viewpoint
 	FHitResult OutHit;
 
-	const FVector Start = GetFirstPersonCameraComponent()->GetComponentLocation();
-	const FVector End = Start + (GetFirstPersonCameraComponent()->GetForwardVector() * MaxAimDistance);
+	FVector Start, End;
+	CalculateAimTrace(Start, End);
 
-	FCollisionQueryParams QueryParams;
-	QueryParams.AddIgnoredActor(this);
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ShooterCharacterAim), false, this);
 
 	GetWorld()->LineTraceSingleByChannel(OutHit, Start, End, ECC_Visibility, QueryParams);
 
@@ -176,6 +203,25 @@ FVector AShooterCharacter::GetWeaponTargetLocation()
 	return OutHit.bBlockingHit ? OutHit.ImpactPoint : OutHit.TraceEnd;
 }
 
+bool AShooterCharacter::GetDeferredAimTrace(FVector& OutStart, FVector& OutEnd)
+{
+	// the local player needs the shot to come out this frame, so fall back to the synchronous trace
+	if (IsLocallyControlled())
+	{
+		return false;
+	}
+
+	CalculateAimTrace(OutStart, OutEnd);
+	return true;
+}
+
+void AShooterCharacter::CalculateAimTrace(FVector& OutStart, FVector& OutEnd) const
+{
+	// aim ahead from the camera viewpoint
+	OutStart = GetFirstPersonCameraComponent()->GetComponentLocation();
+	OutEnd = OutStart + (GetFirstPersonCameraComponent()->GetForwardVector() * MaxAimDistance);
+}
+
 void AShooterCharacter::AddWeaponClass(const TSubclassOf<AShooterWeapon>& WeaponClass)
 {
 	// do we already own this weapon?
@@ -183,14 +229,24 @@ void AShooterCharacter::AddWeaponClass(const TSubclassOf<AShooterWeapon>& Weapon
 
 	if (!OwnedWeapon)
 	{
-		// spawn the new weapon
-		FActorSpawnParameters SpawnParams;
-		SpawnParams.Owner = this;
-		SpawnParams.Instigator = this;
-		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
-		SpawnParams.TransformScaleMethod = ESpawnActorScaleMethod::MultiplyWithRoot;
+		AShooterWeapon* AddedWeapon = nullptr;
 
-		AShooterWeapon* AddedWeapon = GetWorld()->SpawnActor<AShooterWeapon>(WeaponClass, GetActorTransform(), SpawnParams);
+		if (UShooterWeaponPoolSubsystem* WeaponPool = GetWorld()->GetSubsystem<UShooterWeaponPoolSubsystem>())
+		{
+			// take a pre-spawned weapon from the pool. It only spawns one if the pool ran dry
+			AddedWeapon = WeaponPool->AcquireWeapon(WeaponClass, this);
+		}
+		else
+		{
+			// no pool in this world, so spawn the new weapon
+			FActorSpawnParameters SpawnParams;
+			SpawnParams.Owner = this;
+			SpawnParams.Instigator = this;
+			SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+			SpawnParams.TransformScaleMethod = ESpawnActorScaleMethod::MultiplyWithRoot;
+
+			AddedWeapon = GetWorld()->SpawnActor<AShooterWeapon>(WeaponClass, GetActorTransform(), SpawnParams);
+		}
 
 		if (AddedWeapon)
 		{
@@ -215,14 +271,40 @@ void AShooterCharacter::OnWeaponActivated(AShooterWeapon* Weapon)
 	// update the bullet counter
 	OnBulletCountUpdated.Broadcast(Weapon->GetMagazineSize(), Weapon->GetBulletCount());
 
-	// set the character mesh AnimInstances
-	GetFirstPersonMesh()->SetAnimInstanceClass(Weapon->GetFirstPersonAnimInstanceClass());
-	GetMesh()->SetAnimInstanceClass(Weapon->GetThirdPersonAnimInstanceClass());
+	// set up the character mesh animation for the weapon
+	ApplyWeaponAnimation(GetFirstPersonMesh(), Weapon->GetFirstPersonAnimLayersClass(), Weapon->GetFirstPersonAnimInstanceClass());
+	ApplyWeaponAnimation(GetMesh(), Weapon->GetThirdPersonAnimLayersClass(), Weapon->GetThirdPersonAnimInstanceClass());
 }
 
 void AShooterCharacter::OnWeaponDeactivated(AShooterWeapon* Weapon)
 {
-	// unused
+	// unlink the weapon's anim layers so they don't linger if the next weapon doesn't override them
+	if (Weapon->GetFirstPersonAnimLayersClass())
+	{
+		GetFirstPersonMesh()->UnlinkAnimClassLayers(Weapon->GetFirstPersonAnimLayersClass());
+	}
+
+	if (Weapon->GetThirdPersonAnimLayersClass())
+	{
+		GetMesh()->UnlinkAnimClassLayers(Weapon->GetThirdPersonAnimLayersClass());
+	}
+}
+
+void AShooterCharacter::ApplyWeaponAnimation(USkeletalMeshComponent* CharacterMesh, TSubclassOf<UAnimInstance> AnimLayersClass, TSubclassOf<UAnimInstance> AnimInstanceClass)
+{
+	// linking layers keeps the running anim instance and only swaps the weapon specific layers
+	if (AnimLayersClass)
+	{
+		CharacterMesh->LinkAnimClassLayers(AnimLayersClass);
+		return;
+	}
+
+	// setting the AnimInstance class reinitializes animation, so skip it if the class isn't changing
+	const UAnimInstance* CurrentAnimInstance = CharacterMesh->GetAnimInstance();
+	if (!CurrentAnimInstance || CurrentAnimInstance->GetClass() != AnimInstanceClass)
+	{
+		CharacterMesh->SetAnimInstanceClass(AnimInstanceClass);
+	}
 }
 
 void AShooterCharacter::OnSemiWeaponRefire()
@@ -248,6 +330,14 @@ AShooterWeapon* AShooterCharacter::FindWeaponOfType(TSubclassOf<AShooterWeapon>
 
 void AShooterCharacter::Die()
 {
+	GravityFlightRecorder::Record(GravityFlightRecorder::EEvent::Death, this, nullptr, GetActorLocation());
+
+	// remember where we died so we don't respawn right there. The spawn points are re-ranked while we wait to respawn
+	if (UShooterSpawnPointSubsystem* SpawnPoints = GetWorld()->GetSubsystem<UShooterSpawnPointSubsystem>())
+	{
+		SpawnPoints->RecordDeath(GetActorLocation());
+	}
+
 	// deactivate the weapon
 	if (IsValid(CurrentWeapon))
 	{
@@ -11,6 +11,7 @@ class AShooterWeapon;
 class UInputAction;
 class UInputComponent;
 class UPawnNoiseEmitterComponent;
+class UAnimInstance;
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FBulletCountUpdatedDelegate, int32, MagazineSize, int32, Bullets);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FDamagedDelegate, float, LifePercent);
@@ -135,6 +136,9 @@ public:
 	/** Calculates and returns the aim location for the weapon */
 	virtual FVector GetWeaponTargetLocation() override;
 
+	/** Calculates the aim trace segment for the weapon. Locally controlled characters always aim synchronously */
+	virtual bool GetDeferredAimTrace(FVector& OutStart, FVector& OutEnd) override;
+
 	/** Gives a weapon of this class to the owner */
 	virtual void AddWeaponClass(const TSubclassOf<AShooterWeapon>& WeaponClass) override;
 
@@ -154,6 +158,12 @@ protected:
 	/** Returns true if the character already owns a weapon of the given class */
 	AShooterWeapon* FindWeaponOfType(TSubclassOf<AShooterWeapon> WeaponClass) const;
 
+	/** Calculates the start and end points of the aim trace from the camera viewpoint */
+	void CalculateAimTrace(FVector& OutStart, FVector& OutEnd) const;
+
+	/** Links the weapon's anim layers into the character mesh, or falls back to its AnimInstance class */
+	void ApplyWeaponAnimation(USkeletalMeshComponent* CharacterMesh, TSubclassOf<UAnimInstance> AnimLayersClass, TSubclassOf<UAnimInstance> AnimInstanceClass);
+
 	/** Called when this character's HP is depleted */
 	void Die();
 
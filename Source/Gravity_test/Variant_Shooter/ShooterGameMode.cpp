@@ -5,6 +5,9 @@
 #include "ShooterUI.h"
 #include "Kismet/GameplayStatics.h"
 #include "Engine/World.h"
+#include "Engine/GameInstance.h"
+#include "Engine/LocalPlayer.h"
+#include "HUDModelSubsystem.h"
 
 void AShooterGameMode::BeginPlay()
 {
@@ -28,6 +31,12 @@ void AShooterGameMode::IncrementTeamScore(uint8 TeamByte)
 	++Score;
 	TeamScores.Add(TeamByte, Score);
 
-	// update the UI
-	ShooterUI->BP_UpdateScore(TeamByte, Score);
+	// update the HUD models. The UI picks up the change once per frame
+	for (ULocalPlayer* LocalPlayer : GetGameInstance()->GetLocalPlayers())
+	{
+		if (UHUDModelSubsystem* HUDModel = ULocalPlayer::GetSubsystem<UHUDModelSubsystem>(LocalPlayer))
+		{
+			HUDModel->SetTeamScore(TeamByte, Score);
+		}
+	}
 }
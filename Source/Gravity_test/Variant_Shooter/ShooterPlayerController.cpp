@@ -9,6 +9,9 @@
 #include "GameFramework/PlayerStart.h"
 #include "ShooterCharacter.h"
 #include "ShooterBulletCounterUI.h"
+#include "ShooterSpawnPointSubsystem.h"
+#include "ShooterRandomSubsystem.h"
+#include "HUDModelSubsystem.h"
 #include "Gravity_test.h"
 #include "Widgets/Input/SVirtualJoystick.h"
 
@@ -102,19 +105,32 @@ void AShooterPlayerController::OnPossess(APawn* InPawn)
 void AShooterPlayerController::OnPawnDestroyed(AActor* DestroyedActor)
 {
 	// reset the bullet counter HUD
-	BulletCounterUI->BP_UpdateBulletCounter(0, 0);
+	OnBulletCountUpdated(0, 0);
 
-	// find the player start
-	TArray<AActor*> ActorList;
-	UGameplayStatics::GetAllActorsOfClass(GetWorld(), APlayerStart::StaticClass(), ActorList);
+	AActor* SelectedPlayerStart = nullptr;
 
-	if (ActorList.Num() > 0)
+	if (UShooterSpawnPointSubsystem* SpawnPoints = GetWorld()->GetSubsystem<UShooterSpawnPointSubsystem>())
 	{
-		// select a random player start
-		AActor* RandomPlayerStart = ActorList[FMath::RandRange(0, ActorList.Num() - 1)];
+		// take the best ranked player start. The character recorded its death when it died, so the ranking already avoids it
+		SelectedPlayerStart = SpawnPoints->ClaimBestSpawnPoint();
+	}
+	else
+	{
+		// no spawn point index in this world, so find the player starts the slow way
+		TArray<AActor*> ActorList;
+		UGameplayStatics::GetAllActorsOfClass(GetWorld(), APlayerStart::StaticClass(), ActorList);
 
+		if (ActorList.Num() > 0)
+		{
+			// select a random player start
+			SelectedPlayerStart = ActorList[UShooterRandomSubsystem::GetStream(this).RandRange(0, ActorList.Num() - 1)];
+		}
+	}
+
+	if (SelectedPlayerStart)
+	{
 		// spawn a character at the player start
-		const FTransform SpawnTransform = RandomPlayerStart->GetActorTransform();
+		const FTransform SpawnTransform = SelectedPlayerStart->GetActorTransform();
 
 		if (AShooterCharacter* RespawnedCharacter = GetWorld()->SpawnActor<AShooterCharacter>(CharacterClass, SpawnTransform))
 		{
@@ -126,17 +142,18 @@ void AShooterPlayerController::OnPawnDestroyed(AActor* DestroyedActor)
 
 void AShooterPlayerController::OnBulletCountUpdated(int32 MagazineSize, int32 Bullets)
 {
-	// update the UI
-	if (BulletCounterUI)
+	// update the HUD model. The UI picks up the change once per frame
+	if (UHUDModelSubsystem* HUDModel = ULocalPlayer::GetSubsystem<UHUDModelSubsystem>(GetLocalPlayer()))
 	{
-		BulletCounterUI->BP_UpdateBulletCounter(MagazineSize, Bullets);
+		HUDModel->SetAmmo(MagazineSize, Bullets);
 	}
 }
 
 void AShooterPlayerController::OnPawnDamaged(float LifePercent)
 {
-	if (IsValid(BulletCounterUI))
+	// update the HUD model. The UI picks up the change once per frame
+	if (UHUDModelSubsystem* HUDModel = ULocalPlayer::GetSubsystem<UHUDModelSubsystem>(GetLocalPlayer()))
 	{
-		BulletCounterUI->BP_Damaged(LifePercent);
+		HUDModel->SetLifePercent(LifePercent);
 	}
 }
@@ -0,0 +1,86 @@
+#include "ShooterRandomSubsystem.h"
+#include "Engine/World.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+#include "Gravity_test.h"
+
+namespace
+{
+	/** Minimum stream count before stale owners are cleaned up */
+	constexpr int32 KMinPruneThreshold = 256;
+}
+
+FRandomStream& UShooterRandomSubsystem::GetStream(const UObject* Owner)
+{
+	const UWorld* World = Owner ? Owner->GetWorld() : nullptr;
+
+	if (UShooterRandomSubsystem* Random = World ? World->GetSubsystem<UShooterRandomSubsystem>() : nullptr)
+	{
+		return Random->FindOrAddStream(Owner);
+	}
+
+	// editor previews and other worlds without the service still get numbers, just not reproducible ones
+	static FRandomStream FallbackStream(int32(FPlatformTime::Cycles() & MAX_int32));
+	return FallbackStream;
+}
+
+FRandomStream& UShooterRandomSubsystem::FindOrAddStream(const UObject* Owner)
+{
+	check(IsInGameThread());
+
+	if (FRandomStream* Stream = Streams.Find(Owner))
+	{
+		return *Stream;
+	}
+
+	if (Streams.Num() >= PruneThreshold)
+	{
+		PruneStaleStreams();
+	}
+
+	// path names follow level layout and spawn order, so they match between runs of the same match
+	const uint32 OwnerSeed = HashCombineFast(uint32(WorldSeed), GetTypeHash(Owner->GetPathName()));
+	return Streams.Add(Owner, FRandomStream(int32(OwnerSeed)));
+}
+
+void UShooterRandomSubsystem::SetWorldSeed(int32 InWorldSeed)
+{
+	if (WorldSeed != InWorldSeed)
+	{
+		WorldSeed = InWorldSeed;
+		Streams.Reset();
+
+		UE_LOG(LogGravity_test, Log, TEXT("Shooter random: world seed %d"), WorldSeed);
+	}
+}
+
+void UShooterRandomSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	if (!FParse::Value(FCommandLine::Get(), TEXT("ShooterSeed="), WorldSeed))
+	{
+		WorldSeed = int32(FPlatformTime::Cycles() & MAX_int32);
+	}
+
+	PruneThreshold = KMinPruneThreshold;
+}
+
+bool UShooterRandomSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UShooterRandomSubsystem::PruneStaleStreams()
+{
+	for (auto It = Streams.CreateIterator(); It; ++It)
+	{
+		if (!It.Key().ResolveObjectPtr())
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	// run the next cleanup once the live streams have doubled
+	PruneThreshold = FMath::Max(KMinPruneThreshold, Streams.Num() * 2);
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Math/RandomStream.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "ShooterRandomSubsystem.generated.h"
+
+/**
+ *  Hands out seeded random streams for gameplay randomness
+ *  Every actor or system drawing random numbers gets its own stream, seeded from the world seed and the owner's name.
+ *  Streams don't interleave, so one owner's draws never shift another's, and the same seed and owner replay the same sequence
+ *  on any machine. The world seed comes from -ShooterSeed=<seed>, or from the replay being recorded or played back.
+ *  Game thread only
+ */
+UCLASS()
+class GRAVITY_TEST_API UShooterRandomSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** Streams keyed by owner */
+	TMap<TObjectKey<UObject>, FRandomStream> Streams;
+
+	/** Stream count the next stale owner cleanup runs at */
+	int32 PruneThreshold = 0;
+
+	int32 WorldSeed = 0;
+
+public:
+
+	/** Returns the stream of the owner in its world. Falls back to a shared stream for objects outside a game world */
+	static FRandomStream& GetStream(const UObject* Owner);
+
+	/** Returns the stream of the owner, creating it on first use */
+	FRandomStream& FindOrAddStream(const UObject* Owner);
+
+	int32 GetWorldSeed() const { return WorldSeed; }
+
+	/** Reseeds the world. Every stream restarts from the new seed on its next draw */
+	void SetWorldSeed(int32 InWorldSeed);
+
+protected:
+
+	//~Begin UWorldSubsystem interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~End UWorldSubsystem interface
+
+	/** Drops the streams of owners that were destroyed */
+	void PruneStaleStreams();
+};
@@ -0,0 +1,463 @@
+#include "ShooterReplaySubsystem.h"
+#include "ShooterCharacter.h"
+#include "ShooterRandomSubsystem.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/FileManager.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/DateTime.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "Serialization/NameAsStringProxyArchive.h"
+#include "Gravity_test.h"
+
+namespace
+{
+	/** Well activations further apart than this are reported as diverged */
+	constexpr float KWellLocationTolerance = 100.0f;
+
+	/** Returns true if the command line asks for a recording, and the file to record to if it names one */
+	bool ParseRecordParam(const TCHAR* CommandLine, FString& OutFilePath)
+	{
+		return FParse::Value(CommandLine, TEXT("ShooterReplayRecord="), OutFilePath) || FParse::Param(CommandLine, TEXT("ShooterReplayRecord"));
+	}
+
+	/** Serializes the payload of an event record. The type has already been serialized */
+	void SerializeEventPayload(FArchive& Ar, EShooterReplayRecord Type, FName& Actor, FName& Target, FVector3f& Location)
+	{
+		switch (Type)
+		{
+		case EShooterReplayRecord::WellActivate:
+			Ar << Location;
+			break;
+
+		case EShooterReplayRecord::NpcStartShooting:
+			Ar << Actor << Target;
+			break;
+
+		case EShooterReplayRecord::NpcStopShooting:
+			Ar << Actor;
+			break;
+
+		default:
+			break;
+		}
+	}
+
+	const TCHAR* GetRecordName(EShooterReplayRecord Type)
+	{
+		switch (Type)
+		{
+		case EShooterReplayRecord::FireStart:			return TEXT("FireStart");
+		case EShooterReplayRecord::FireStop:			return TEXT("FireStop");
+		case EShooterReplayRecord::SwitchWeapon:		return TEXT("SwitchWeapon");
+		case EShooterReplayRecord::WellActivate:		return TEXT("WellActivate");
+		case EShooterReplayRecord::NpcStartShooting:	return TEXT("NpcStartShooting");
+		case EShooterReplayRecord::NpcStopShooting:		return TEXT("NpcStopShooting");
+		default:										return TEXT("Frame");
+		}
+	}
+}
+
+UShooterReplaySubsystem* UShooterReplaySubsystem::Get(const UObject* WorldContextObject)
+{
+	// the subsystem only exists when the command line asks for a replay, so this is a cheap miss otherwise
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UShooterReplaySubsystem>() : nullptr;
+}
+
+void UShooterReplaySubsystem::RecordPlayerAction(const APawn* Pawn, EShooterReplayRecord Action)
+{
+	// only the player's own input is recorded. Playback drives these actions itself
+	if (!bRecording || !Pawn || !Pawn->IsPlayerControlled())
+	{
+		return;
+	}
+
+	uint8 Type = uint8(Action);
+	*Writer << Type;
+}
+
+void UShooterReplaySubsystem::RecordWellActivation(const FVector& Location)
+{
+	RecordCheck({ EShooterReplayRecord::WellActivate, NAME_None, NAME_None, FVector3f(Location) });
+}
+
+void UShooterReplaySubsystem::RecordNpcDecision(const AActor* Npc, const AActor* Target)
+{
+	if (!Npc)
+	{
+		return;
+	}
+
+	// spawned actor names follow spawn order, so they match between a recording and its playback
+	if (Target)
+	{
+		RecordCheck({ EShooterReplayRecord::NpcStartShooting, Npc->GetFName(), Target->GetFName() });
+	}
+	else
+	{
+		RecordCheck({ EShooterReplayRecord::NpcStopShooting, Npc->GetFName() });
+	}
+}
+
+bool UShooterReplaySubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	if (!Super::ShouldCreateSubsystem(Outer))
+	{
+		return false;
+	}
+
+	FString Unused;
+	return FParse::Value(FCommandLine::Get(), TEXT("ShooterReplay="), Unused) || ParseRecordParam(FCommandLine::Get(), Unused);
+}
+
+bool UShooterReplaySubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UShooterReplaySubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	const TCHAR* CommandLine = FCommandLine::Get();
+
+	FString PlaybackPath;
+	FString RecordPath;
+	if (FParse::Value(CommandLine, TEXT("ShooterReplay="), PlaybackPath))
+	{
+		if (!StartPlayback(PlaybackPath))
+		{
+			FinishPlayback(1);
+			return;
+		}
+	}
+	else if (ParseRecordParam(CommandLine, RecordPath))
+	{
+		if (RecordPath.IsEmpty())
+		{
+			RecordPath = FPaths::ProjectSavedDir() / TEXT("Replays") / FString::Printf(TEXT("ShooterReplay_%s_%s.greplay"), *InWorld.GetMapName(), *FDateTime::Now().ToString());
+		}
+
+		if (!StartRecording(RecordPath))
+		{
+			return;
+		}
+	}
+
+	// seed the per-actor streams so aim variance, NPC aim and respawns replay the same way.
+	// The global RNG is seeded too for engine code that still draws from it
+	if (UShooterRandomSubsystem* Random = InWorld.GetSubsystem<UShooterRandomSubsystem>())
+	{
+		Random->SetWorldSeed(Seed);
+	}
+
+	FMath::RandInit(Seed);
+	FMath::SRandInit(Seed);
+
+	TickStartHandle = FWorldDelegates::OnWorldTickStart.AddUObject(this, &UShooterReplaySubsystem::OnWorldTickStart);
+}
+
+void UShooterReplaySubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldTickStart.Remove(TickStartHandle);
+
+	StopRecording();
+
+	if (bPlayingBack)
+	{
+		bPlayingBack = false;
+		FApp::SetUseFixedTimeStep(false);
+	}
+
+	Super::Deinitialize();
+}
+
+bool UShooterReplaySubsystem::StartRecording(const FString& InFilePath)
+{
+	FilePath = FPaths::ConvertRelativePathToFull(InFilePath);
+
+	FileWriter.Reset(IFileManager::Get().CreateFileWriter(*FilePath));
+	if (!FileWriter)
+	{
+		UE_LOG(LogGravity_test, Error, TEXT("Shooter replay: couldn't create %s"), *FilePath);
+		return false;
+	}
+
+	// names are written as strings so the stream doesn't depend on the name table of the recording process
+	Writer = MakeUnique<FNameAsStringProxyArchive>(*FileWriter);
+
+	// record the world seed, which honors -ShooterSeed=
+	const UShooterRandomSubsystem* Random = GetWorld()->GetSubsystem<UShooterRandomSubsystem>();
+	Seed = Random ? Random->GetWorldSeed() : int32(FPlatformTime::Cycles() & MAX_int32);
+
+	uint32 FileMagic = Magic;
+	uint32 FileVersion = Version;
+	FString MapName = GetWorld()->GetMapName();
+	*Writer << FileMagic << FileVersion << MapName << Seed;
+
+	// frame 0 holds everything that happens during BeginPlay
+	uint8 Type = uint8(EShooterReplayRecord::Frame);
+	float DeltaTime = 0.0f;
+	FVector3f PawnLocation = FVector3f::ZeroVector;
+	FRotator3f ControlRotation = FRotator3f::ZeroRotator;
+	bool bHasPawn = false;
+	*Writer << Type << DeltaTime << PawnLocation << ControlRotation << bHasPawn;
+
+	bRecording = true;
+
+	UE_LOG(LogGravity_test, Log, TEXT("Shooter replay: recording %s with seed %d to %s"), *MapName, Seed, *FilePath);
+	return true;
+}
+
+bool UShooterReplaySubsystem::StartPlayback(const FString& InFilePath)
+{
+	FilePath = FPaths::ConvertRelativePathToFull(InFilePath);
+
+	TUniquePtr<FArchive> FileReader(IFileManager::Get().CreateFileReader(*FilePath));
+	if (!FileReader)
+	{
+		UE_LOG(LogGravity_test, Error, TEXT("Shooter replay: couldn't open %s"), *FilePath);
+		return false;
+	}
+
+	FNameAsStringProxyArchive Reader(*FileReader);
+
+	uint32 FileMagic = 0;
+	uint32 FileVersion = 0;
+	FString MapName;
+	Reader << FileMagic << FileVersion;
+
+	if (FileMagic != Magic || FileVersion != Version)
+	{
+		UE_LOG(LogGravity_test, Error, TEXT("Shooter replay: %s isn't a version %u replay"), *FilePath, Version);
+		return false;
+	}
+
+	Reader << MapName << Seed;
+
+	if (MapName != GetWorld()->GetMapName())
+	{
+		UE_LOG(LogGravity_test, Warning, TEXT("Shooter replay: %s was recorded on %s but is playing back on %s"), *FilePath, *MapName, *GetWorld()->GetMapName());
+	}
+
+	while (!Reader.AtEnd() && !Reader.IsError())
+	{
+		uint8 Type = 0;
+		Reader << Type;
+
+		if (Type >= uint8(EShooterReplayRecord::Num))
+		{
+			UE_LOG(LogGravity_test, Error, TEXT("Shooter replay: %s is corrupt at offset %lld"), *FilePath, Reader.Tell());
+			return false;
+		}
+
+		if (Type == uint8(EShooterReplayRecord::Frame))
+		{
+			FReplayFrame& Frame = Frames.AddDefaulted_GetRef();
+			Reader << Frame.DeltaTime << Frame.PawnLocation << Frame.ControlRotation << Frame.bHasPawn;
+			continue;
+		}
+
+		if (Frames.IsEmpty())
+		{
+			UE_LOG(LogGravity_test, Error, TEXT("Shooter replay: %s has events before its first frame"), *FilePath);
+			return false;
+		}
+
+		FReplayEvent Event;
+		Event.Type = EShooterReplayRecord(Type);
+		SerializeEventPayload(Reader, Event.Type, Event.Actor, Event.Target, Event.Location);
+
+		const bool bIsAction = Event.Type == EShooterReplayRecord::FireStart || Event.Type == EShooterReplayRecord::FireStop || Event.Type == EShooterReplayRecord::SwitchWeapon;
+		(bIsAction ? Frames.Last().Actions : Frames.Last().Checks).Add(MoveTemp(Event));
+	}
+
+	if (Reader.IsError() || Frames.IsEmpty())
+	{
+		UE_LOG(LogGravity_test, Error, TEXT("Shooter replay: %s is truncated"), *FilePath);
+		return false;
+	}
+
+	// run the recorded frame times instead of the wall clock, so the match advances the same way regardless of how long frames take
+	FApp::SetUseFixedTimeStep(true);
+	if (Frames.IsValidIndex(1))
+	{
+		FApp::SetFixedDeltaTime(Frames[1].DeltaTime);
+	}
+
+	bPlayingBack = true;
+	PlaybackStartCycles = FPlatformTime::Cycles64();
+
+	UE_LOG(LogGravity_test, Log, TEXT("Shooter replay: playing back %s, %d frames with seed %d"), *FilePath, Frames.Num(), Seed);
+	return true;
+}
+
+void UShooterReplaySubsystem::StopRecording()
+{
+	if (!bRecording)
+	{
+		return;
+	}
+
+	bRecording = false;
+
+	Writer.Reset();
+	FileWriter->Close();
+	FileWriter.Reset();
+
+	UE_LOG(LogGravity_test, Log, TEXT("Shooter replay: wrote %d frames to %s"), FrameIndex + 1, *FilePath);
+}
+
+void UShooterReplaySubsystem::RecordCheck(FReplayEvent&& Event)
+{
+	if (bRecording)
+	{
+		uint8 Type = uint8(Event.Type);
+		*Writer << Type;
+		SerializeEventPayload(*Writer, Event.Type, Event.Actor, Event.Target, Event.Location);
+	}
+	else if (bPlayingBack)
+	{
+		LiveChecks.Add(MoveTemp(Event));
+	}
+}
+
+void UShooterReplaySubsystem::CompareChecks()
+{
+	const TArray<FReplayEvent>& Recorded = Frames[FrameIndex].Checks;
+
+	auto Matches = [](const FReplayEvent& A, const FReplayEvent& B)
+	{
+		return A.Type == B.Type && A.Actor == B.Actor && A.Target == B.Target
+			&& FVector3f::DistSquared(A.Location, B.Location) <= FMath::Square(KWellLocationTolerance);
+	};
+
+	bool bDiverged = Recorded.Num() != LiveChecks.Num();
+	for (int32 Index = 0; !bDiverged && Index < Recorded.Num(); ++Index)
+	{
+		bDiverged = !Matches(Recorded[Index], LiveChecks[Index]);
+	}
+
+	if (bDiverged)
+	{
+		++NumDivergentFrames;
+
+		// only the first divergence is detailed, everything after it is a consequence
+		if (FirstDivergentFrame == INDEX_NONE)
+		{
+			FirstDivergentFrame = FrameIndex;
+
+			auto Describe = [](const TArray<FReplayEvent>& Events)
+			{
+				FString Text;
+				for (const FReplayEvent& Event : Events)
+				{
+					Text += FString::Printf(TEXT(" %s(%s %s)"), GetRecordName(Event.Type), *Event.Actor.ToString(), *Event.Target.ToString());
+				}
+				return Text;
+			};
+
+			UE_LOG(LogGravity_test, Warning, TEXT("Shooter replay: diverged at frame %d. Recorded:%s Live:%s"), FrameIndex, *Describe(Recorded), *Describe(LiveChecks));
+		}
+	}
+
+	LiveChecks.Reset();
+}
+
+void UShooterReplaySubsystem::FinishPlayback(int32 ExitCode)
+{
+	if (bPlayingBack)
+	{
+		const double Seconds = FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - PlaybackStartCycles);
+		UE_LOG(LogGravity_test, Log, TEXT("Shooter replay: played back %d frames in %.2fs. %d frames diverged, first at %d"),
+			Frames.Num(), Seconds, NumDivergentFrames, FirstDivergentFrame);
+
+		// -ShooterReplayStrict fails the run on divergence, for automation that needs an exact reproduction
+		if (ExitCode == 0 && NumDivergentFrames > 0 && FParse::Param(FCommandLine::Get(), TEXT("ShooterReplayStrict")))
+		{
+			ExitCode = 2;
+		}
+	}
+
+	bPlayingBack = false;
+	FPlatformMisc::RequestExitWithStatus(false, ExitCode);
+}
+
+void UShooterReplaySubsystem::OnWorldTickStart(UWorld* InWorld, ELevelTick TickType, float DeltaTime)
+{
+	if (InWorld != GetWorld() || TickType != LEVELTICK_All)
+	{
+		return;
+	}
+
+	APlayerController* PlayerController = InWorld->GetFirstPlayerController();
+	APawn* Pawn = PlayerController ? PlayerController->GetPawn() : nullptr;
+
+	if (bRecording)
+	{
+		++FrameIndex;
+
+		uint8 Type = uint8(EShooterReplayRecord::Frame);
+		FVector3f PawnLocation = Pawn ? FVector3f(Pawn->GetActorLocation()) : FVector3f::ZeroVector;
+		FRotator3f ControlRotation = PlayerController ? FRotator3f(PlayerController->GetControlRotation()) : FRotator3f::ZeroRotator;
+		bool bHasPawn = Pawn != nullptr;
+		*Writer << Type << DeltaTime << PawnLocation << ControlRotation << bHasPawn;
+		return;
+	}
+
+	if (!bPlayingBack)
+	{
+		return;
+	}
+
+	// close out the previous frame, then start the next one
+	CompareChecks();
+
+	if (++FrameIndex >= Frames.Num())
+	{
+		FinishPlayback(0);
+		return;
+	}
+
+	const FReplayFrame& Frame = Frames[FrameIndex];
+
+	// the fixed delta time only applies from the next engine frame on
+	if (Frames.IsValidIndex(FrameIndex + 1))
+	{
+		FApp::SetFixedDeltaTime(Frames[FrameIndex + 1].DeltaTime);
+	}
+
+	// snap the player to the recorded view instead of replaying raw movement input
+	if (Frame.bHasPawn && Pawn)
+	{
+		Pawn->SetActorLocation(FVector(Frame.PawnLocation), false, nullptr, ETeleportType::TeleportPhysics);
+		PlayerController->SetControlRotation(FRotator(Frame.ControlRotation));
+	}
+
+	if (AShooterCharacter* Character = Cast<AShooterCharacter>(Pawn))
+	{
+		for (const FReplayEvent& Action : Frame.Actions)
+		{
+			switch (Action.Type)
+			{
+			case EShooterReplayRecord::FireStart:
+				Character->DoStartFiring();
+				break;
+
+			case EShooterReplayRecord::FireStop:
+				Character->DoStopFiring();
+				break;
+
+			case EShooterReplayRecord::SwitchWeapon:
+				Character->DoSwitchWeapon();
+				break;
+
+			default:
+				break;
+			}
+		}
+	}
+}
@@ -0,0 +1,146 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShooterReplaySubsystem.generated.h"
+
+class FArchive;
+
+/** Record types of a replay stream. Every record starts with its type */
+enum class EShooterReplayRecord : uint8
+{
+	/** Starts a new frame. Delta time, player pawn location and control rotation */
+	Frame,
+
+	/** Player actions, replayed on the player pawn */
+	FireStart,
+	FireStop,
+	SwitchWeapon,
+
+	/** Gravity well projectile activation. Location */
+	WellActivate,
+
+	/** NPC decisions. NPC name and target name */
+	NpcStartShooting,
+	NpcStopShooting,
+
+	Num
+};
+
+/**
+ *  Records shooter matches to a compact binary stream and plays them back headless for profiling
+ *  Run with -ShooterReplayRecord[=<file>] to record the match to Saved/Replays, and with -ShooterReplay=<file>
+ *  (typically -game -nullrhi) to play it back. The stream holds the RNG seed, every frame's delta time and player view,
+ *  the player's weapon actions, well activations and NPC shooting decisions.
+ *  Playback reseeds the RNG, runs the recorded delta times on a fixed time step, drives the player from the stream
+ *  and checks the live well activations and NPC decisions against the recorded ones, reporting the first divergence
+ */
+UCLASS()
+class GRAVITY_TEST_API UShooterReplaySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** A player action or a checked event of a recorded frame */
+	struct FReplayEvent
+	{
+		EShooterReplayRecord Type = EShooterReplayRecord::Num;
+		FName Actor;
+		FName Target;
+		FVector3f Location = FVector3f::ZeroVector;
+	};
+
+	/** A recorded frame with everything that happened during it */
+	struct FReplayFrame
+	{
+		float DeltaTime = 0.0f;
+		FVector3f PawnLocation = FVector3f::ZeroVector;
+		FRotator3f ControlRotation = FRotator3f::ZeroRotator;
+		bool bHasPawn = false;
+		TArray<FReplayEvent> Actions;
+		TArray<FReplayEvent> Checks;
+	};
+
+	/** Stream being recorded to, if recording */
+	TUniquePtr<FArchive> FileWriter;
+	TUniquePtr<FArchive> Writer;
+
+	/** Frames loaded for playback, if playing back */
+	TArray<FReplayFrame> Frames;
+
+	/** Events checked during the current playback frame */
+	TArray<FReplayEvent> LiveChecks;
+
+	FString FilePath;
+
+	/** World seed of the match, fed to the random streams */
+	int32 Seed = 0;
+
+	/** Index of the current frame */
+	int32 FrameIndex = 0;
+
+	/** First frame whose checked events didn't match the recording, or INDEX_NONE */
+	int32 FirstDivergentFrame = INDEX_NONE;
+
+	int32 NumDivergentFrames = 0;
+
+	bool bRecording = false;
+	bool bPlayingBack = false;
+
+	uint64 PlaybackStartCycles = 0;
+
+	FDelegateHandle TickStartHandle;
+
+public:
+
+	/** Returns the replay subsystem of the object's world while a replay records or plays back, nullptr otherwise */
+	static UShooterReplaySubsystem* Get(const UObject* WorldContextObject);
+
+	bool IsRecording() const { return bRecording; }
+	bool IsPlayingBack() const { return bPlayingBack; }
+
+	/** Returns the world seed of the match */
+	int32 GetSeed() const { return Seed; }
+
+	/** Records a weapon action of the player pawn */
+	void RecordPlayerAction(const APawn* Pawn, EShooterReplayRecord Action);
+
+	/** Records a gravity well activation, or checks it against the recording */
+	void RecordWellActivation(const FVector& Location);
+
+	/** Records an NPC starting to shoot at a target or stopping when the target is null, or checks it against the recording */
+	void RecordNpcDecision(const AActor* Npc, const AActor* Target);
+
+protected:
+
+	//~Begin UWorldSubsystem interface
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+	//~End UWorldSubsystem interface
+
+	/** Opens the stream and writes its header */
+	bool StartRecording(const FString& InFilePath);
+
+	/** Loads a stream for playback */
+	bool StartPlayback(const FString& InFilePath);
+
+	/** Flushes and closes the recorded stream */
+	void StopRecording();
+
+	/** Adds a checked event, either to the stream or to the current playback frame */
+	void RecordCheck(FReplayEvent&& Event);
+
+	/** Compares the checked events of the current playback frame with the recorded ones */
+	void CompareChecks();
+
+	/** Logs the playback summary and exits */
+	void FinishPlayback(int32 ExitCode);
+
+	/** Starts a frame. Writes it while recording, applies it while playing back */
+	void OnWorldTickStart(UWorld* InWorld, ELevelTick TickType, float DeltaTime);
+
+	/** Stream identification. The version is bumped whenever the record layout changes */
+	static constexpr uint32 Magic = 0x4C505247; // 'GRPL'
+	static constexpr uint32 Version = 1;
+};
@@ -0,0 +1,317 @@
+#include "ShooterSpawnPointSubsystem.h"
+#include "GameFramework/PlayerStart.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/Pawn.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "GravityWellSubsystem.h"
+#include "GravityWellActor.h"
+#include "ShooterRandomSubsystem.h"
+#include "HAL/IConsoleManager.h"
+
+namespace
+{
+	TAutoConsoleVariable<float> CVarSpawnScoreInterval(
+		TEXT("Shooter.Spawn.ScoreInterval"),
+		0.5f,
+		TEXT("Seconds between spawn point rankings."),
+		ECVF_Default);
+
+	TAutoConsoleVariable<float> CVarSpawnDeathMemory(
+		TEXT("Shooter.Spawn.DeathMemory"),
+		10.0f,
+		TEXT("Seconds a death keeps lowering the score of nearby spawn points."),
+		ECVF_Default);
+
+	/** Enemy distance past which a spawn point is considered fully safe */
+	constexpr float KSafeEnemyDistance = 3000.0f;
+
+	/** Radius around a recent death where spawn points are penalized */
+	constexpr float KDeathPenaltyRadius = 1500.0f;
+
+	/** Extra clearance around a gravity well's influence radius */
+	constexpr float KWellClearance = 200.0f;
+
+	/** Score of spawn points inside a gravity well. They are only used if every spawn point is inside one */
+	constexpr float KInsideWellScore = -1000.0f;
+}
+
+APlayerStart* UShooterSpawnPointSubsystem::ClaimBestSpawnPoint()
+{
+	// take a fresher ranking if the worker has finished one since the last tick
+	TryAdoptScoringTask();
+
+	// no ranking yet, or every ranked player start has been claimed. Rank right away on the game thread
+	if (NextRankedIndex >= RankedSpawnPoints.Num())
+	{
+		AdoptRanking(ScoreSpawnPoints(GatherScoringInput()));
+	}
+
+	while (NextRankedIndex < RankedSpawnPoints.Num())
+	{
+		if (APlayerStart* PlayerStart = RankedSpawnPoints[NextRankedIndex++].PlayerStart.Get())
+		{
+			return PlayerStart;
+		}
+	}
+
+	return nullptr;
+}
+
+void UShooterSpawnPointSubsystem::RecordDeath(const FVector& Location)
+{
+	RecentDeaths.Emplace(Location, GetWorld()->GetTimeSeconds());
+
+	// a ranking in flight was gathered before this death. Let it finish and rank again as soon as it's adopted
+	if (ScoringTask.IsValid())
+	{
+		bDeathRankingPending = true;
+		return;
+	}
+
+	LaunchScoring();
+}
+
+bool UShooterSpawnPointSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UShooterSpawnPointSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	for (const ULevel* Level : InWorld.GetLevels())
+	{
+		IndexLevel(Level);
+	}
+
+	LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &UShooterSpawnPointSubsystem::OnLevelAdded);
+	LevelRemovedHandle = FWorldDelegates::LevelRemovedFromWorld.AddUObject(this, &UShooterSpawnPointSubsystem::OnLevelRemoved);
+}
+
+void UShooterSpawnPointSubsystem::Deinitialize()
+{
+	FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+	FWorldDelegates::LevelRemovedFromWorld.Remove(LevelRemovedHandle);
+
+	// the task only works on its own copies, but don't leave it running past the world
+	if (ScoringTask.IsValid())
+	{
+		ScoringTask.Wait();
+	}
+
+	Super::Deinitialize();
+}
+
+void UShooterSpawnPointSubsystem::Tick(float DeltaTime)
+{
+	// pick up the results of the last ranking
+	if (!TryAdoptScoringTask())
+	{
+		return;
+	}
+
+	const double Now = GetWorld()->GetTimeSeconds();
+	if (PlayerStarts.IsEmpty() || (!bDeathRankingPending && Now - LastScoringTime < CVarSpawnScoreInterval.GetValueOnGameThread()))
+	{
+		return;
+	}
+
+	LaunchScoring();
+}
+
+void UShooterSpawnPointSubsystem::LaunchScoring()
+{
+	LastScoringTime = GetWorld()->GetTimeSeconds();
+	bDeathRankingPending = false;
+
+	ScoringTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, [Input = GatherScoringInput()]()
+	{
+		return ScoreSpawnPoints(Input);
+	});
+}
+
+bool UShooterSpawnPointSubsystem::TryAdoptScoringTask()
+{
+	if (ScoringTask.IsValid())
+	{
+		if (!ScoringTask.IsCompleted())
+		{
+			return false;
+		}
+
+		AdoptRanking(MoveTemp(ScoringTask.GetResult()));
+		ScoringTask = {};
+	}
+
+	return true;
+}
+
+TStatId UShooterSpawnPointSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterSpawnPointSubsystem, STATGROUP_Tickables);
+}
+
+void UShooterSpawnPointSubsystem::OnLevelAdded(ULevel* Level, UWorld* InWorld)
+{
+	if (InWorld == GetWorld())
+	{
+		IndexLevel(Level);
+	}
+}
+
+void UShooterSpawnPointSubsystem::OnLevelRemoved(ULevel* Level, UWorld* InWorld)
+{
+	if (InWorld != GetWorld())
+	{
+		return;
+	}
+
+	// a null level means every level is going away
+	PlayerStarts.RemoveAllSwap([Level](const TWeakObjectPtr<APlayerStart>& PlayerStart)
+	{
+		return !PlayerStart.IsValid() || !Level || PlayerStart->GetLevel() == Level;
+	}, EAllowShrinking::No);
+}
+
+void UShooterSpawnPointSubsystem::IndexLevel(const ULevel* Level)
+{
+	if (!Level)
+	{
+		return;
+	}
+
+	// a level can be indexed twice when it finishes streaming in during begin play
+	TSet<TWeakObjectPtr<APlayerStart>> Indexed(PlayerStarts);
+
+	for (AActor* Actor : Level->Actors)
+	{
+		if (APlayerStart* PlayerStart = Cast<APlayerStart>(Actor))
+		{
+			bool bAlreadyIndexed = false;
+			Indexed.Add(PlayerStart, &bAlreadyIndexed);
+
+			if (!bAlreadyIndexed)
+			{
+				PlayerStarts.Add(PlayerStart);
+			}
+		}
+	}
+}
+
+UShooterSpawnPointSubsystem::FScoringInput UShooterSpawnPointSubsystem::GatherScoringInput()
+{
+	UWorld* World = GetWorld();
+	const double Now = World->GetTimeSeconds();
+
+	FScoringInput Input;
+
+	Input.PlayerStarts.Reserve(PlayerStarts.Num());
+	Input.SpawnLocations.Reserve(PlayerStarts.Num());
+
+	for (const TWeakObjectPtr<APlayerStart>& PlayerStart : PlayerStarts)
+	{
+		if (const APlayerStart* Start = PlayerStart.Get())
+		{
+			Input.PlayerStarts.Add(PlayerStart);
+			Input.SpawnLocations.Add(Start->GetActorLocation());
+		}
+	}
+
+	// enemies are the live pawns driven by AI. Walking the controllers avoids iterating the whole actor list
+	for (FConstControllerIterator It = World->GetControllerIterator(); It; ++It)
+	{
+		const AController* Controller = It->Get();
+		const APawn* Pawn = Controller ? Controller->GetPawn() : nullptr;
+
+		if (Pawn && !Controller->IsPlayerController() && !Pawn->IsHidden())
+		{
+			Input.EnemyLocations.Add(Pawn->GetActorLocation());
+		}
+	}
+
+	if (UGravityWellSubsystem* GravityWells = World->GetSubsystem<UGravityWellSubsystem>())
+	{
+		for (const TWeakObjectPtr<AGravityWellActor>& Well : GravityWells->GetWells())
+		{
+			if (const AGravityWellActor* WellActor = Well.Get())
+			{
+				Input.WellSpheres.Emplace(WellActor->GetWellLocation(), WellActor->GetMaxRadius() + KWellClearance);
+			}
+		}
+	}
+
+	// forget old deaths
+	const double DeathMemory = CVarSpawnDeathMemory.GetValueOnGameThread();
+	RecentDeaths.RemoveAll([Now, DeathMemory](const TPair<FVector, double>& Death) { return Now - Death.Value > DeathMemory; });
+
+	for (const TPair<FVector, double>& Death : RecentDeaths)
+	{
+		Input.DeathLocations.Add(Death.Key);
+	}
+
+	// the worker can't touch the stream, so it gets a seed drawn from it instead
+	Input.TieBreakSeed = int32(UShooterRandomSubsystem::GetStream(this).GetUnsignedInt());
+
+	return Input;
+}
+
+TArray<UShooterSpawnPointSubsystem::FRankedSpawnPoint> UShooterSpawnPointSubsystem::ScoreSpawnPoints(const FScoringInput& Input)
+{
+	TArray<FRankedSpawnPoint> Ranking;
+	Ranking.Reserve(Input.PlayerStarts.Num());
+
+	FRandomStream TieBreakStream(Input.TieBreakSeed);
+
+	for (int32 Index = 0; Index < Input.PlayerStarts.Num(); ++Index)
+	{
+		const FVector& SpawnLocation = Input.SpawnLocations[Index];
+
+		FRankedSpawnPoint& Ranked = Ranking.AddDefaulted_GetRef();
+		Ranked.PlayerStart = Input.PlayerStarts[Index];
+		Ranked.TieBreak = TieBreakStream.GetUnsignedInt();
+
+		// never drop players into a black hole unless there's no other choice
+		const bool bInsideWell = Input.WellSpheres.ContainsByPredicate([&SpawnLocation](const FSphere& Well)
+		{
+			return FVector::DistSquared(SpawnLocation, Well.Center) < FMath::Square(Well.W);
+		});
+
+		if (bInsideWell)
+		{
+			Ranked.Score = KInsideWellScore;
+			continue;
+		}
+
+		// prefer spawn points far from the closest enemy
+		float ClosestEnemyDistSq = FMath::Square(KSafeEnemyDistance);
+		for (const FVector& EnemyLocation : Input.EnemyLocations)
+		{
+			ClosestEnemyDistSq = FMath::Min(ClosestEnemyDistSq, float(FVector::DistSquared(SpawnLocation, EnemyLocation)));
+		}
+
+		Ranked.Score = FMath::Sqrt(ClosestEnemyDistSq) / KSafeEnemyDistance;
+
+		// and away from where players died recently
+		for (const FVector& DeathLocation : Input.DeathLocations)
+		{
+			const float DeathDist = float(FVector::Dist(SpawnLocation, DeathLocation));
+			Ranked.Score -= FMath::Max(0.0f, 1.0f - DeathDist / KDeathPenaltyRadius);
+		}
+	}
+
+	// safe spawn points all score the same, so the tie break spreads respawns across them
+	Ranking.Sort([](const FRankedSpawnPoint& A, const FRankedSpawnPoint& B)
+	{
+		return A.Score != B.Score ? A.Score > B.Score : A.TieBreak < B.TieBreak;
+	});
+
+	return Ranking;
+}
+
+void UShooterSpawnPointSubsystem::AdoptRanking(TArray<FRankedSpawnPoint>&& Ranking)
+{
+	RankedSpawnPoints = MoveTemp(Ranking);
+	NextRankedIndex = 0;
+}
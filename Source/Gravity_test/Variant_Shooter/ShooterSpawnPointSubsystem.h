@@ -0,0 +1,120 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tasks/Task.h"
+#include "ShooterSpawnPointSubsystem.generated.h"
+
+class APlayerStart;
+class ULevel;
+
+/**
+ *  Keeps an index of the player starts in the world and ranks them for respawns
+ *  Player starts are gathered once and kept up to date as levels stream in and out.
+ *  Candidates are scored on a worker thread by distance to AI enemies, active gravity wells and recent deaths,
+ *  and the ranked list is refreshed periodically so picking a respawn is a constant time pop
+ */
+UCLASS()
+class GRAVITY_TEST_API UShooterSpawnPointSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** A player start with its score from the last ranking */
+	struct FRankedSpawnPoint
+	{
+		TWeakObjectPtr<APlayerStart> PlayerStart;
+		float Score = 0.0f;
+
+		/** Random order among equally scored player starts */
+		uint32 TieBreak = 0;
+	};
+
+	/** Game thread snapshot of everything the scoring needs, so the worker never touches UObjects */
+	struct FScoringInput
+	{
+		TArray<TWeakObjectPtr<APlayerStart>> PlayerStarts;
+		TArray<FVector> SpawnLocations;
+		TArray<FVector> EnemyLocations;
+		TArray<FSphere> WellSpheres;
+		TArray<FVector> DeathLocations;
+
+		/** Seed for the tie breaks, drawn from the subsystem's random stream */
+		int32 TieBreakSeed = 0;
+	};
+
+	/** Every indexed player start */
+	TArray<TWeakObjectPtr<APlayerStart>> PlayerStarts;
+
+	/** Player starts sorted by descending score */
+	TArray<FRankedSpawnPoint> RankedSpawnPoints;
+
+	/** Index of the next ranked player start to hand out. Claimed player starts are skipped until the next ranking */
+	int32 NextRankedIndex = 0;
+
+	/** Recent death locations and the world time they happened at */
+	TArray<TPair<FVector, double>> RecentDeaths;
+
+	/** Scoring task in flight, if any */
+	UE::Tasks::TTask<TArray<FRankedSpawnPoint>> ScoringTask;
+
+	/** World time the last ranking was requested at */
+	double LastScoringTime = -UE_BIG_NUMBER;
+
+	/** True if a death happened after the ranking in flight was gathered, so another ranking follows it right away */
+	bool bDeathRankingPending = false;
+
+	/** Handles for the level streaming delegates */
+	FDelegateHandle LevelAddedHandle;
+	FDelegateHandle LevelRemovedHandle;
+
+public:
+
+	/** Returns the best ranked player start and skips it for later claims until the next ranking. Returns nullptr if there are none */
+	APlayerStart* ClaimBestSpawnPoint();
+
+	/**
+	 *  Remembers a death so nearby player starts score lower for a while, and starts ranking the player starts with it on a worker.
+	 *  Claims keep using the previous ranking until that one is ready, so record deaths when they happen, ahead of the respawn
+	 */
+	void RecordDeath(const FVector& Location);
+
+	/** Returns the number of indexed player starts */
+	int32 GetNumSpawnPoints() const { return PlayerStarts.Num(); }
+
+protected:
+
+	//~Begin UWorldSubsystem interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+	//~End UWorldSubsystem interface
+
+	//~Begin FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	//~End FTickableGameObject interface
+
+	/** Indexes the player starts of a level that was added to the world */
+	void OnLevelAdded(ULevel* Level, UWorld* InWorld);
+
+	/** Drops the player starts of a level that was removed from the world */
+	void OnLevelRemoved(ULevel* Level, UWorld* InWorld);
+
+	/** Adds the player starts of the level to the index */
+	void IndexLevel(const ULevel* Level);
+
+	/** Copies the scoring inputs off the world */
+	FScoringInput GatherScoringInput();
+
+	/** Gathers the scoring inputs and ranks the player starts on a worker */
+	void LaunchScoring();
+
+	/** Adopts the ranking in flight if it's done. Returns false if it's still running */
+	bool TryAdoptScoringTask();
+
+	/** Scores and sorts the player starts. Safe to run on any thread */
+	static TArray<FRankedSpawnPoint> ScoreSpawnPoints(const FScoringInput& Input);
+
+	/** Replaces the ranking with fresh results */
+	void AdoptRanking(TArray<FRankedSpawnPoint>&& Ranking);
+};
@@ -2,4 +2,48 @@
 
 
 #include "ShooterBulletCounterUI.h"
+#include "HUDModelSubsystem.h"
+#include "Engine/LocalPlayer.h"
 
+void UShooterBulletCounterUI::NativeConstruct()
+{
+	Super::NativeConstruct();
+
+	// subscribe to the HUD model
+	if (ULocalPlayer* LocalPlayer = GetOwningLocalPlayer())
+	{
+		HUDModel = LocalPlayer->GetSubsystem<UHUDModelSubsystem>();
+
+		if (HUDModel.IsValid())
+		{
+			HUDModel->OnFlushed.AddUObject(this, &UShooterBulletCounterUI::OnHUDModelFlushed);
+
+			// the model may already hold values that won't change again, e.g. after a level travel
+			HUDModel->RefreshAll();
+		}
+	}
+}
+
+void UShooterBulletCounterUI::NativeDestruct()
+{
+	// unsubscribe from the HUD model
+	if (HUDModel.IsValid())
+	{
+		HUDModel->OnFlushed.RemoveAll(this);
+	}
+
+	Super::NativeDestruct();
+}
+
+void UShooterBulletCounterUI::OnHUDModelFlushed(EHUDModelField ChangedFields)
+{
+	if (EnumHasAnyFlags(ChangedFields, EHUDModelField::Ammo))
+	{
+		BP_UpdateBulletCounter(HUDModel->GetMagazineSize(), HUDModel->GetBullets());
+	}
+
+	if (EnumHasAnyFlags(ChangedFields, EHUDModelField::Life))
+	{
+		BP_Damaged(HUDModel->GetLifePercent());
+	}
+}
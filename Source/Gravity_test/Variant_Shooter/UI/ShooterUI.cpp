@@ -2,4 +2,46 @@
 
 
 #include "ShooterUI.h"
+#include "HUDModelSubsystem.h"
+#include "Engine/LocalPlayer.h"
 
+void UShooterUI::NativeConstruct()
+{
+	Super::NativeConstruct();
+
+	// subscribe to the HUD model
+	if (ULocalPlayer* LocalPlayer = GetOwningLocalPlayer())
+	{
+		HUDModel = LocalPlayer->GetSubsystem<UHUDModelSubsystem>();
+
+		if (HUDModel.IsValid())
+		{
+			HUDModel->OnFlushed.AddUObject(this, &UShooterUI::OnHUDModelFlushed);
+
+			// the model may already hold values that won't change again, e.g. after a level travel
+			HUDModel->RefreshAll();
+		}
+	}
+}
+
+void UShooterUI::NativeDestruct()
+{
+	// unsubscribe from the HUD model
+	if (HUDModel.IsValid())
+	{
+		HUDModel->OnFlushed.RemoveAll(this);
+	}
+
+	Super::NativeDestruct();
+}
+
+void UShooterUI::OnHUDModelFlushed(EHUDModelField ChangedFields)
+{
+	if (EnumHasAnyFlags(ChangedFields, EHUDModelField::Score))
+	{
+		for (uint8 TeamByte : HUDModel->GetChangedTeams())
+		{
+			BP_UpdateScore(TeamByte, HUDModel->GetTeamScore(TeamByte));
+		}
+	}
+}
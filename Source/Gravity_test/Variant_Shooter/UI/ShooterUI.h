@@ -6,14 +6,32 @@
 #include "Blueprint/UserWidget.h"
 #include "ShooterUI.generated.h"
 
+class UHUDModelSubsystem;
+enum class EHUDModelField : uint8;
+
 /**
  *  Simple scoreboard UI for a first person shooter game
+ *  Updates from the owning player's HUD model, at most once per frame and only when scores change
  */
-UCLASS(abstract)
+UCLASS(abstract, meta = (DisableNativeTick))
 class GRAVITY_TEST_API UShooterUI : public UUserWidget
 {
 	GENERATED_BODY()
 	
+protected:
+
+	/** Subscribes to the HUD model */
+	virtual void NativeConstruct() override;
+
+	/** Unsubscribes from the HUD model */
+	virtual void NativeDestruct() override;
+
+	/** Passes the changed scores to Blueprint */
+	void OnHUDModelFlushed(EHUDModelField ChangedFields);
+
+	/** HUD model this widget is subscribed to */
+	TWeakObjectPtr<UHUDModelSubsystem> HUDModel;
+
 public:
 
 	/** Allows Blueprint to update score sub-widgets */
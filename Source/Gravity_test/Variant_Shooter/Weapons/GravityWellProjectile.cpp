@@ -5,6 +5,10 @@
 #include "GameFramework/ProjectileMovementComponent.h"
 #include "Engine/World.h"
 #include "TimerManager.h"
+#include "Gravity_test.h"
+#include "GravityFlightRecorder.h"
+#include "ShooterLatencySubsystem.h"
+#include "ShooterReplaySubsystem.h"
 
 AGravityWellProjectile::AGravityWellProjectile()
 {
@@ -20,6 +24,7 @@ void AGravityWellProjectile::EndPlay(EEndPlayReason::Type EndPlayReason)
 {
 	if (bBlackHoleActive)
 	{
+		GravityFlightRecorder::Record(GravityFlightRecorder::EEvent::WellDeactivate, this, ActiveWell.Get());
 		OnBlackHoleDeactivated.Broadcast(this);
 		BP_OnBlackHoleDeactivated();
 		bBlackHoleActive = false;
@@ -60,6 +65,16 @@ void AGravityWellProjectile::ActivateBlackHole()
 	bBlackHoleActive = true;
 	bHit = true;
 
+	if (UShooterLatencySubsystem* Latency = GetWorld()->GetSubsystem<UShooterLatencySubsystem>())
+	{
+		Latency->MarkActivate(this);
+	}
+
+	if (UShooterReplaySubsystem* Replay = UShooterReplaySubsystem::Get(this))
+	{
+		Replay->RecordWellActivation(GetActorLocation());
+	}
+
 	// Stop any further movement or collision.
 	if (ProjectileMovement)
 	{
@@ -76,6 +91,8 @@ void AGravityWellProjectile::ActivateBlackHole()
 
 	SpawnGravityWell();
 
+	GravityFlightRecorder::Record(GravityFlightRecorder::EEvent::WellActivate, this, ActiveWell.Get(), GetActorLocation());
+
 	OnBlackHoleActivated.Broadcast(this);
 	BP_OnBlackHoleActivated();
 }
@@ -90,6 +107,8 @@ void AGravityWellProjectile::DeactivateBlackHole()
 
 	bBlackHoleActive = false;
 
+	GravityFlightRecorder::Record(GravityFlightRecorder::EEvent::WellDeactivate, this, ActiveWell.Get());
+
 	OnBlackHoleDeactivated.Broadcast(this);
 	BP_OnBlackHoleDeactivated();
 
@@ -113,6 +132,8 @@ void AGravityWellProjectile::SpawnGravityWell()
 		return;
 	}
 
+	LLM_SCOPE_BYTAG(Gravity_Wells);
+
 	const FTransform SpawnTransform = FTransform(GetActorRotation(), GetActorLocation() + WellSpawnOffset);
 
 	FActorSpawnParameters SpawnParams;
@@ -161,6 +182,7 @@ void AGravityWellProjectile::HandleWellDestroyed(AActor* DestroyedActor)
 
 	if (bBlackHoleActive)
 	{
+		GravityFlightRecorder::Record(GravityFlightRecorder::EEvent::WellDeactivate, this, DestroyedActor);
 		bBlackHoleActive = false;
 		OnBlackHoleDeactivated.Broadcast(this);
 		BP_OnBlackHoleDeactivated();
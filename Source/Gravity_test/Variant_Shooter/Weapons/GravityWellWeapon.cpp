@@ -1,6 +1,8 @@
 #include "GravityWellWeapon.h"
 
 #include "GravityWellProjectile.h"
+#include "ShooterLatencySubsystem.h"
+#include "Engine/World.h"
 
 AGravityWellWeapon::AGravityWellWeapon()
 {
@@ -21,6 +23,11 @@ void AGravityWellWeapon::StartFiring()
 	{
 		if (!Pending->IsBlackHoleActive())
 		{
+			if (UShooterLatencySubsystem* Latency = GetWorld()->GetSubsystem<UShooterLatencySubsystem>())
+			{
+				Latency->MarkActivationInput(this, Pending);
+			}
+
 			Pending->ActivateBlackHole();
 		}
 
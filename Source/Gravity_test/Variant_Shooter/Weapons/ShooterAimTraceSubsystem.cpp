@@ -0,0 +1,114 @@
+#include "ShooterAimTraceSubsystem.h"
+#include "Engine/World.h"
+#include "CollisionQueryParams.h"
+#include "HAL/IConsoleManager.h"
+
+namespace
+{
+	TAutoConsoleVariable<bool> CVarShooterAsyncAimTraces(
+		TEXT("Shooter.AimTrace.Async"),
+		true,
+		TEXT("If true, weapons not held by a local player resolve their aim through batched async traces on the next frame."),
+		ECVF_Default);
+}
+
+bool UShooterAimTraceSubsystem::IsAsyncAimEnabled()
+{
+	return CVarShooterAsyncAimTraces.GetValueOnGameThread();
+}
+
+void UShooterAimTraceSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	TraceCompletedDelegate.BindUObject(this, &UShooterAimTraceSubsystem::OnAimTraceCompleted);
+}
+
+void UShooterAimTraceSubsystem::Deinitialize()
+{
+	// drop any outstanding requests. Their owners are going away with the world
+	QueuedTraces.Reset();
+	InFlightTraces.Reset();
+	TraceCompletedDelegate.Unbind();
+
+	Super::Deinitialize();
+}
+
+bool UShooterAimTraceSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UShooterAimTraceSubsystem::RequestAimTrace(const FVector& Start, const FVector& End, const AActor* IgnoredActor, FShooterAimTraceResolvedDelegate&& OnResolved)
+{
+	FQueuedAimTrace& Trace = QueuedTraces.AddDefaulted_GetRef();
+	Trace.Start = Start;
+	Trace.End = End;
+	Trace.IgnoredActor = IgnoredActor;
+	Trace.OnResolved = MoveTemp(OnResolved);
+}
+
+void UShooterAimTraceSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	FlushQueuedTraces();
+}
+
+TStatId UShooterAimTraceSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterAimTraceSubsystem, STATGROUP_Tickables);
+}
+
+void UShooterAimTraceSubsystem::FlushQueuedTraces()
+{
+	if (QueuedTraces.IsEmpty())
+	{
+		return;
+	}
+
+	UWorld* World = GetWorld();
+	check(World);
+
+	for (FQueuedAimTrace& Trace : QueuedTraces)
+	{
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ShooterAimTrace), false);
+		if (const AActor* IgnoredActor = Trace.IgnoredActor.Get())
+		{
+			QueryParams.AddIgnoredActor(IgnoredActor);
+		}
+
+		const uint32 TraceId = NextTraceId++;
+
+		// the async trace system runs every trace requested this frame in parallel
+		World->AsyncLineTraceByChannel(EAsyncTraceType::Single, Trace.Start, Trace.End, ECC_Visibility, QueryParams, FCollisionResponseParams::DefaultResponseParam, &TraceCompletedDelegate, TraceId);
+
+		InFlightTraces.Add(TraceId, MoveTemp(Trace.OnResolved));
+	}
+
+	QueuedTraces.Reset();
+}
+
+void UShooterAimTraceSubsystem::OnAimTraceCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+	FShooterAimTraceResolvedDelegate OnResolved;
+	if (!InFlightTraces.RemoveAndCopyValue(TraceDatum.UserData, OnResolved))
+	{
+		return;
+	}
+
+	// return either the impact point or the trace end
+	FVector TargetLocation = TraceDatum.End;
+
+	for (const FHitResult& Hit : TraceDatum.OutHits)
+	{
+		if (Hit.bBlockingHit)
+		{
+			TargetLocation = Hit.ImpactPoint;
+			break;
+		}
+	}
+
+	// the weapon may have been destroyed while the trace was in flight
+	OnResolved.ExecuteIfBound(TargetLocation);
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WorldCollision.h"
+#include "ShooterAimTraceSubsystem.generated.h"
+
+/** Called on the game thread with the resolved aim location of a deferred aim trace */
+DECLARE_DELEGATE_OneParam(FShooterAimTraceResolvedDelegate, const FVector& /*TargetLocation*/);
+
+/**
+ *  Batches weapon aim traces requested during a frame
+ *  All queued traces are submitted together through the async trace system once per frame,
+ *  and their results are handed back to the requesting weapons on the following frame
+ */
+UCLASS()
+class GRAVITY_TEST_API UShooterAimTraceSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** A single aim trace waiting to be submitted */
+	struct FQueuedAimTrace
+	{
+		FVector Start;
+		FVector End;
+		TWeakObjectPtr<const AActor> IgnoredActor;
+		FShooterAimTraceResolvedDelegate OnResolved;
+	};
+
+	/** Aim traces requested this frame, submitted on the next subsystem tick */
+	TArray<FQueuedAimTrace> QueuedTraces;
+
+	/** Resolve callbacks for traces already submitted to the async trace system, keyed by trace user data */
+	TMap<uint32, FShooterAimTraceResolvedDelegate> InFlightTraces;
+
+	/** Delegate passed to every async trace. Routes completions back to this subsystem */
+	FTraceDelegate TraceCompletedDelegate;
+
+	/** Id assigned to the next submitted trace */
+	uint32 NextTraceId = 1;
+
+public:
+
+	/** Returns true if deferred aim traces are enabled through the Shooter.AimTrace.Async console variable */
+	static bool IsAsyncAimEnabled();
+
+	/** Queues an aim trace. The delegate is executed on a later frame with either the impact point or the trace end */
+	void RequestAimTrace(const FVector& Start, const FVector& End, const AActor* IgnoredActor, FShooterAimTraceResolvedDelegate&& OnResolved);
+
+	/** Returns the number of traces waiting to be submitted or completed */
+	int32 GetNumPendingTraces() const { return QueuedTraces.Num() + InFlightTraces.Num(); }
+
+protected:
+
+	//~Begin UWorldSubsystem interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~End UWorldSubsystem interface
+
+	//~Begin FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	//~End FTickableGameObject interface
+
+	/** Submits every queued trace to the async trace system */
+	void FlushQueuedTraces();
+
+	/** Called by the async trace system when a submitted trace completes */
+	void OnAimTraceCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+};
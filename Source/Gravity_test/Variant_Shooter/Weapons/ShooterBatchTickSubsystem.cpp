@@ -0,0 +1,253 @@
+#include "ShooterBatchTickSubsystem.h"
+#include "ShooterProjectile.h"
+#include "Components/ActorComponent.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+#include "Gravity_test.h"
+
+namespace
+{
+	/** Weight of the latest frame in the smoothed batch costs */
+	constexpr float KBatchCostSmoothing = 0.1f;
+
+	/** Frames timed by Shooter.DumpTicking when none are given */
+	constexpr int32 KDefaultTickCaptureFrames = 60;
+
+	/** Returns true if the class, or the native class a Blueprint derives from, is declared in this module */
+	bool IsGameModuleClass(const UClass* Class)
+	{
+		static const FName ModulePackage(TEXT("/Script/" UE_MODULE_NAME));
+
+		while (Class && !Class->HasAnyClassFlags(CLASS_Native))
+		{
+			Class = Class->GetSuperClass();
+		}
+
+		return Class && Class->GetOutermost()->GetFName() == ModulePackage;
+	}
+
+	void DumpTicking(const TArray<FString>& Args, UWorld* World)
+	{
+		UShooterBatchTickSubsystem* BatchTick = World ? World->GetSubsystem<UShooterBatchTickSubsystem>() : nullptr;
+		if (!BatchTick)
+		{
+			return;
+		}
+
+		int32 NumFrames = KDefaultTickCaptureFrames;
+		if (Args.Num() > 0)
+		{
+			LexFromString(NumFrames, *Args[0]);
+		}
+
+		BatchTick->DumpBatches();
+		BatchTick->StartTickCapture(FMath::Max(NumFrames, 1));
+	}
+
+	FAutoConsoleCommandWithWorldAndArgs DumpTickingCommand(
+		TEXT("Shooter.DumpTicking"),
+		TEXT("Lists every ticking actor and component from the game module, times them over the next frames and logs their cost. Usage: Shooter.DumpTicking [Frames]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&DumpTicking));
+}
+
+void FShooterTimedTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	// the original tick function goes away with its owner
+	if (!Owner.IsValid())
+	{
+		return;
+	}
+
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+	Inner->ExecuteTick(DeltaTime, TickType, CurrentThread, MyCompletionGraphEvent);
+
+	TotalMs += FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles);
+	++NumTicks;
+}
+
+void UShooterBatchTickSubsystem::RegisterProjectile(AShooterProjectile* Projectile, float Lifetime)
+{
+	if (!Projectile || Lifetime <= 0.0f)
+	{
+		return;
+	}
+
+	UnregisterProjectile(Projectile);
+
+	Projectiles.Add(Projectile);
+	ProjectileExpireTimes.Add(GetWorld()->GetTimeSeconds() + Lifetime);
+}
+
+void UShooterBatchTickSubsystem::UnregisterProjectile(AShooterProjectile* Projectile)
+{
+	const int32 Index = Projectiles.IndexOfByKey(Projectile);
+	if (Index != INDEX_NONE)
+	{
+		Projectiles.RemoveAtSwap(Index, EAllowShrinking::No);
+		ProjectileExpireTimes.RemoveAtSwap(Index, EAllowShrinking::No);
+	}
+}
+
+void UShooterBatchTickSubsystem::DumpBatches() const
+{
+	UE_LOG(LogGravity_test, Display, TEXT("  Batch Projectiles: %d entries, %.3fms"), Projectiles.Num(), ProjectileBatchMs);
+}
+
+void UShooterBatchTickSubsystem::StartTickCapture(int32 NumFrames)
+{
+	if (TickCaptureFramesLeft > 0)
+	{
+		UE_LOG(LogGravity_test, Warning, TEXT("A tick capture is already running, %d frames left."), TickCaptureFramesLeft);
+		return;
+	}
+
+	for (TActorIterator<AActor> It(GetWorld()); It; ++It)
+	{
+		AActor* Actor = *It;
+
+		if (Actor->IsActorTickEnabled() && IsGameModuleClass(Actor->GetClass()))
+		{
+			UE_LOG(LogGravity_test, Display, TEXT("  Actor %s (%s) group %d, interval %.3fs"),
+				*Actor->GetName(), *Actor->GetClass()->GetName(), int32(Actor->PrimaryActorTick.TickGroup), Actor->GetActorTickInterval());
+
+			AddTimedTick(Actor->PrimaryActorTick, Actor, Actor->GetLevel(), FString::Printf(TEXT("Actor %s (%s)"), *Actor->GetName(), *Actor->GetClass()->GetName()));
+		}
+
+		for (UActorComponent* Component : Actor->GetComponents())
+		{
+			if (Component && Component->IsComponentTickEnabled() && IsGameModuleClass(Component->GetClass()))
+			{
+				UE_LOG(LogGravity_test, Display, TEXT("  Component %s.%s (%s) group %d, interval %.3fs"),
+					*Actor->GetName(), *Component->GetName(), *Component->GetClass()->GetName(), int32(Component->PrimaryComponentTick.TickGroup), Component->GetComponentTickInterval());
+
+				AddTimedTick(Component->PrimaryComponentTick, Component, Actor->GetLevel(), FString::Printf(TEXT("Component %s.%s (%s)"), *Actor->GetName(), *Component->GetName(), *Component->GetClass()->GetName()));
+			}
+		}
+	}
+
+	UE_LOG(LogGravity_test, Display, TEXT("%d ticking actors and components from %s. Timing them over %d frames."), TimedTicks.Num(), TEXT(UE_MODULE_NAME), NumFrames);
+
+	if (TimedTicks.Num() > 0)
+	{
+		TickCaptureFrames = TickCaptureFramesLeft = NumFrames;
+	}
+}
+
+void UShooterBatchTickSubsystem::AddTimedTick(FTickFunction& TickFunction, UObject* Owner, ULevel* Level, FString&& Label)
+{
+	TUniquePtr<FShooterTimedTickFunction>& Timed = TimedTicks.Add_GetRef(MakeUnique<FShooterTimedTickFunction>());
+	Timed->Inner = &TickFunction;
+	Timed->Owner = Owner;
+	Timed->Label = MoveTemp(Label);
+
+	// run the stand-in where the original would have run
+	Timed->bCanEverTick = true;
+	Timed->TickGroup = TickFunction.TickGroup;
+	Timed->EndTickGroup = TickFunction.EndTickGroup;
+	Timed->TickInterval = TickFunction.TickInterval;
+	Timed->bTickEvenWhenPaused = TickFunction.bTickEvenWhenPaused;
+	Timed->bRunOnAnyThread = TickFunction.bRunOnAnyThread;
+	Timed->bHighPriority = TickFunction.bHighPriority;
+
+	for (FTickPrerequisite& Prerequisite : TickFunction.GetPrerequisites())
+	{
+		if (FTickFunction* PrerequisiteFunction = Prerequisite.Get())
+		{
+			Timed->AddPrerequisite(Prerequisite.PrerequisiteObject.Get(), *PrerequisiteFunction);
+		}
+	}
+
+	Timed->RegisterTickFunction(Level);
+	TickFunction.SetTickFunctionEnable(false);
+}
+
+void UShooterBatchTickSubsystem::FinishTickCapture()
+{
+	TickCaptureFramesLeft = 0;
+
+	// hand ticking back to the originals before the stand-ins go away
+	for (const TUniquePtr<FShooterTimedTickFunction>& Timed : TimedTicks)
+	{
+		Timed->UnRegisterTickFunction();
+
+		if (Timed->Owner.IsValid())
+		{
+			Timed->Inner->SetTickFunctionEnable(true);
+		}
+	}
+
+	TimedTicks.Sort([](const TUniquePtr<FShooterTimedTickFunction>& A, const TUniquePtr<FShooterTimedTickFunction>& B)
+	{
+		return A->TotalMs > B->TotalMs;
+	});
+
+	double TotalMs = 0.0;
+	for (const TUniquePtr<FShooterTimedTickFunction>& Timed : TimedTicks)
+	{
+		UE_LOG(LogGravity_test, Display, TEXT("  %s: %.4fms per frame, %.4fms per tick over %d ticks"),
+			*Timed->Label, Timed->TotalMs / TickCaptureFrames, Timed->NumTicks > 0 ? Timed->TotalMs / Timed->NumTicks : 0.0, Timed->NumTicks);
+		TotalMs += Timed->TotalMs;
+	}
+
+	UE_LOG(LogGravity_test, Display, TEXT("%d ticking actors and components from %s cost %.3fms per frame over %d frames."),
+		TimedTicks.Num(), TEXT(UE_MODULE_NAME), TotalMs / TickCaptureFrames, TickCaptureFrames);
+
+	TimedTicks.Reset();
+}
+
+bool UShooterBatchTickSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UShooterBatchTickSubsystem::Deinitialize()
+{
+	// don't leave the timed tick functions disabled if the world goes away mid-capture
+	if (TimedTicks.Num() > 0)
+	{
+		FinishTickCapture();
+	}
+
+	Super::Deinitialize();
+}
+
+void UShooterBatchTickSubsystem::Tick(float DeltaTime)
+{
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+	TickProjectiles(GetWorld()->GetTimeSeconds());
+
+	ProjectileBatchMs = FMath::Lerp(ProjectileBatchMs, float(FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles)), KBatchCostSmoothing);
+
+	if (TickCaptureFramesLeft > 0 && --TickCaptureFramesLeft == 0)
+	{
+		FinishTickCapture();
+	}
+}
+
+TStatId UShooterBatchTickSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterBatchTickSubsystem, STATGROUP_Tickables);
+}
+
+void UShooterBatchTickSubsystem::TickProjectiles(double Now)
+{
+	// walk backwards so expired entries can be swapped out as we go. Expiring may destroy the projectile,
+	// which unregisters it from EndPlay, so remove the entry first
+	for (int32 Index = Projectiles.Num() - 1; Index >= 0; --Index)
+	{
+		if (Index >= Projectiles.Num() || ProjectileExpireTimes[Index] > Now)
+		{
+			continue;
+		}
+
+		AShooterProjectile* Projectile = Projectiles[Index].Get();
+		Projectiles.RemoveAtSwap(Index, EAllowShrinking::No);
+		ProjectileExpireTimes.RemoveAtSwap(Index, EAllowShrinking::No);
+
+		if (IsValid(Projectile))
+		{
+			Projectile->OnLifetimeExpired();
+		}
+	}
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShooterBatchTickSubsystem.generated.h"
+
+class AShooterProjectile;
+
+/**
+ *  Stands in for an actor or component tick function during a tick cost capture
+ *  Runs the original tick function in its place and times every run
+ */
+struct FShooterTimedTickFunction : public FTickFunction
+{
+	/** Tick function being timed. Only run while its owner is alive */
+	FTickFunction* Inner = nullptr;
+
+	/** Actor or component owning the timed tick function */
+	TWeakObjectPtr<UObject> Owner;
+
+	/** Name and class of the owner, for the report */
+	FString Label;
+
+	double TotalMs = 0.0;
+	int32 NumTicks = 0;
+
+	//~Begin FTickFunction interface
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+	virtual FString DiagnosticMessage() override { return Label; }
+	//~End FTickFunction interface
+};
+
+/**
+ *  Runs the per-frame work of projectiles from a single tick
+ *  Projectiles are kept in contiguous arrays and updated in one pass, so the actors themselves never tick.
+ *  Also times the ticking actors and components of the game module for Shooter.DumpTicking
+ */
+UCLASS()
+class GRAVITY_TEST_API UShooterBatchTickSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** In flight projectiles with a max lifetime */
+	TArray<TWeakObjectPtr<AShooterProjectile>> Projectiles;
+
+	/** World time each projectile expires at. Parallel to Projectiles, so the expiry scan only touches the times */
+	TArray<double> ProjectileExpireTimes;
+
+	/** Smoothed cost of the projectile batch, in milliseconds */
+	float ProjectileBatchMs = 0.0f;
+
+	/** Stand-ins timing the module's tick functions while a tick cost capture runs */
+	TArray<TUniquePtr<FShooterTimedTickFunction>> TimedTicks;
+
+	/** Frames left in the running tick cost capture */
+	int32 TickCaptureFramesLeft = 0;
+
+	/** Frames the running tick cost capture was started for */
+	int32 TickCaptureFrames = 0;
+
+public:
+
+	/** Expires the projectile after the given lifetime unless it's unregistered first */
+	void RegisterProjectile(AShooterProjectile* Projectile, float Lifetime);
+
+	/** Stops tracking the projectile */
+	void UnregisterProjectile(AShooterProjectile* Projectile);
+
+	/** Logs the size and cost of each batch */
+	void DumpBatches() const;
+
+	/**
+	 *  Times every ticking actor and component of the game module over the next frames, then logs their cost.
+	 *  Each tick function is swapped for a timed stand-in in the same tick group for the capture,
+	 *  so ticks that list it as a prerequisite may run before it until the capture ends
+	 */
+	void StartTickCapture(int32 NumFrames);
+
+protected:
+
+	//~Begin UWorldSubsystem interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Deinitialize() override;
+	//~End UWorldSubsystem interface
+
+	//~Begin FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	//~End FTickableGameObject interface
+
+	/** Expires projectiles that outlived their lifetime */
+	void TickProjectiles(double Now);
+
+	/** Times the tick function in place of the original for the capture */
+	void AddTimedTick(FTickFunction& TickFunction, UObject* Owner, ULevel* Level, FString&& Label);
+
+	/** Restores the original tick functions and logs the cost of each, most expensive first */
+	void FinishTickCapture();
+};
@@ -0,0 +1,360 @@
+#include "ShooterLatencySubsystem.h"
+#include "ShooterWeapon.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/DateTime.h"
+#include "Misc/Paths.h"
+#include "ProfilingDebugging/CountersTrace.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "Stats/Stats.h"
+#include "Gravity_test.h"
+
+DECLARE_STATS_GROUP(TEXT("ShooterLatency"), STATGROUP_ShooterLatency, STATCAT_Advanced);
+
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Input to Fire (ms)"), STAT_ShooterLatencyInputToFire, STATGROUP_ShooterLatency);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Input to Spawn (ms)"), STAT_ShooterLatencyInputToSpawn, STATGROUP_ShooterLatency);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Input to Activate (ms)"), STAT_ShooterLatencyInputToActivate, STATGROUP_ShooterLatency);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Activate to First Step (ms)"), STAT_ShooterLatencyActivateToFirstStep, STATGROUP_ShooterLatency);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Activate to First Force (ms)"), STAT_ShooterLatencyActivateToFirstForce, STATGROUP_ShooterLatency);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Input to First Force (ms)"), STAT_ShooterLatencyInputToFirstForce, STATGROUP_ShooterLatency);
+
+TRACE_DECLARE_FLOAT_COUNTER(ShooterLatencyInputToFire, TEXT("Shooter/Latency/InputToFire"));
+TRACE_DECLARE_FLOAT_COUNTER(ShooterLatencyInputToSpawn, TEXT("Shooter/Latency/InputToSpawn"));
+TRACE_DECLARE_FLOAT_COUNTER(ShooterLatencyInputToActivate, TEXT("Shooter/Latency/InputToActivate"));
+TRACE_DECLARE_FLOAT_COUNTER(ShooterLatencyActivateToFirstStep, TEXT("Shooter/Latency/ActivateToFirstStep"));
+TRACE_DECLARE_FLOAT_COUNTER(ShooterLatencyActivateToFirstForce, TEXT("Shooter/Latency/ActivateToFirstForce"));
+TRACE_DECLARE_FLOAT_COUNTER(ShooterLatencyInputToFirstForce, TEXT("Shooter/Latency/InputToFirstForce"));
+
+CSV_DEFINE_CATEGORY(ShooterLatency, true);
+
+namespace
+{
+	/** Names of the latencies, as used in the CSV dump and the CSV profiler */
+	const TCHAR* const LatencyNames[] = {
+		TEXT("InputToFire"), TEXT("InputToSpawn"), TEXT("InputToActivate"),
+		TEXT("ActivateToFirstStep"), TEXT("ActivateToFirstForce"), TEXT("InputToFirstForce") };
+
+	const char* const LatencyCsvStatNames[] = {
+		"InputToFire", "InputToSpawn", "InputToActivate",
+		"ActivateToFirstStep", "ActivateToFirstForce", "InputToFirstForce" };
+
+	static_assert(UE_ARRAY_COUNT(LatencyNames) == int32(EShooterLatency::Num), "Every latency needs a name");
+	static_assert(UE_ARRAY_COUNT(LatencyCsvStatNames) == int32(EShooterLatency::Num), "Every latency needs a CSV stat name");
+
+	/** Inputs and shots older than this never completed, e.g. a projectile that never activated */
+	constexpr double KMaxPendingSeconds = 10.0;
+
+	/** Class name used for projectiles that weren't fired by a tracked weapon */
+	const FName UntrackedWeaponType(TEXT("Untracked"));
+
+	void DumpLatency(const TArray<FString>& Args, UWorld* World)
+	{
+		const UShooterLatencySubsystem* Latency = World ? World->GetSubsystem<UShooterLatencySubsystem>() : nullptr;
+		if (!Latency)
+		{
+			return;
+		}
+
+		const FString FilePath = Args.Num() > 0 ? Args[0]
+			: FPaths::ProfilingDir() / FString::Printf(TEXT("ShooterLatency-%s.csv"), *FDateTime::Now().ToString());
+
+		if (Latency->WriteCsv(FilePath))
+		{
+			UE_LOG(LogGravity_test, Display, TEXT("Shooter latency histograms written to %s."), *FilePath);
+		}
+		else
+		{
+			UE_LOG(LogGravity_test, Error, TEXT("Could not write shooter latency histograms to %s."), *FilePath);
+		}
+	}
+
+	void ResetLatency(UWorld* World)
+	{
+		if (UShooterLatencySubsystem* Latency = World ? World->GetSubsystem<UShooterLatencySubsystem>() : nullptr)
+		{
+			Latency->Reset();
+		}
+	}
+
+	FAutoConsoleCommandWithWorldAndArgs DumpLatencyCommand(
+		TEXT("Shooter.Latency.Dump"),
+		TEXT("Writes the input to effect latency histograms of every weapon class to CSV. Usage: Shooter.Latency.Dump [Path]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&DumpLatency));
+
+	FAutoConsoleCommandWithWorld ResetLatencyCommand(
+		TEXT("Shooter.Latency.Reset"),
+		TEXT("Clears the input to effect latency histograms."),
+		FConsoleCommandWithWorldDelegate::CreateStatic(&ResetLatency));
+}
+
+void FShooterLatencyHistogram::Add(float Ms)
+{
+	int32 Bucket = 0;
+	while (Bucket < NumBuckets - 1 && Ms > BucketEdgesMs[Bucket])
+	{
+		++Bucket;
+	}
+
+	++Buckets[Bucket];
+
+	MinMs = Count > 0 ? FMath::Min(MinMs, Ms) : Ms;
+	MaxMs = Count > 0 ? FMath::Max(MaxMs, Ms) : Ms;
+	SumMs += Ms;
+	++Count;
+}
+
+float FShooterLatencyHistogram::GetPercentileMs(float Percentile) const
+{
+	const int32 Target = FMath::CeilToInt32(Percentile * Count);
+	int32 Cumulative = 0;
+
+	for (int32 Bucket = 0; Bucket < NumBuckets - 1; ++Bucket)
+	{
+		Cumulative += Buckets[Bucket];
+		if (Cumulative >= Target)
+		{
+			return FMath::Min(BucketEdgesMs[Bucket], MaxMs);
+		}
+	}
+
+	return MaxMs;
+}
+
+void UShooterLatencySubsystem::MarkInput(const AShooterWeapon* Weapon)
+{
+	if (!Weapon)
+	{
+		return;
+	}
+
+	const uint64 Now = FPlatformTime::Cycles64();
+	PruneStale(Now);
+
+	FPendingInput& Pending = PendingInputs.FindOrAdd(Weapon);
+	Pending.InputCycles = Now;
+	Pending.FireCycles = 0;
+}
+
+void UShooterLatencySubsystem::MarkFire(const AShooterWeapon* Weapon)
+{
+	FPendingInput* Pending = PendingInputs.Find(Weapon);
+
+	// only the first shot after an input counts. Later full auto shots are paced by the refire rate, not latency
+	if (Pending && Pending->FireCycles == 0)
+	{
+		Pending->FireCycles = FPlatformTime::Cycles64();
+		RecordLatency(Weapon->GetClass()->GetFName(), EShooterLatency::InputToFire, Pending->InputCycles, Pending->FireCycles);
+	}
+}
+
+void UShooterLatencySubsystem::MarkProjectileSpawn(const AShooterWeapon* Weapon, const AActor* Projectile)
+{
+	if (!Weapon || !Projectile)
+	{
+		return;
+	}
+
+	// only shots fired on input are tracked. Projectiles activated without one are picked up on activation
+	FPendingInput Pending;
+	if (!PendingInputs.RemoveAndCopyValue(Weapon, Pending))
+	{
+		return;
+	}
+
+	const uint64 Now = FPlatformTime::Cycles64();
+	const FName WeaponType = Weapon->GetClass()->GetFName();
+	RecordLatency(WeaponType, EShooterLatency::InputToSpawn, Pending.InputCycles, Now);
+
+	FShotTimeline& Shot = Shots.Add(Projectile);
+	Shot.WeaponType = WeaponType;
+	Shot.SpawnCycles = Now;
+}
+
+void UShooterLatencySubsystem::MarkActivationInput(const AShooterWeapon* Weapon, const AActor* Projectile)
+{
+	FPendingInput Pending;
+	if (!PendingInputs.RemoveAndCopyValue(Weapon, Pending))
+	{
+		return;
+	}
+
+	if (FShotTimeline* Shot = Shots.Find(Projectile))
+	{
+		Shot->ActivateInputCycles = Pending.InputCycles;
+	}
+}
+
+void UShooterLatencySubsystem::MarkActivate(const AActor* Projectile)
+{
+	if (!Projectile)
+	{
+		return;
+	}
+
+	const uint64 Now = FPlatformTime::Cycles64();
+	PruneStale(Now);
+
+	// projectiles fired without input still measure activation to first force
+	FShotTimeline* Shot = Shots.Find(Projectile);
+	if (!Shot)
+	{
+		Shot = &Shots.Add(Projectile);
+		Shot->WeaponType = UntrackedWeaponType;
+		Shot->SpawnCycles = Now;
+	}
+
+	Shot->ActivateCycles = Now;
+
+	if (Shot->ActivateInputCycles != 0)
+	{
+		RecordLatency(Shot->WeaponType, EShooterLatency::InputToActivate, Shot->ActivateInputCycles, Now);
+	}
+}
+
+bool UShooterLatencySubsystem::MarkWellStep(const AActor* Projectile, bool bAppliedForce)
+{
+	FShotTimeline* Shot = Projectile ? Shots.Find(Projectile) : nullptr;
+	if (!Shot || Shot->ActivateCycles == 0)
+	{
+		return false;
+	}
+
+	const uint64 Now = FPlatformTime::Cycles64();
+
+	if (!Shot->bFirstStepRecorded)
+	{
+		Shot->bFirstStepRecorded = true;
+		RecordLatency(Shot->WeaponType, EShooterLatency::ActivateToFirstStep, Shot->ActivateCycles, Now);
+	}
+
+	if (!bAppliedForce)
+	{
+		return true;
+	}
+
+	RecordLatency(Shot->WeaponType, EShooterLatency::ActivateToFirstForce, Shot->ActivateCycles, Now);
+
+	if (Shot->ActivateInputCycles != 0)
+	{
+		RecordLatency(Shot->WeaponType, EShooterLatency::InputToFirstForce, Shot->ActivateInputCycles, Now);
+	}
+
+	Shots.Remove(Projectile);
+	return false;
+}
+
+bool UShooterLatencySubsystem::WriteCsv(const FString& FilePath) const
+{
+	TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*FilePath));
+	if (!Writer)
+	{
+		return false;
+	}
+
+	FString Csv = TEXT("Weapon,Latency,Count,MinMs,MeanMs,P50Ms,P95Ms,MaxMs");
+	for (float EdgeMs : FShooterLatencyHistogram::BucketEdgesMs)
+	{
+		Csv += FString::Printf(TEXT(",Le%gMs"), EdgeMs);
+	}
+	Csv += TEXT(",Over\n");
+
+	for (const TPair<FName, FWeaponLatencies>& Weapon : Latencies)
+	{
+		for (int32 LatencyIndex = 0; LatencyIndex < int32(EShooterLatency::Num); ++LatencyIndex)
+		{
+			const FShooterLatencyHistogram& Histogram = Weapon.Value.Histograms[LatencyIndex];
+			if (Histogram.Count == 0)
+			{
+				continue;
+			}
+
+			Csv += FString::Printf(TEXT("%s,%s,%d,%.3f,%.3f,%.3f,%.3f,%.3f"), *Weapon.Key.ToString(), LatencyNames[LatencyIndex], Histogram.Count,
+				Histogram.MinMs, Histogram.SumMs / Histogram.Count, Histogram.GetPercentileMs(0.5f), Histogram.GetPercentileMs(0.95f), Histogram.MaxMs);
+
+			for (int32 BucketCount : Histogram.Buckets)
+			{
+				Csv += FString::Printf(TEXT(",%d"), BucketCount);
+			}
+			Csv += TEXT("\n");
+		}
+	}
+
+	const FTCHARToUTF8 Utf8(*Csv);
+	Writer->Serialize(const_cast<ANSICHAR*>(Utf8.Get()), Utf8.Length());
+	return Writer->Close();
+}
+
+void UShooterLatencySubsystem::Reset()
+{
+	PendingInputs.Reset();
+	Shots.Reset();
+	Latencies.Reset();
+}
+
+bool UShooterLatencySubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UShooterLatencySubsystem::RecordLatency(FName WeaponType, EShooterLatency Latency, uint64 StartCycles, uint64 EndCycles)
+{
+	const float Ms = float(FPlatformTime::ToMilliseconds64(EndCycles - StartCycles));
+
+	Latencies.FindOrAdd(WeaponType).Histograms[int32(Latency)].Add(Ms);
+
+	switch (Latency)
+	{
+	case EShooterLatency::InputToFire:
+		SET_FLOAT_STAT(STAT_ShooterLatencyInputToFire, Ms);
+		TRACE_COUNTER_SET(ShooterLatencyInputToFire, Ms);
+		break;
+	case EShooterLatency::InputToSpawn:
+		SET_FLOAT_STAT(STAT_ShooterLatencyInputToSpawn, Ms);
+		TRACE_COUNTER_SET(ShooterLatencyInputToSpawn, Ms);
+		break;
+	case EShooterLatency::InputToActivate:
+		SET_FLOAT_STAT(STAT_ShooterLatencyInputToActivate, Ms);
+		TRACE_COUNTER_SET(ShooterLatencyInputToActivate, Ms);
+		break;
+	case EShooterLatency::ActivateToFirstStep:
+		SET_FLOAT_STAT(STAT_ShooterLatencyActivateToFirstStep, Ms);
+		TRACE_COUNTER_SET(ShooterLatencyActivateToFirstStep, Ms);
+		break;
+	case EShooterLatency::ActivateToFirstForce:
+		SET_FLOAT_STAT(STAT_ShooterLatencyActivateToFirstForce, Ms);
+		TRACE_COUNTER_SET(ShooterLatencyActivateToFirstForce, Ms);
+		break;
+	case EShooterLatency::InputToFirstForce:
+		SET_FLOAT_STAT(STAT_ShooterLatencyInputToFirstForce, Ms);
+		TRACE_COUNTER_SET(ShooterLatencyInputToFirstForce, Ms);
+		break;
+	default:
+		break;
+	}
+
+#if CSV_PROFILER
+	FCsvProfiler::RecordCustomStat(LatencyCsvStatNames[int32(Latency)], CSV_CATEGORY_INDEX(ShooterLatency), Ms, ECsvCustomStatOp::Set);
+#endif
+}
+
+void UShooterLatencySubsystem::PruneStale(uint64 NowCycles)
+{
+	const uint64 MaxPendingCycles = uint64(KMaxPendingSeconds / FPlatformTime::GetSecondsPerCycle64());
+
+	for (auto It = PendingInputs.CreateIterator(); It; ++It)
+	{
+		if (NowCycles - It.Value().InputCycles > MaxPendingCycles)
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	for (auto It = Shots.CreateIterator(); It; ++It)
+	{
+		if (NowCycles - It.Value().SpawnCycles > MaxPendingCycles)
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "ShooterLatencySubsystem.generated.h"
+
+class AShooterWeapon;
+
+/** Latencies measured between the markers of a shot */
+enum class EShooterLatency : uint8
+{
+	/** Fire input to the weapon firing. Includes refire waits */
+	InputToFire,
+
+	/** Fire input to the projectile spawning. Includes deferred aim traces */
+	InputToSpawn,
+
+	/** Activation input to the gravity well projectile activating */
+	InputToActivate,
+
+	/** Projectile activation to the first gravity step of its well */
+	ActivateToFirstStep,
+
+	/** Projectile activation to the first force its well applies */
+	ActivateToFirstForce,
+
+	/** Activation input to the first force the well applies */
+	InputToFirstForce,
+
+	Num
+};
+
+/** Fixed bucket latency histogram */
+struct FShooterLatencyHistogram
+{
+	/** Upper edges of the buckets in ms. The last bucket catches everything above */
+	static constexpr float BucketEdgesMs[] = { 1.0f, 2.0f, 4.0f, 8.0f, 12.0f, 16.7f, 25.0f, 33.3f, 50.0f, 66.7f, 100.0f, 250.0f };
+	static constexpr int32 NumBuckets = UE_ARRAY_COUNT(BucketEdgesMs) + 1;
+
+	int32 Buckets[NumBuckets] = {};
+	int32 Count = 0;
+	double SumMs = 0.0;
+	float MinMs = 0.0f;
+	float MaxMs = 0.0f;
+
+	void Add(float Ms);
+
+	/** Returns the upper edge of the bucket holding the given percentile, clamped to the largest sample */
+	float GetPercentileMs(float Percentile) const;
+};
+
+/**
+ *  Measures input to effect latency of weapons and gravity well activation
+ *  Weapons, projectiles and wells drop timestamped markers as a shot goes from input to fire, projectile spawn,
+ *  activation and the first applied gravity force. The latencies between them are aggregated into histograms per weapon class,
+ *  reported to stat ShooterLatency, Insights counters and the ShooterLatency CSV category, and dumped with Shooter.Latency.Dump
+ */
+UCLASS()
+class GRAVITY_TEST_API UShooterLatencySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** Markers of a weapon waiting for its input to turn into a shot or an activation */
+	struct FPendingInput
+	{
+		uint64 InputCycles = 0;
+		uint64 FireCycles = 0;
+	};
+
+	/** Markers of a fired projectile waiting for its activation and first gravity force */
+	struct FShotTimeline
+	{
+		FName WeaponType;
+		uint64 SpawnCycles = 0;
+		uint64 ActivateInputCycles = 0;
+		uint64 ActivateCycles = 0;
+		bool bFirstStepRecorded = false;
+	};
+
+	/** Latency histograms of a weapon class */
+	struct FWeaponLatencies
+	{
+		FShooterLatencyHistogram Histograms[int32(EShooterLatency::Num)];
+	};
+
+	TMap<TObjectKey<AShooterWeapon>, FPendingInput> PendingInputs;
+
+	/** Shots keyed by projectile */
+	TMap<TObjectKey<AActor>, FShotTimeline> Shots;
+
+	/** Histograms keyed by weapon class name */
+	TMap<FName, FWeaponLatencies> Latencies;
+
+public:
+
+	/** Marks the fire input being received for a weapon */
+	void MarkInput(const AShooterWeapon* Weapon);
+
+	/** Marks the weapon actually firing */
+	void MarkFire(const AShooterWeapon* Weapon);
+
+	/** Marks a projectile spawned by the weapon and starts tracking it */
+	void MarkProjectileSpawn(const AShooterWeapon* Weapon, const AActor* Projectile);
+
+	/** Hands the weapon's pending input over to the projectile it activates */
+	void MarkActivationInput(const AShooterWeapon* Weapon, const AActor* Projectile);
+
+	/** Marks a gravity well projectile activating */
+	void MarkActivate(const AActor* Projectile);
+
+	/**
+	 *  Marks a gravity step of the well spawned by a projectile
+	 *  Returns true while the shot still waits for its first force, so wells can stop reporting once it's recorded
+	 */
+	bool MarkWellStep(const AActor* Projectile, bool bAppliedForce);
+
+	/** Writes every histogram to a CSV file. Returns false if the file can't be written */
+	bool WriteCsv(const FString& FilePath) const;
+
+	/** Drops every histogram and in flight shot */
+	void Reset();
+
+protected:
+
+	//~Begin UWorldSubsystem interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~End UWorldSubsystem interface
+
+	/** Adds a latency sample to the weapon's histogram and reports it to stats, Insights and CSV */
+	void RecordLatency(FName WeaponType, EShooterLatency Latency, uint64 StartCycles, uint64 EndCycles);
+
+	/** Drops shots and inputs that never completed */
+	void PruneStale(uint64 NowCycles);
+};
@@ -9,10 +9,15 @@
 #include "ShooterWeapon.h"
 #include "Engine/World.h"
 #include "TimerManager.h"
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
+#include "GameFramework/Pawn.h"
+#include "ShooterWeaponPoolSubsystem.h"
 
 AShooterPickup::AShooterPickup()
 {
- 	PrimaryActorTick.bCanEverTick = true;
+	// pickups have no per-frame work, so they never tick
+	PrimaryActorTick.bCanEverTick = false;
 
 	// create the root
 	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
@@ -36,6 +41,20 @@ AShooterPickup::AShooterPickup()
 	Mesh->SetupAttachment(SphereCollision);
 
 	Mesh->SetCollisionProfileName(FName("NoCollision"));
+
+	// create the prefetch sphere
+	PrefetchSphere = CreateDefaultSubobject<USphereComponent>(TEXT("Prefetch Sphere"));
+	PrefetchSphere->SetupAttachment(RootComponent);
+
+	PrefetchSphere->SetSphereRadius(PrefetchRadius);
+	PrefetchSphere->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+	PrefetchSphere->SetCollisionObjectType(ECC_WorldStatic);
+	PrefetchSphere->SetCollisionResponseToAllChannels(ECR_Ignore);
+	PrefetchSphere->SetCollisionResponseToChannel(ECC_Pawn, ECR_Overlap);
+	PrefetchSphere->SetCanEverAffectNavigation(false);
+
+	// subscribe to the prefetch overlap
+	PrefetchSphere->OnComponentBeginOverlap.AddDynamic(this, &AShooterPickup::OnPrefetchOverlap);
 }
 
 void AShooterPickup::OnConstruction(const FTransform& Transform)
@@ -44,9 +63,19 @@ void AShooterPickup::OnConstruction(const FTransform& Transform)
 
 	if (FWeaponTableRow* WeaponData = WeaponType.GetRow<FWeaponTableRow>(FString()))
 	{
-		// set the mesh
-		Mesh->SetStaticMesh(WeaponData->StaticMesh.LoadSynchronous());
+		// set the mesh if it's already in memory. Game worlds stream it in from BeginPlay so spawning a pickup never blocks on a load,
+		// the editor loads it right away so the pickup shows up while it's being placed
+		if (UStaticMesh* LoadedMesh = WeaponData->StaticMesh.Get())
+		{
+			Mesh->SetStaticMesh(LoadedMesh);
+
+		} else if (!GetWorld() || !GetWorld()->IsGameWorld()) {
+
+			Mesh->SetStaticMesh(WeaponData->StaticMesh.LoadSynchronous());
+		}
 	}
+
+	PrefetchSphere->SetSphereRadius(PrefetchRadius);
 }
 
 void AShooterPickup::BeginPlay()
@@ -57,6 +86,19 @@ void AShooterPickup::BeginPlay()
 	{
 		// copy the weapon class
 		WeaponClass = WeaponData->WeaponToSpawn;
+
+		// stream in the mesh if the construction script couldn't set it
+		if (!Mesh->GetStaticMesh() && !WeaponData->StaticMesh.IsNull())
+		{
+			const TSoftObjectPtr<UStaticMesh> MeshAsset = WeaponData->StaticMesh;
+
+			MeshLoadHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(MeshAsset.ToSoftObjectPath(),
+				FStreamableDelegate::CreateWeakLambda(Mesh, [this, MeshAsset]()
+				{
+					Mesh->SetStaticMesh(MeshAsset.Get());
+					MeshLoadHandle.Reset();
+				}));
+		}
 	}
 }
 
@@ -71,19 +113,17 @@ void AShooterPickup::EndPlay(const EEndPlayReason::Type EndPlayReason)
 void AShooterPickup::OnOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
 {
 	// have we collided against a weapon holder?
-	if (IShooterWeaponHolder* WeaponHolder = Cast<IShooterWeaponHolder>(OtherActor))
+	if (Cast<IShooterWeaponHolder>(OtherActor))
 	{
-		WeaponHolder->AddWeaponClass(WeaponClass);
-
 		// hide this mesh
 		SetActorHiddenInGame(true);
 
+		// grant the weapon. The prefetch has normally loaded it by now
+		GrantWeaponWhenLoaded(OtherActor);
+
 		// disable collision
 		SetActorEnableCollision(false);
 
-		// disable ticking
-		SetActorTickEnabled(false);
-
 		// schedule the respawn
 		GetWorld()->GetTimerManager().SetTimer(RespawnTimer, this, &AShooterPickup::RespawnPickup, RespawnTime, false);
 	}
@@ -94,6 +134,9 @@ void AShooterPickup::RespawnPickup()
 	// unhide this pickup
 	SetActorHiddenInGame(false);
 
+	// have a weapon ready for the next player
+	PrewarmWeapon();
+
 	// call the BP handler
 	BP_OnRespawn();
 }
@@ -102,7 +145,76 @@ void AShooterPickup::FinishRespawn()
 {
 	// enable collision
 	SetActorEnableCollision(true);
+}
+
+void AShooterPickup::OnPrefetchOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+{
+	// only players approaching the pickup are worth a prefetch
+	const APawn* Pawn = Cast<APawn>(OtherActor);
+	if (Pawn && Pawn->IsPlayerControlled())
+	{
+		PrefetchWeapon();
+	}
+}
+
+void AShooterPickup::PrefetchWeapon()
+{
+	if (WeaponLoadHandle.IsValid() || WeaponClass.IsNull())
+	{
+		return;
+	}
+
+	// loading the weapon class also loads its meshes, anim blueprints, montages and projectile through their hard references.
+	// Keep the handle so they stay resident until the pickup goes away
+	WeaponLoadHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(WeaponClass.ToSoftObjectPath(),
+		FStreamableDelegate::CreateUObject(this, &AShooterPickup::OnWeaponLoaded), FStreamableManager::AsyncLoadHighPriority);
+}
 
-	// enable tick
-	SetActorTickEnabled(true);
+void AShooterPickup::OnWeaponLoaded()
+{
+	// spawn a weapon into the pool ahead of the pickup
+	PrewarmWeapon();
+
+	// then hand it to the holder that outran the prefetch, if any
+	if (AActor* WeaponHolder = PendingWeaponHolder.Get())
+	{
+		PendingWeaponHolder.Reset();
+		GrantWeapon(WeaponHolder);
+	}
+}
+
+void AShooterPickup::PrewarmWeapon()
+{
+	UClass* LoadedClass = WeaponClass.Get();
+	UShooterWeaponPoolSubsystem* WeaponPool = GetWorld()->GetSubsystem<UShooterWeaponPoolSubsystem>();
+
+	if (LoadedClass && WeaponPool)
+	{
+		WeaponPool->PrewarmWeapons(LoadedClass, 1);
+	}
+}
+
+void AShooterPickup::GrantWeaponWhenLoaded(AActor* WeaponHolder)
+{
+	PrefetchWeapon();
+
+	// the player outran the prefetch. Grant the weapon once it finishes streaming in instead of blocking on it
+	if (WeaponLoadHandle.IsValid() && WeaponLoadHandle->IsLoadingInProgress())
+	{
+		PendingWeaponHolder = WeaponHolder;
+		return;
+	}
+
+	GrantWeapon(WeaponHolder);
+}
+
+void AShooterPickup::GrantWeapon(AActor* WeaponHolder)
+{
+	IShooterWeaponHolder* Holder = Cast<IShooterWeaponHolder>(WeaponHolder);
+	UClass* LoadedClass = WeaponClass.Get();
+
+	if (Holder && LoadedClass)
+	{
+		Holder->AddWeaponClass(LoadedClass);
+	}
 }
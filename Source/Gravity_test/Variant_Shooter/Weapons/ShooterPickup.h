@@ -11,6 +11,7 @@
 class USphereComponent;
 class UPrimitiveComponent;
 class AShooterWeapon;
+struct FStreamableHandle;
 
 /**
  *  Holds information about a type of weapon pickup
@@ -24,9 +25,9 @@ struct FWeaponTableRow : public FTableRowBase
 	UPROPERTY(EditAnywhere)
 	TSoftObjectPtr<UStaticMesh> StaticMesh;
 
-	/** Weapon class to grant on pickup */
+	/** Weapon class to grant on pickup. Streamed in, together with its meshes, anim blueprints and montages, when a player gets close to the pickup */
 	UPROPERTY(EditAnywhere)
-	TSubclassOf<AShooterWeapon> WeaponToSpawn;
+	TSoftClassPtr<AShooterWeapon> WeaponToSpawn;
 };
 
 /**
@@ -44,6 +45,10 @@ class GRAVITY_TEST_API AShooterPickup : public AActor
 	/** Weapon pickup mesh. Its mesh asset is set from the weapon data table */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Components", meta = (AllowPrivateAccess = "true"))
 	UStaticMeshComponent* Mesh;
+
+	/** Starts streaming in the weapon when a player gets within range */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Components", meta = (AllowPrivateAccess = "true"))
+	USphereComponent* PrefetchSphere;
 	
 protected:
 
@@ -52,7 +57,20 @@ protected:
 	FDataTableRowHandle WeaponType;
 
 	/** Type to weapon to grant on pickup. Set from the weapon data table. */
-	TSubclassOf<AShooterWeapon> WeaponClass;
+	TSoftClassPtr<AShooterWeapon> WeaponClass;
+
+	/** Distance from the pickup at which players start prefetching the weapon */
+	UPROPERTY(EditAnywhere, Category="Pickup", meta = (ClampMin = 0, ClampMax = 10000, Units = "cm"))
+	float PrefetchRadius = 2000.0f;
+
+	/** Keeps the weapon class and its assets loaded once prefetched */
+	TSharedPtr<FStreamableHandle> WeaponLoadHandle;
+
+	/** Keeps the pickup mesh loaded while it streams in */
+	TSharedPtr<FStreamableHandle> MeshLoadHandle;
+
+	/** Weapon holder that picked this up before the weapon finished loading */
+	TWeakObjectPtr<AActor> PendingWeaponHolder;
 	
 	/** Time to wait before respawning this pickup */
 	UPROPERTY(EditAnywhere, Category="Pickup", meta = (ClampMin = 0, ClampMax = 120, Units = "s"))
@@ -81,6 +99,10 @@ protected:
 	UFUNCTION()
 	virtual void OnOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
 
+	/** Handles players entering the prefetch range */
+	UFUNCTION()
+	void OnPrefetchOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
+
 protected:
 
 	/** Called when it's time to respawn this pickup */
@@ -93,4 +115,19 @@ protected:
 	/** Enables this pickup after respawning */
 	UFUNCTION(BlueprintCallable, Category="Pickup")
 	void FinishRespawn();
+
+	/** Starts streaming in the weapon class and everything it references, if it isn't loading already */
+	void PrefetchWeapon();
+
+	/** Grants the weapon to the holder once it has finished loading */
+	void GrantWeaponWhenLoaded(AActor* WeaponHolder);
+
+	/** Gives the loaded weapon class to the holder */
+	void GrantWeapon(AActor* WeaponHolder);
+
+	/** Called when the weapon class finishes streaming in. Prewarms the pool, then grants the weapon if a holder is waiting for it */
+	void OnWeaponLoaded();
+
+	/** Makes sure the weapon pool has a weapon of this pickup's class ready, once the class is loaded */
+	void PrewarmWeapon();
 };
@@ -12,10 +12,13 @@
 #include "Engine/OverlapResult.h"
 #include "Engine/World.h"
 #include "TimerManager.h"
+#include "ShooterBatchTickSubsystem.h"
+#include "FrameScratch.h"
 
 AShooterProjectile::AShooterProjectile()
 {
-	PrimaryActorTick.bCanEverTick = true;
+	// projectiles don't tick. Their lifetime is handled by the batch tick subsystem
+	PrimaryActorTick.bCanEverTick = false;
 
 	// create the collision component and assign it as the root
 	RootComponent = CollisionComponent = CreateDefaultSubobject<USphereComponent>(TEXT("Collision Component"));
@@ -42,6 +45,12 @@ void AShooterProjectile::BeginPlay()
 	
 	// ignore the pawn that shot this projectile
 	CollisionComponent->IgnoreActorWhenMoving(GetInstigator(), true);
+
+	// expire the projectile if it flies for too long without hitting anything
+	if (UShooterBatchTickSubsystem* BatchTick = GetWorld()->GetSubsystem<UShooterBatchTickSubsystem>())
+	{
+		BatchTick->RegisterProjectile(this, MaxLifetime);
+	}
 }
 
 void AShooterProjectile::EndPlay(EEndPlayReason::Type EndPlayReason)
@@ -50,6 +59,21 @@ void AShooterProjectile::EndPlay(EEndPlayReason::Type EndPlayReason)
 
 	// clear the destruction timer
 	GetWorld()->GetTimerManager().ClearTimer(DestructionTimer);
+
+	// stop tracking the lifetime
+	if (UShooterBatchTickSubsystem* BatchTick = GetWorld()->GetSubsystem<UShooterBatchTickSubsystem>())
+	{
+		BatchTick->UnregisterProjectile(this);
+	}
+}
+
+void AShooterProjectile::OnLifetimeExpired()
+{
+	// projectiles that already hit are handled by deferred destruction
+	if (!bHit)
+	{
+		Destroy();
+	}
 }
 
 void AShooterProjectile::NotifyHit(class UPrimitiveComponent* MyComp, AActor* Other, class UPrimitiveComponent* OtherComp, bool bSelfMoved, FVector HitLocation, FVector HitNormal, FVector NormalImpulse, const FHitResult& Hit)
@@ -62,6 +86,12 @@ void AShooterProjectile::NotifyHit(class UPrimitiveComponent* MyComp, AActor* Ot
 
 	bHit = true;
 
+	// the hit takes over from the lifetime
+	if (UShooterBatchTickSubsystem* BatchTick = GetWorld()->GetSubsystem<UShooterBatchTickSubsystem>())
+	{
+		BatchTick->UnregisterProjectile(this);
+	}
+
 	// disable collision on the projectile
 	CollisionComponent->SetCollisionEnabled(ECollisionEnabled::NoCollision);
 
@@ -98,8 +128,12 @@ void AShooterProjectile::NotifyHit(class UPrimitiveComponent* MyComp, AActor* Ot
 
 void AShooterProjectile::ExplosionCheck(const FVector& ExplosionCenter)
 {
+	// explosion temporaries come from the frame scratch stack and a pooled overlap buffer, so they don't hit the heap
+	FFrameScratchScope ScratchScope;
+
 	// do a sphere overlap check look for nearby actors to damage
-	TArray<FOverlapResult> Overlaps;
+	FScopedOverlapBuffer OverlapBuffer;
+	TArray<FOverlapResult>& Overlaps = OverlapBuffer.Get();
 
 	FCollisionShape OverlapShape;
 	OverlapShape.SetSphere(ExplosionRadius);
@@ -109,8 +143,8 @@ void AShooterProjectile::ExplosionCheck(const FVector& ExplosionCenter)
 	ObjectParams.AddObjectTypesToQuery(ECC_WorldDynamic);
 	ObjectParams.AddObjectTypesToQuery(ECC_PhysicsBody);
 
-	FCollisionQueryParams QueryParams;
-	QueryParams.AddIgnoredActor(this);
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ShooterExplosion), false, this);
+	QueryParams.bReturnPhysicalMaterial = false;
 	if (!bDamageOwner)
 	{
 		QueryParams.AddIgnoredActor(GetInstigator());
@@ -118,7 +152,8 @@ void AShooterProjectile::ExplosionCheck(const FVector& ExplosionCenter)
 
 	GetWorld()->OverlapMultiByObjectType(Overlaps, ExplosionCenter, FQuat::Identity, ObjectParams, OverlapShape, QueryParams);
 
-	TArray<AActor*> DamagedActors;
+	TFrameScratchArray<AActor*> DamagedActors;
+	DamagedActors.Reserve(Overlaps.Num());
 
 	// process the overlap results
 	for (const FOverlapResult& CurrentOverlap : Overlaps)
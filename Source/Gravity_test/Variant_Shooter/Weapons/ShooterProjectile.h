@@ -75,11 +75,18 @@ protected:
 	/** Timer to handle deferred destruction of this projectile */
 	FTimerHandle DestructionTimer;
 
+	/** How long the projectile can fly without hitting anything before it's destroyed. Zero, the default, lets it fly until it hits */
+	UPROPERTY(EditAnywhere, Category="Projectile|Destruction", meta = (ClampMin = 0, ClampMax = 60, Units = "s"))
+	float MaxLifetime = 0.0f;
+
 public:	
 
 	/** Constructor */
 	AShooterProjectile();
 
+	/** Called by the batch tick subsystem once MaxLifetime runs out. Destroys the projectile unless it has already hit something */
+	virtual void OnLifetimeExpired();
+
 protected:
 	
 	/** Gameplay initialization */
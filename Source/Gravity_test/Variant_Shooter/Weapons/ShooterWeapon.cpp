@@ -11,10 +11,16 @@
 #include "Animation/AnimInstance.h"
 #include "Components/SkeletalMeshComponent.h"
 #include "GameFramework/Pawn.h"
+#include "ShooterAimTraceSubsystem.h"
+#include "ShooterWeaponPoolSubsystem.h"
+#include "Gravity_test.h"
+#include "GravityFlightRecorder.h"
+#include "ShooterLatencySubsystem.h"
+#include "ShooterRandomSubsystem.h"
 
 AShooterWeapon::AShooterWeapon()
 {
-	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bCanEverTick = false;
 
 	// create the root
 	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
@@ -40,18 +46,11 @@ void AShooterWeapon::BeginPlay()
 {
 	Super::BeginPlay();
 
-	// subscribe to the owner's destroyed delegate
-	GetOwner()->OnDestroyed.AddDynamic(this, &AShooterWeapon::OnOwnerDestroyed);
-
-	// cast the weapon owner
-	WeaponOwner = Cast<IShooterWeaponHolder>(GetOwner());
-	PawnOwner = Cast<APawn>(GetOwner());
-
-	// fill the first ammo clip
-	CurrentBullets = MagazineSize;
-
-	// attach the meshes to the owner
-	WeaponOwner->AttachWeaponMeshes(this);
+	// pooled weapons are spawned without an owner and initialized when handed out
+	if (GetOwner())
+	{
+		InitializeForOwner(GetOwner());
+	}
 }
 
 void AShooterWeapon::EndPlay(EEndPlayReason::Type EndPlayReason)
@@ -64,10 +63,86 @@ void AShooterWeapon::EndPlay(EEndPlayReason::Type EndPlayReason)
 
 void AShooterWeapon::OnOwnerDestroyed(AActor* DestroyedActor)
 {
+	// return pooled weapons to the pool
+	if (bPooled)
+	{
+		if (UShooterWeaponPoolSubsystem* WeaponPool = GetWorld()->GetSubsystem<UShooterWeaponPoolSubsystem>())
+		{
+			if (WeaponPool->ReleaseWeapon(this))
+			{
+				return;
+			}
+		}
+	}
+
 	// ensure this weapon is destroyed when the owner is destroyed
 	Destroy();
 }
 
+void AShooterWeapon::InitializeForOwner(AActor* NewOwner)
+{
+	// shots fired for the previous owner are not this owner's
+	CancelPendingShots();
+	bIsDormant = false;
+
+	// stop listening to the previous owner
+	if (GetOwner() && GetOwner() != NewOwner)
+	{
+		GetOwner()->OnDestroyed.RemoveDynamic(this, &AShooterWeapon::OnOwnerDestroyed);
+	}
+
+	SetOwner(NewOwner);
+	SetInstigator(Cast<APawn>(NewOwner));
+
+	// subscribe to the owner's destroyed delegate
+	NewOwner->OnDestroyed.AddUniqueDynamic(this, &AShooterWeapon::OnOwnerDestroyed);
+
+	// cast the weapon owner
+	WeaponOwner = Cast<IShooterWeaponHolder>(NewOwner);
+	PawnOwner = Cast<APawn>(NewOwner);
+
+	// fill the first ammo clip
+	CurrentBullets = MagazineSize;
+
+	// owners that don't need animated weapon meshes turn it back off when attaching
+	SetMeshAnimationEnabled(true);
+
+	// attach the meshes to the owner
+	WeaponOwner->AttachWeaponMeshes(this);
+}
+
+void AShooterWeapon::EnterPoolDormancy()
+{
+	bIsDormant = true;
+
+	// ensure we're no longer firing this weapon
+	StopFiring();
+	CancelPendingShots();
+	LastFiredProjectile.Reset();
+
+	// stop listening to the owner
+	if (GetOwner())
+	{
+		GetOwner()->OnDestroyed.RemoveDynamic(this, &AShooterWeapon::OnOwnerDestroyed);
+	}
+
+	// bring the meshes back from the owner's sockets
+	const FAttachmentTransformRules AttachmentRule(EAttachmentRule::SnapToTarget, false);
+
+	DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
+	FirstPersonMesh->AttachToComponent(RootComponent, AttachmentRule);
+	ThirdPersonMesh->AttachToComponent(RootComponent, AttachmentRule);
+
+	SetOwner(nullptr);
+	SetInstigator(nullptr);
+	WeaponOwner = nullptr;
+	PawnOwner = nullptr;
+
+	// hide the weapon and stop animating it
+	SetActorHiddenInGame(true);
+	SetMeshAnimationEnabled(false);
+}
+
 void AShooterWeapon::ActivateWeapon()
 {
 	// unhide this weapon
@@ -81,6 +156,7 @@ void AShooterWeapon::DeactivateWeapon()
 {
 	// ensure we're no longer firing this weapon while deactivated
 	StopFiring();
+	CancelPendingShots();
 
 	// hide the weapon
 	SetActorHiddenInGame(true);
@@ -130,9 +206,38 @@ void AShooterWeapon::Fire()
 	{
 		return;
 	}
+
+	if (UShooterLatencySubsystem* Latency = GetWorld()->GetSubsystem<UShooterLatencySubsystem>())
+	{
+		Latency->MarkFire(this);
+	}
 	
-	// fire a projectile at the target
-	FireProjectile(WeaponOwner->GetWeaponTargetLocation());
+	// resolve the aim target. Shots from anyone but the local player go through the batched aim trace queue
+	// and spawn their projectile once the trace completes on the next frame
+	FVector AimStart, AimEnd;
+	UShooterAimTraceSubsystem* AimTraces = GetWorld()->GetSubsystem<UShooterAimTraceSubsystem>();
+
+	if (AimTraces && UShooterAimTraceSubsystem::IsAsyncAimEnabled() && WeaponOwner->GetDeferredAimTrace(AimStart, AimEnd))
+	{
+		AimTraces->RequestAimTrace(AimStart, AimEnd, GetOwner(), FShooterAimTraceResolvedDelegate::CreateUObject(this, &AShooterWeapon::OnAimTraceResolved, ShotSerial));
+
+	} else {
+
+		// fire a projectile at the target
+		FireProjectile(WeaponOwner->GetWeaponTargetLocation());
+	}
+
+	// consume bullets. Deferred shots count as fired now, like the rest of the shot bookkeeping
+	--CurrentBullets;
+
+	// if the clip is depleted, reload it
+	if (CurrentBullets <= 0)
+	{
+		CurrentBullets = MagazineSize;
+	}
+
+	// update the weapon HUD
+	WeaponOwner->UpdateWeaponHUD(CurrentBullets, MagazineSize);
 
 	// update the time of our last shot
 	TimeOfLastShot = GetWorld()->GetTimeSeconds();
@@ -153,6 +258,18 @@ void AShooterWeapon::Fire()
 	}
 }
 
+void AShooterWeapon::OnAimTraceResolved(const FVector& TargetLocation, uint32 IssuedShotSerial)
+{
+	// the owner may have died, or the weapon been put away or handed to someone else, while the trace was in flight
+	if (IssuedShotSerial != ShotSerial || !IsValid(GetOwner()))
+	{
+		return;
+	}
+
+	// fire a projectile at the resolved target
+	FireProjectile(TargetLocation);
+}
+
 void AShooterWeapon::FireCooldownExpired()
 {
 	// notify the owner
@@ -171,43 +288,55 @@ void AShooterWeapon::FireProjectile(const FVector& TargetLocation)
 	SpawnParams.Owner = GetOwner();
 	SpawnParams.Instigator = PawnOwner;
 
-	AShooterProjectile* Projectile = GetWorld()->SpawnActor<AShooterProjectile>(ProjectileClass, ProjectileTransform, SpawnParams);
-	LastFiredProjectile = Projectile;
+	{
+		LLM_SCOPE_BYTAG(Shooter_Projectiles);
+		LastFiredProjectile = GetWorld()->SpawnActor<AShooterProjectile>(ProjectileClass, ProjectileTransform, SpawnParams);
+	}
+
+	GravityFlightRecorder::Record(GravityFlightRecorder::EEvent::ProjectileFire, LastFiredProjectile.Get(), PawnOwner, ProjectileTransform.GetLocation());
+
+	if (UShooterLatencySubsystem* Latency = GetWorld()->GetSubsystem<UShooterLatencySubsystem>())
+	{
+		Latency->MarkProjectileSpawn(this, LastFiredProjectile.Get());
+	}
 
 	// play the firing montage
 	WeaponOwner->PlayFiringMontage(FiringMontage);
 
 	// add recoil
 	WeaponOwner->AddWeaponRecoil(FiringRecoil);
-
-	// consume bullets
-	--CurrentBullets;
-
-	// if the clip is depleted, reload it
-	if (CurrentBullets <= 0)
-	{
-		CurrentBullets = MagazineSize;
-	}
-
-	// update the weapon HUD
-	WeaponOwner->UpdateWeaponHUD(CurrentBullets, MagazineSize);
 }
 
 FTransform AShooterWeapon::CalculateProjectileSpawnTransform(const FVector& TargetLocation) const
 {
-	// find the muzzle location
-	const FVector MuzzleLoc = FirstPersonMesh->GetSocketLocation(MuzzleSocketName);
+	// find the muzzle location. Use the third person mesh if the first person one isn't animated
+	const USkeletalMeshComponent* MuzzleMesh = (bMeshAnimationEnabled || !ThirdPersonMesh->DoesSocketExist(MuzzleSocketName)) ? FirstPersonMesh : ThirdPersonMesh;
+	const FVector MuzzleLoc = MuzzleMesh->GetSocketLocation(MuzzleSocketName);
 
 	// calculate the spawn location ahead of the muzzle
 	const FVector SpawnLoc = MuzzleLoc + ((TargetLocation - MuzzleLoc).GetSafeNormal() * MuzzleOffset);
 
-	// find the aim rotation vector while applying some variance to the target 
-	const FRotator AimRot = UKismetMathLibrary::FindLookAtRotation(SpawnLoc, TargetLocation + (UKismetMathLibrary::RandomUnitVector() * AimVariance));
+	// find the aim rotation vector while applying some variance to the target.
+	// The variance comes from the weapon's own stream so the same seed reproduces the same spread
+	const FVector Variance = UShooterRandomSubsystem::GetStream(this).VRand() * AimVariance;
+	const FRotator AimRot = UKismetMathLibrary::FindLookAtRotation(SpawnLoc, TargetLocation + Variance);
 
 	// return the built transform
 	return FTransform(AimRot, SpawnLoc, FVector::OneVector);
 }
 
+void AShooterWeapon::SetMeshAnimationEnabled(bool bEnabled)
+{
+	bMeshAnimationEnabled = bEnabled;
+
+	// the meshes keep following their attach sockets without ticking
+	FirstPersonMesh->SetComponentTickEnabled(bEnabled);
+	ThirdPersonMesh->SetComponentTickEnabled(bEnabled);
+
+	// the first person mesh is only useful to a first person viewer
+	FirstPersonMesh->SetHiddenInGame(!bEnabled);
+}
+
 const TSubclassOf<UAnimInstance>& AShooterWeapon::GetFirstPersonAnimInstanceClass() const
 {
 	return FirstPersonAnimInstanceClass;
@@ -61,6 +61,14 @@ protected:
 	UPROPERTY(EditAnywhere, Category="Animation")
 	TSubclassOf<UAnimInstance> ThirdPersonAnimInstanceClass;
 
+	/** Anim layers to link into the first person character mesh when this weapon is active. Takes precedence over the AnimInstance class, so switching weapons keeps the character's anim instance alive */
+	UPROPERTY(EditAnywhere, Category="Animation")
+	TSubclassOf<UAnimInstance> FirstPersonAnimLayersClass;
+
+	/** Anim layers to link into the third person character mesh when this weapon is active. Takes precedence over the AnimInstance class, so switching weapons keeps the character's anim instance alive */
+	UPROPERTY(EditAnywhere, Category="Animation")
+	TSubclassOf<UAnimInstance> ThirdPersonAnimLayersClass;
+
 	/** Cone half-angle for variance while aiming */
 	UPROPERTY(EditAnywhere, Category="Aim", meta = (ClampMin = 0, ClampMax = 90, Units = "Degrees"))
 	float AimVariance = 0.0f;
@@ -112,6 +120,18 @@ protected:
 	/** Weak pointer to the last projectile spawned by this weapon */
 	TWeakObjectPtr<AShooterProjectile> LastFiredProjectile;
 
+	/** If false, the meshes don't evaluate animation, the first person mesh is hidden and projectiles spawn from the third person muzzle */
+	bool bMeshAnimationEnabled = true;
+
+	/** If true, this weapon is owned by the weapon pool and goes dormant instead of being destroyed with its owner */
+	bool bPooled = false;
+
+	/** If true, this weapon is parked in the weapon pool waiting to be handed out */
+	bool bIsDormant = false;
+
+	/** Bumped by CancelPendingShots. Deferred shots issued under an older serial are dropped when their aim trace resolves */
+	uint32 ShotSerial = 0;
+
 public:	
 
 	/** Constructor */
@@ -145,11 +165,38 @@ public:
 	/** Stop firing this weapon */
 	virtual void StopFiring();
 
+	/** Fills the current magazine */
+	void RefillAmmo() { CurrentBullets = MagazineSize; }
+
+	/** Hands this weapon to a new owner and attaches it. Called from BeginPlay for weapons spawned with an owner, and by the pool when reusing a weapon */
+	void InitializeForOwner(AActor* NewOwner);
+
+	/** Detaches this weapon from its owner and parks it hidden until the pool hands it out again */
+	void EnterPoolDormancy();
+
+	/** Drops every shot still waiting on its deferred aim trace. Called when the weapon changes hands, is put away or its owner dies */
+	void CancelPendingShots() { ++ShotSerial; }
+
+	/** Flags this weapon as owned by the weapon pool */
+	void SetPooled(bool bInPooled) { bPooled = bInPooled; }
+
+	/** Returns true if this weapon is owned by the weapon pool */
+	bool IsPooled() const { return bPooled; }
+
+	/** Returns true if this weapon is parked in the weapon pool */
+	bool IsDormant() const { return bIsDormant; }
+
+	/** Enables or disables animation on the weapon meshes. Owners nobody sees in first person disable it so the meshes just follow their sockets */
+	void SetMeshAnimationEnabled(bool bEnabled);
+
 protected:
 
 	/** Fire the weapon */
 	virtual void Fire();
 
+	/** Called when a deferred aim trace for a shot has been resolved. Spawns the projectile unless the shot was cancelled since */
+	void OnAimTraceResolved(const FVector& TargetLocation, uint32 IssuedShotSerial);
+
 	/** Called when the refire rate time has passed while shooting semi auto weapons */
 	void FireCooldownExpired();
 
@@ -175,6 +222,12 @@ public:
 	/** Returns the third person anim instance class */
 	const TSubclassOf<UAnimInstance>& GetThirdPersonAnimInstanceClass() const;
 
+	/** Returns the first person anim layers class */
+	const TSubclassOf<UAnimInstance>& GetFirstPersonAnimLayersClass() const { return FirstPersonAnimLayersClass; }
+
+	/** Returns the third person anim layers class */
+	const TSubclassOf<UAnimInstance>& GetThirdPersonAnimLayersClass() const { return ThirdPersonAnimLayersClass; }
+
 	/** Returns the magazine size */
 	int32 GetMagazineSize() const { return MagazineSize; };
 
@@ -41,6 +41,9 @@ public:
 	/** Calculates and returns the aim location for the weapon */
 	virtual FVector GetWeaponTargetLocation() = 0;
 
+	/** Calculates the aim trace segment for the weapon. Returns false if the aim must be resolved synchronously through GetWeaponTargetLocation */
+	virtual bool GetDeferredAimTrace(FVector& OutStart, FVector& OutEnd) = 0;
+
 	/** Gives a weapon of this class to the owner */
 	virtual void AddWeaponClass(const TSubclassOf<AShooterWeapon>& WeaponClass) = 0;
 
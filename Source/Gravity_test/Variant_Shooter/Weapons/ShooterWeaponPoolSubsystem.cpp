@@ -0,0 +1,115 @@
+#include "ShooterWeaponPoolSubsystem.h"
+#include "ShooterWeapon.h"
+#include "Engine/World.h"
+#include "Algo/Count.h"
+#include "Gravity_test.h"
+
+AShooterWeapon* UShooterWeaponPoolSubsystem::AcquireWeapon(TSubclassOf<AShooterWeapon> WeaponClass, AActor* NewOwner)
+{
+	if (!WeaponClass || !NewOwner)
+	{
+		return nullptr;
+	}
+
+	// reuse a dormant weapon of the same class if we have one. Skip any that were destroyed behind our back
+	const int32 DormantIndex = DormantWeapons.IndexOfByPredicate([&WeaponClass](const AShooterWeapon* Weapon)
+	{
+		return IsValid(Weapon) && Weapon->GetClass() == WeaponClass;
+	});
+
+	AShooterWeapon* Weapon = nullptr;
+
+	if (DormantIndex != INDEX_NONE)
+	{
+		Weapon = DormantWeapons[DormantIndex];
+		DormantWeapons.RemoveAtSwap(DormantIndex, EAllowShrinking::No);
+
+	} else {
+
+		Weapon = SpawnPooledWeapon(WeaponClass);
+	}
+
+	if (Weapon)
+	{
+		Weapon->SetActorTransform(NewOwner->GetActorTransform());
+		Weapon->InitializeForOwner(NewOwner);
+	}
+
+	return Weapon;
+}
+
+void UShooterWeaponPoolSubsystem::PrewarmWeapons(TSubclassOf<AShooterWeapon> WeaponClass, int32 Count)
+{
+	if (!WeaponClass)
+	{
+		return;
+	}
+
+	const int32 NumToSpawn = Count - GetNumDormantWeapons(WeaponClass);
+	if (NumToSpawn <= 0)
+	{
+		return;
+	}
+
+	// reserve up front so releasing weapons later never grows the arrays
+	PooledWeapons.Reserve(PooledWeapons.Num() + NumToSpawn);
+	DormantWeapons.Reserve(PooledWeapons.Max());
+
+	for (int32 i = 0; i < NumToSpawn; ++i)
+	{
+		if (AShooterWeapon* Weapon = SpawnPooledWeapon(WeaponClass))
+		{
+			Weapon->EnterPoolDormancy();
+			DormantWeapons.Add(Weapon);
+		}
+	}
+}
+
+bool UShooterWeaponPoolSubsystem::ReleaseWeapon(AShooterWeapon* Weapon)
+{
+	// the pooled flag is only ever set by this pool, so there's no need to search PooledWeapons
+	if (!Weapon || !Weapon->IsPooled())
+	{
+		return false;
+	}
+
+	// a weapon that's already dormant is already in the dormant list
+	if (Weapon->IsDormant())
+	{
+		return true;
+	}
+
+	Weapon->EnterPoolDormancy();
+	DormantWeapons.Add(Weapon);
+
+	return true;
+}
+
+int32 UShooterWeaponPoolSubsystem::GetNumDormantWeapons(TSubclassOf<AShooterWeapon> WeaponClass) const
+{
+	return Algo::CountIf(DormantWeapons, [&WeaponClass](const AShooterWeapon* Weapon) { return IsValid(Weapon) && Weapon->GetClass() == WeaponClass; });
+}
+
+bool UShooterWeaponPoolSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+AShooterWeapon* UShooterWeaponPoolSubsystem::SpawnPooledWeapon(TSubclassOf<AShooterWeapon> WeaponClass)
+{
+	LLM_SCOPE_BYTAG(Shooter_Weapons);
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	AShooterWeapon* Weapon = GetWorld()->SpawnActor<AShooterWeapon>(WeaponClass, FTransform::Identity, SpawnParams);
+
+	if (Weapon)
+	{
+		Weapon->SetPooled(true);
+		PooledWeapons.Add(Weapon);
+		DormantWeapons.Reserve(PooledWeapons.Num());
+	}
+
+	return Weapon;
+}
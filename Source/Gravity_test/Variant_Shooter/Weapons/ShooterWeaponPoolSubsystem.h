@@ -0,0 +1,51 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShooterWeaponPoolSubsystem.generated.h"
+
+class AShooterWeapon;
+
+/**
+ *  Keeps pre-spawned weapon actors around so picking up a weapon doesn't spawn anything
+ *  Weapons whose owner is destroyed go dormant and are handed to the next owner that needs one of their class
+ */
+UCLASS()
+class GRAVITY_TEST_API UShooterWeaponPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** Every weapon owned by the pool, active or dormant. Keeps them referenced, membership is checked with the weapon's pooled flag */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<AShooterWeapon>> PooledWeapons;
+
+	/** Dormant weapons ready to be handed out */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<AShooterWeapon>> DormantWeapons;
+
+public:
+
+	/** Returns a dormant weapon of the given class initialized for the new owner, or spawns a new one if none are available */
+	UFUNCTION(BlueprintCallable, Category="Shooter|Pool")
+	AShooterWeapon* AcquireWeapon(TSubclassOf<AShooterWeapon> WeaponClass, AActor* NewOwner);
+
+	/** Spawns dormant weapons of the given class until at least Count are available */
+	UFUNCTION(BlueprintCallable, Category="Shooter|Pool")
+	void PrewarmWeapons(TSubclassOf<AShooterWeapon> WeaponClass, int32 Count);
+
+	/** Returns a weapon to the pool. Returns false if the weapon isn't owned by the pool and should be destroyed instead */
+	bool ReleaseWeapon(AShooterWeapon* Weapon);
+
+	/** Returns the number of dormant weapons of the given class */
+	UFUNCTION(BlueprintPure, Category="Shooter|Pool")
+	int32 GetNumDormantWeapons(TSubclassOf<AShooterWeapon> WeaponClass) const;
+
+protected:
+
+	//~Begin UWorldSubsystem interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~End UWorldSubsystem interface
+
+	/** Spawns a new pooled weapon with no owner */
+	AShooterWeapon* SpawnPooledWeapon(TSubclassOf<AShooterWeapon> WeaponClass);
+};